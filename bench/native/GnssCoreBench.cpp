@@ -0,0 +1,1096 @@
+/**
+ * Host-Native Benchmarks for lib/GnssCore
+ *
+ * Everything in lib/GnssCore is plain C++11 with no Arduino dependency, so
+ * the parser, formatter, encoder, ring and log code builds for the
+ * workstation as is. This program runs the hot paths thousands of times
+ * per second there, where perf, sanitizers and a debugger are at hand, and
+ * no flash cycle is needed per experiment.
+ *
+ * Benchmarks:
+ * - ring         ByteRing write + read in 100-byte chunks
+ * - framer       synthetic u-blox NMEA epochs through NmeaFramer
+ * - framer+UBX   NAV-PVT / MON-HW frames through the binary sink and UbxParser
+ * - fuzz         the NMEA stream with random bit flips, dropped and inserted
+ *                bytes, stray '$' / 0xB5 and random chunk sizes; every
+ *                sentence the framer accepts is re-checked against its
+ *                checksum and the counters against the input size
+ * - format       formatCoordinate / formatTime per call
+ * - fix record   GnssFix -> FixRecord packing; the round trip must keep the
+ *                date, time, six printed decimals, antenna and quality
+ * - filter       PositionFilterF / PositionFilterQ on a simulated 1 Hz drive
+ *                with 3 m noise and a 500 m glitch: smoothed and mid-epoch
+ *                predicted error against the raw fixes, float against
+ *                fixed point, then cost per update + predict
+ * - geofence     300 circles and polygons around one city: shape tests
+ *                against double-precision references, the inside set after
+ *                every update against a brute-force scan, then update()
+ *                cost along a random walk
+ * - uplink       UplinkScheduler on a simulated 2.5 h day (parked, city
+ *                drive, parked, walk) against a fixed point-every-5-s
+ *                schedule: airtime, points, error of the track the server
+ *                interpolates, the 1 % duty cycle over every hour window
+ * - power        PowerGovernor on the same day with two button presses:
+ *                receiver in backup only while parked, display off only
+ *                without activity, motion noticed within one backup period,
+ *                estimated current saved
+ * - track codec  64-point trackEncode + trackDecode round trip
+ * - track buffer TrackBuffer against a flat reference FIFO (order, drops),
+ *                then push with one 1 KB spill per 64 points plus batch reads
+ * - track log    TrackLog appends on a RAM flash image (programs + erases)
+ * - fix bus      FixBus publish with two latest() reader threads and two ring
+ *                subscriber threads; readers check for torn records, ring
+ *                subscribers for order and that drops match the counters
+ *
+ * Build and run (from the repository root):
+ *
+ *   g++ -std=c++11 -O2 -Ilib/GnssCore bench/native/GnssCoreBench.cpp lib/GnssCore/[A-Z]*.cpp -pthread -o gnsscore-bench
+ *   ./gnsscore-bench [seconds per benchmark, default 1] [random seed]
+ *
+ * or as a PlatformIO `native` environment (see README), which passes no
+ * -std: the sources must also build in GCC's gnu++17 default, where `unix`
+ * is a predefined macro. Add -fsanitize=address,undefined for the fuzz run,
+ * or profile with
+ * `perf record ./gnsscore-bench`. The exit code is 1 if a correctness check failed.
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ByteRing.h"
+#include "FixBus.h"
+#include "FixRecord.h"
+#include "Geofence.h"
+#include "GnssFormat.h"
+#include "NmeaFramer.h"
+#include "PositionFilter.h"
+#include "PowerGovernor.h"
+#include "TrackBuffer.h"
+#include "TrackCodec.h"
+#include "UplinkScheduler.h"
+#include "TrackLog.h"
+#include "Ubx.h"
+
+static const size_t kChunk = 100;   // GnssUart::Config::rxThreshold
+static double runSeconds = 1.0;
+static int failures = 0;
+static volatile uint32_t sink;
+
+static double now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// xorshift32, reproducible across platforms
+static uint32_t rng = 1;
+static uint32_t rnd() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("CHECK FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+// runs fn() until runSeconds elapsed; fn returns work units (bytes, calls)
+template <typename Fn>
+static void bench(const char* name, const char* unit, Fn fn) {
+  uint64_t units = 0;
+  uint32_t reps = 0;
+  double start = now(), elapsed;
+  do {
+    units += fn();
+    reps++;
+    elapsed = now() - start;
+  } while (elapsed < runSeconds);
+
+  double perSec = units / elapsed;
+  if (!strcmp(unit, "B")) {
+    printf("%-12s %10.1f MB/s   %8.2f ns/B    %8u reps\n", name, perSec / 1e6, 1e9 / perSec, reps);
+  } else {
+    printf("%-12s %10.2f M%s/s  %8.1f ns/%s  %8u reps\n", name, perSec / 1e6, unit, 1e9 / perSec, unit, reps);
+  }
+}
+
+// --- synthetic input ---
+
+static void putSentence(std::vector<uint8_t>& out, const char* body) {
+  uint8_t sum = 0;
+  for (const char* p = body; *p; p++) sum ^= (uint8_t)*p;
+  char line[128];
+  int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+  out.insert(out.end(), line, line + n);
+}
+
+// u-blox M10 default output: RMC VTG GGA 4xGSA 7xGSV GLL, a TXT every 10 s
+static std::vector<uint8_t> nmeaStream(int epochs, uint32_t& sentences) {
+  std::vector<uint8_t> out;
+  char b[120];
+  sentences = 0;
+  for (int e = 0; e < epochs; e++) {
+    int s = e % 60, m = e / 60 % 60, h = 10 + e / 3600 % 14;
+    double lat = 5231.20048 + e * 0.00246, lon = 1324.29724 + e * 0.00162;
+    snprintf(b, sizeof(b), "GNRMC,%02d%02d%02d.00,A,%.5f,N,%010.5f,E,9.760,26.70,141026,,,A,V", h, m, s, lat, lon);
+    putSentence(out, b);
+    putSentence(out, "GNVTG,26.70,T,,M,9.760,N,18.075,K,A");
+    snprintf(b, sizeof(b), "GNGGA,%02d%02d%02d.00,%.5f,N,%010.5f,E,1,12,0.78,41.3,M,44.6,M,,", h, m, s, lat, lon);
+    putSentence(out, b);
+    putSentence(out, "GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1");
+    putSentence(out, "GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2");
+    putSentence(out, "GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3");
+    putSentence(out, "GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4");
+    putSentence(out, "GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1");
+    putSentence(out, "GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1");
+    putSentence(out, "GPGSV,3,3,09,29,18,250,33,1");
+    putSentence(out, "GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1");
+    putSentence(out, "GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1");
+    putSentence(out, "GBGSV,1,1,02,07,44,230,35,10,33,140,31,1");
+    snprintf(b, sizeof(b), "GNGLL,%.5f,N,%010.5f,E,%02d%02d%02d.00,A,A", lat, lon, h, m, s);
+    putSentence(out, b);
+    sentences += 14;
+    if (e % 10 == 0) {
+      putSentence(out, "GPTXT,01,01,01,ANTENNA OK");
+      sentences++;
+    }
+  }
+  return out;
+}
+
+static std::vector<uint8_t> ubxStream(int epochs, uint32_t& frames) {
+  std::vector<uint8_t> out;
+  uint8_t frame[UBX_FRAME_OVERHEAD + sizeof(UbxNavPvt)];
+  frames = 0;
+  for (int e = 0; e < epochs; e++) {
+    UbxNavPvt pvt;
+    memset(&pvt, 0, sizeof(pvt));
+    pvt.iTOW = 381300000 + e * 1000;
+    pvt.year = 2026;
+    pvt.month = 10;
+    pvt.day = 14;
+    pvt.hour = 10 + e / 3600 % 14;
+    pvt.min = e / 60 % 60;
+    pvt.sec = e % 60;
+    pvt.valid = 0x37;
+    pvt.fixType = 3;
+    pvt.flags = 0x01;
+    pvt.numSV = 18;
+    pvt.lat = 525200080 + e * 410;
+    pvt.lon = 134049540 + e * 270;
+    size_t n = ubxBuild(frame, UBX_NAV, UBX_NAV_PVT, (const uint8_t*)&pvt, sizeof(pvt));
+    out.insert(out.end(), frame, frame + n);
+    frames++;
+    if (e % 5 == 0) {
+      uint8_t hw[60] = {};
+      hw[20] = 2;   // antenna OK
+      uint8_t f[UBX_FRAME_OVERHEAD + sizeof(hw)];
+      n = ubxBuild(f, UBX_MON, UBX_MON_HW, hw, sizeof(hw));
+      out.insert(out.end(), f, f + n);
+      frames++;
+    }
+  }
+  return out;
+}
+
+// --- framer harness ---
+
+static StaticByteRing<2048> ring;
+
+static void feedRing(NmeaFramer& framer, const std::vector<uint8_t>& data, bool randomChunks) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t n = randomChunks ? 1 + rnd() % 256 : kChunk;
+    if (n > data.size() - pos) n = data.size() - pos;
+    size_t w = ring.write(&data[pos], n);
+    pos += w;
+    framer.poll(ring);
+  }
+}
+
+// re-verifies every accepted frame (fuzz run)
+static uint32_t badAccepted = 0;
+static void verifySentence(const NmeaSentence& s, void*) {
+  uint8_t sum = 0;
+  for (size_t i = 0; i < s.payloadLength(); i++) sum ^= (uint8_t)s.payloadAt(i);
+  char hex[3];
+  snprintf(hex, sizeof(hex), "%02X", sum);
+  if (s.at(0) != '$' || s.at(s.starPos) != '*' || s.at(s.size() - 1) != '\n' ||
+      (s.at(s.starPos + 1) | 0x20) != (hex[0] | 0x20) || (s.at(s.starPos + 2) | 0x20) != (hex[1] | 0x20) ||
+      s.size() > NmeaFramer::kMaxSentence + 1) {
+    badAccepted++;
+  }
+  sink += s.id;
+}
+
+static UbxParser ubxParser;
+static uint32_t ubxFrames = 0;
+
+static void feedUbx(const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, void*) {
+  ubxParser.feed(p1, n1);
+  ubxParser.feed(p2, n2);
+}
+
+static void onUbxFrame(const UbxFrame& f, void*) {
+  UbxNavPvt pvt;
+  GnssFix fix;
+  if (ubxDecodeNavPvt(f, pvt)) {
+    ubxNavPvtToFix(pvt, fix);
+    sink += fix.second;
+  }
+  ubxFrames++;
+}
+
+static std::vector<uint8_t> mutate(const std::vector<uint8_t>& in) {
+  std::vector<uint8_t> out;
+  out.reserve(in.size() + in.size() / 32);
+  for (size_t i = 0; i < in.size(); i++) {
+    uint32_t r = rnd() % 1000;
+    if (r < 3) continue;                                   // dropped byte
+    if (r < 6) out.push_back((uint8_t)(in[i] ^ (1u << (rnd() % 8))));   // bit flip
+    else out.push_back(in[i]);
+    if (r >= 6 && r < 8) out.push_back(rnd() & 1 ? '$' : UBX_SYNC1);     // stray sync
+    if (r == 8) {
+      for (uint32_t k = rnd() % 64; k; k--) out.push_back((uint8_t)rnd());   // garbage burst
+    }
+  }
+  return out;
+}
+
+// --- simulated drive for PositionFilter ---
+
+// 1 Hz fixes of a 12 m/s drive that turns after 15 minutes and crosses
+// the filter's 10 km re-anchoring several times; metres <-> 1e-7 deg with
+// the same scales as LocalFrame
+struct Drive {
+  static const int kEpochs = 3600;
+  double east[kEpochs], north[kEpochs];    // truth, m
+  int32_t lat[kEpochs], lon[kEpochs];      // noisy fixes
+  int glitch;                              // epoch with a 500 m jump
+
+  static double gauss() {
+    double s = 0;
+    for (int i = 0; i < 12; i++) s += rnd() / 4294967296.0;
+    return s - 6;
+  }
+  static int32_t toLat(double n) { return 525200000 + (int32_t)lround(n / 111132.95 * 1e7); }
+  static int32_t toLon(double e) { return 134050000 + (int32_t)lround(e / (111319.49 * cos(52.52 * M_PI / 180)) * 1e7); }
+  static double distM(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2) {
+    double de = (lon1 - lon2) * 1e-7 * 111319.49 * cos(52.52 * M_PI / 180);
+    double dn = (lat1 - lat2) * 1e-7 * 111132.95;
+    return sqrt(de * de + dn * dn);
+  }
+  static double errM(int32_t lat, int32_t lon, double e, double n) {
+    return distM(lat, lon, toLat(n), toLon(e));
+  }
+
+  Drive() {
+    double e = 0, n = 0, heading = 0.5;
+    for (int i = 0; i < kEpochs; i++) {
+      if (i > 900 && i < 960) heading += M_PI / 120;   // gentle 90 deg turn
+      e += 12 * sin(heading);
+      n += 12 * cos(heading);
+      east[i] = e;
+      north[i] = n;
+      lat[i] = toLat(n + 3 * gauss());
+      lon[i] = toLon(e + 3 * gauss());
+    }
+    glitch = 2000;
+    lat[glitch] = toLat(north[glitch] + 500);
+  }
+};
+
+struct FilterRun {
+  double rawRms, smoothRms, midRms;
+  int32_t lat[Drive::kEpochs], lon[Drive::kEpochs];
+};
+
+// feeds every fix (HDOP 1.2 -> class <= 2 -> sigma 5 m), predicts half an
+// epoch ahead; the mid-epoch truth is the average of the two fixes around it
+template <typename Filter>
+static Filter runDrive(const Drive& d, FilterRun& out) {
+  Filter f;
+  double raw = 0, smooth = 0, mid = 0;
+  int n = 0;
+  int64_t t0 = 1760000000000000LL;
+  for (int i = 0; i < Drive::kEpochs; i++) {
+    FixRecord r = {};
+    fixRecordSetTime(r, (uint64_t)(t0 / 1000) + i * 1000ULL);
+    fixRecordSetQuality(r, FIX_TYPE_3D, 12, 120);
+    r.lat = d.lat[i];
+    r.lon = d.lon[i];
+    f.update(r);
+    int64_t now = t0 + i * 1000000LL;
+    f.predict(now, out.lat[i], out.lon[i]);
+    if (i < 60 || i == d.glitch) continue;   // converged, no glitch epoch
+    int32_t la, lo;
+    f.predict(now + 500000, la, lo);
+    if (i + 1 < Drive::kEpochs) {
+      double err = Drive::errM(la, lo, (d.east[i] + d.east[i + 1]) / 2, (d.north[i] + d.north[i + 1]) / 2);
+      mid += err * err;
+    }
+    double er = Drive::errM(d.lat[i], d.lon[i], d.east[i], d.north[i]);
+    double es = Drive::errM(out.lat[i], out.lon[i], d.east[i], d.north[i]);
+    raw += er * er;
+    smooth += es * es;
+    n++;
+  }
+  out.rawRms = sqrt(raw / n);
+  out.smoothRms = sqrt(smooth / n);
+  out.midRms = sqrt(mid / (n - 1));
+  return f;
+}
+
+// one update + one mid-epoch predict per fix
+template <typename Filter>
+static uint64_t filterCost(Filter& f, const Drive& d) {
+  f.reset();
+  int64_t t = 1760000000000000LL;
+  for (int i = 0; i < Drive::kEpochs; i++) {
+    int32_t la, lo;
+    t += 1000000;
+    f.update(t, d.lat[i], d.lon[i], 5000);
+    f.predict(t + 500000, la, lo);
+    sink += (uint32_t)la;
+  }
+  return Drive::kEpochs;
+}
+
+// --- geofence zones ---
+
+// metres around (52.52, 13.40) <-> 1e-7 deg, equirectangular
+static int32_t geoLat(double n) { return 525200000 + (int32_t)lround(n / 111132.95 * 1e7); }
+static int32_t geoLon(double e) { return 134000000 + (int32_t)lround(e / (111319.49 * cos(52.52 * M_PI / 180)) * 1e7); }
+static double geoNorth(int32_t lat) { return (lat - 525200000) * 1e-7 * 111132.95; }
+static double geoEast(int32_t lon) { return (lon - 134000000) * 1e-7 * 111319.49 * cos(52.52 * M_PI / 180); }
+
+// double-precision crossing test in metres
+static bool refInPolygon(const GeofenceVertex* v, int n, double e, double nn) {
+  bool in = false;
+  for (int i = 0, j = n - 1; i < n; j = i++) {
+    double yi = geoNorth(v[i].lat), yj = geoNorth(v[j].lat);
+    double xi = geoEast(v[i].lon), xj = geoEast(v[j].lon);
+    if ((yi > nn) != (yj > nn) && e < (xj - xi) * (nn - yi) / (yj - yi) + xi) in = !in;
+  }
+  return in;
+}
+
+// --- uplink scheduling over a day ---
+
+struct Day {
+  static const int kSeconds = 9000;
+  double east[kSeconds], north[kSeconds];   // truth, m
+  double velE[kSeconds], velN[kSeconds];    // m/s
+  int32_t lat[kSeconds], lon[kSeconds];     // fixes, 2 m noise
+
+  Day() {
+    double e = 0, n = 0, heading = 1.0;
+    for (int t = 0; t < kSeconds; t++) {
+      double speed = 0;
+      if (t >= 1200 && t < 4800) {
+        // city drive: 14 m/s, a turn every 2 min, a red light every 5 min
+        int k = t - 1200;
+        speed = k % 300 < 30 ? 0 : 14;
+        if (k % 120 >= 100) heading += (k / 120 % 2 ? 1 : -1) * M_PI / 40;
+      } else if (t >= 7200) {
+        // walk: 1.4 m/s wandering
+        speed = 1.4;
+        heading += (Drive::gauss()) * 0.05;
+      }
+      velE[t] = speed * sin(heading);
+      velN[t] = speed * cos(heading);
+      e += velE[t];
+      n += velN[t];
+      east[t] = e;
+      north[t] = n;
+      lat[t] = Drive::toLat(n + 2 * Drive::gauss());
+      lon[t] = Drive::toLon(e + 2 * Drive::gauss());
+    }
+  }
+
+  FixRecord fix(int t) const {
+    FixRecord r = FixRecord();
+    fixRecordSetTime(r, (1760000000ULL + t) * 1000);
+    fixRecordSetQuality(r, FIX_TYPE_3D, 9, 120);
+    r.lat = lat[t];
+    r.lon = lon[t];
+    return r;
+  }
+};
+
+struct UplinkRun {
+  uint32_t points, frames, airtimeMs, worstHourMs;
+  double rmsM, maxM;
+};
+
+// offers the day's fixes every `every` s, sends whatever plan() asks for
+// at once, then measures the straight-line track the server sees
+static UplinkRun runUplink(const Day& d, const UplinkScheduler::Config& cfg, int every) {
+  static UplinkScheduler sched;
+  sched = UplinkScheduler(cfg);
+  sched.addChannel(868100000);
+  sched.addChannel(868300000);
+  sched.addChannel(868500000);
+
+  std::vector<FixRecord> queue, received;
+  std::vector<uint32_t> frameAt, frameUs;
+  uint8_t frame[256];
+  FixRecord decoded[TRACK_MAX_BATCH];
+  for (int t = 0; t < Day::kSeconds + 600; t++) {   // 10 min to drain
+    int i = t < Day::kSeconds ? t : Day::kSeconds - 1;
+    if (t % every == 0) {
+      FixRecord r = d.fix(t < Day::kSeconds ? t : i);
+      if (t >= Day::kSeconds) fixRecordSetTime(r, (1760000000ULL + t) * 1000);
+      if (sched.offer(r, (int32_t)lround(d.velN[i] * 1000), (int32_t)lround(d.velE[i] * 1000))) queue.push_back(r);
+    }
+    UplinkScheduler::Plan p;
+    uint32_t nowMs = (uint32_t)t * 1000;
+    if (!queue.empty() && sched.plan(nowMs, &queue[0], queue.size(), frame, sizeof(frame), p)) {
+      size_t n = trackDecode(frame, p.length, decoded, TRACK_MAX_BATCH);
+      if (n != p.points) failures++;
+      received.insert(received.end(), decoded, decoded + n);
+      queue.erase(queue.begin(), queue.begin() + p.points);
+      sched.sent(nowMs + p.airtimeUs / 1000, p, p.airtimeUs);
+      frameAt.push_back(nowMs);
+      frameUs.push_back(p.airtimeUs);
+    }
+  }
+
+  UplinkRun r = {};
+  r.points = (uint32_t)received.size();
+  r.frames = (uint32_t)frameAt.size();
+  r.airtimeMs = (uint32_t)(sched.counters().airtimeUs / 1000);
+  for (size_t a = 0, b = 0; a < frameAt.size(); a++) {
+    uint64_t us = 0;
+    for (b = a; b < frameAt.size() && frameAt[b] - frameAt[a] < 3600000; b++) us += frameUs[b];
+    if (us / 1000 > r.worstHourMs) r.worstHourMs = (uint32_t)(us / 1000);
+  }
+
+  // server side: linear interpolation between consecutive received points
+  double sum = 0;
+  int count = 0;
+  for (size_t k = 0; k + 1 < received.size(); k++) {
+    uint32_t t0 = fixUnixSeconds(received[k]) - 1760000000u, t1 = fixUnixSeconds(received[k + 1]) - 1760000000u;
+    for (uint32_t t = t0; t < t1 && t < (uint32_t)Day::kSeconds; t++) {
+      double f = (double)(t - t0) / (t1 - t0);
+      int32_t la = (int32_t)lround(received[k].lat + f * (received[k + 1].lat - received[k].lat));
+      int32_t lo = (int32_t)lround(received[k].lon + f * (received[k + 1].lon - received[k].lon));
+      double err = Drive::errM(la, lo, d.east[t], d.north[t]);
+      sum += err * err;
+      count++;
+      if (err > r.maxM) r.maxM = err;
+    }
+  }
+  r.rmsM = count ? sqrt(sum / count) : 0;
+  return r;
+}
+
+// --- RAM flash image for TrackLog ---
+
+class RamFlash : public TrackLogStorage {
+public:
+  explicit RamFlash(size_t bytes) : _mem(bytes, 0xFF) {}
+  uint32_t size() const override { return (uint32_t)_mem.size(); }
+  bool read(uint32_t offset, void* out, size_t len) override {
+    memcpy(out, &_mem[offset], len);
+    return true;
+  }
+  bool write(uint32_t offset, const void* data, size_t len) override {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+      if ((_mem[offset + i] & p[i]) != p[i]) _overwrites++;   // NOR can only clear bits
+      _mem[offset + i] &= p[i];
+    }
+    return true;
+  }
+  bool erase(uint32_t offset, size_t len) override {
+    if (offset % TrackLog::kSectorSize || len % TrackLog::kSectorSize) _overwrites++;
+    memset(&_mem[offset], 0xFF, len);
+    return true;
+  }
+  uint32_t overwrites() const { return _overwrites; }
+
+private:
+  std::vector<uint8_t> _mem;
+  uint32_t _overwrites = 0;
+};
+
+int main(int argc, char** argv) {
+  if (argc > 1) runSeconds = atof(argv[1]);
+  if (argc > 2) rng = (uint32_t)strtoul(argv[2], nullptr, 10) | 1;
+
+  uint32_t nmeaSentences, ubxCount;
+  std::vector<uint8_t> nmea = nmeaStream(600, nmeaSentences);
+  std::vector<uint8_t> ubx = ubxStream(600, ubxCount);
+  printf("GnssCore host benchmarks: %u B NMEA (%u sentences), %u B UBX (%u frames), %.1f s each\n",
+         (unsigned)nmea.size(), nmeaSentences, (unsigned)ubx.size(), ubxCount, runSeconds);
+
+  // ring
+  bench("ring", "B", [&]() -> uint64_t {
+    uint8_t out[kChunk];
+    for (size_t pos = 0; pos + kChunk <= nmea.size(); pos += kChunk) {
+      ring.write(&nmea[pos], kChunk);
+      sink += (uint32_t)ring.read(out, sizeof(out));
+    }
+    return nmea.size() / kChunk * kChunk;
+  });
+
+  // framer, clean input: every sentence must come through
+  {
+    NmeaFramer framer;
+    framer.setFrameSink(verifySentence);
+    ring.clear();
+    feedRing(framer, nmea, false);
+    check(framer.counters().sentences == nmeaSentences, "framer: all sentences accepted");
+    check(framer.counters().checksumErrors == 0 && framer.counters().malformed == 0, "framer: no errors");
+    bench("framer", "B", [&]() -> uint64_t {
+      feedRing(framer, nmea, false);
+      return nmea.size();
+    });
+  }
+
+  // framer + UBX
+  {
+    NmeaFramer framer;
+    framer.setBinarySink(feedUbx);
+    ubxParser.setHandler(onUbxFrame);
+    ring.clear();
+    feedRing(framer, ubx, false);
+    check(ubxFrames == ubxCount, "framer+UBX: all frames decoded");
+    bench("framer+UBX", "B", [&]() -> uint64_t {
+      feedRing(framer, ubx, false);
+      return ubx.size();
+    });
+  }
+
+  // fuzz-style: damaged input, random chunking; nothing bad may be accepted
+  {
+    NmeaFramer framer;
+    framer.setFrameSink(verifySentence);
+    framer.setBinarySink(feedUbx);
+    ring.clear();
+    badAccepted = 0;
+    uint64_t fed = 0;
+    bench("fuzz", "B", [&]() -> uint64_t {
+      std::vector<uint8_t> damaged = mutate(nmea);
+      feedRing(framer, damaged, true);
+      fed += damaged.size();
+      return damaged.size();
+    });
+    const NmeaFramer::Counters& c = framer.counters();
+    printf("             accepted %u, checksum errors %u, malformed %u, skipped %u B\n",
+           c.sentences, c.checksumErrors, c.malformed, c.skippedBytes);
+    check(badAccepted == 0, "fuzz: every accepted sentence verifies");
+    check(c.skippedBytes <= fed, "fuzz: skipped bytes within input");
+  }
+
+  // format
+  {
+    char buf[GNSS_FMT_COORD_LEN];
+    bench("format", "call", [&]() -> uint64_t {
+      for (uint32_t i = 0; i < 10000; i++) {
+        GnssCoord c = { (uint16_t)(i % 180), i * 99991u % 1000000000u, (i & 1) != 0 };
+        sink += (uint32_t)formatCoordinate(buf, "LAT: ", c);
+        sink += (uint32_t)formatTime(buf, i % 24, i % 60, i % 60, i % 100);
+      }
+      return 20000;
+    });
+  }
+
+  // fix record pack / unpack
+  {
+    bool same = true;
+    GnssFix fix = {};
+    for (uint32_t i = 0; i < 20000 && same; i++) {
+      fix.timeValid = fix.locationValid = fix.dateValid = true;
+      fix.year = (uint16_t)(1990 + i % 100);
+      fix.month = (uint8_t)(1 + i % 12);
+      fix.day = (uint8_t)(1 + i % 28);
+      fix.hour = (uint8_t)(i % 24);
+      fix.minute = (uint8_t)(i * 7 % 60);
+      fix.second = (uint8_t)(i * 13 % 60);
+      fix.centisecond = (uint8_t)(i % 100);
+      fix.lat = { (uint16_t)(i % 90), (uint32_t)(rnd() % 1000000000u), (i & 1) != 0 };
+      fix.lon = { (uint16_t)(i % 180), (uint32_t)(rnd() % 1000000000u), (i & 2) != 0 };
+      fix.antenna = (GnssAntenna)(i % 3);
+      fix.satellites = (uint8_t)(i % 40);
+      fix.hdop = (uint16_t)(i % 3000);
+
+      FixRecord r;
+      GnssFix back;
+      fixRecordFromFix(fix, r);
+      fixRecordToFix(r, back);
+      char a[GNSS_FMT_COORD_LEN], b[GNSS_FMT_COORD_LEN];
+      formatCoordinate(a, "", fix.lat);
+      formatCoordinate(b, "", back.lat);
+      same = !strcmp(a, b) && fixUnixSeconds(r) == (uint32_t)gnssUnixSeconds(fix) &&
+             back.year == fix.year && back.month == fix.month && back.day == fix.day &&
+             back.hour == fix.hour && back.minute == fix.minute && back.second == fix.second &&
+             back.centisecond == fix.centisecond && back.antenna == fix.antenna &&
+             fixSatellites(r) == (fix.satellites > 31 ? 31 : fix.satellites) &&
+             (!fix.hdop || back.hdop >= fix.hdop) && fixType(r) == FIX_TYPE_POSITION;
+      if (!same) {
+        printf("  %s != %s or time/quality differs\n", a, b);
+      }
+    }
+    check(same, "fix record: date, time, six decimals, antenna, quality survive");
+
+    fix.dateValid = false;
+    FixRecord r;
+    fixRecordFromFix(fix, r);
+    check(fixHasTime(r) && !fixHasDate(r) && !fixIsComplete(r), "fix record: time without date");
+    memset(&r, 0xFF, sizeof(r));
+    check(!fixRecordValid(r), "fix record: erased slot is invalid");
+
+    bench("fix record", "fix", [&]() -> uint64_t {
+      for (uint32_t i = 0; i < 10000; i++) {
+        fix.second = (uint8_t)(i % 60);
+        fixRecordFromFix(fix, r);
+        sink += r.time;
+      }
+      return 10000;
+    });
+  }
+
+  // position filter, float and fixed point on the same drive
+  {
+    static Drive drive;
+    static FilterRun runF, runQ;
+    PositionFilterF ff = runDrive<PositionFilterF>(drive, runF);
+    PositionFilterQ fq = runDrive<PositionFilterQ>(drive, runQ);
+    double maxDiff = 0;
+    for (int i = 0; i < Drive::kEpochs; i++) {
+      double e = Drive::distM(runF.lat[i], runF.lon[i], runQ.lat[i], runQ.lon[i]);
+      if (e > maxDiff) maxDiff = e;
+    }
+    printf("filter       raw %.2f m rms, float %.2f m (mid-epoch %.2f m), fixed %.2f m (%.2f m),"
+           " float/fixed apart <= %.3f m\n", runF.rawRms, runF.smoothRms, runF.midRms,
+           runQ.smoothRms, runQ.midRms, maxDiff);
+    check(runF.smoothRms < runF.rawRms * 0.8 && runQ.smoothRms < runQ.rawRms * 0.8,
+          "filter: smoothed error below the raw error");
+    check(runF.midRms < runF.rawRms && runQ.midRms < runQ.rawRms,
+          "filter: mid-epoch prediction below the raw error");
+    check(maxDiff < 0.5, "filter: float and fixed point agree");
+    check(ff.stats().rejected == 1 && fq.stats().rejected == 1 && ff.stats().restarts == 1 &&
+          fq.stats().restarts == 1, "filter: glitch rejected, no restart");
+
+    PositionFilterF bf;
+    PositionFilterQ bq;
+    bench("filter float", "upd", [&]() -> uint64_t { return filterCost(bf, drive); });
+    bench("filter fixed", "upd", [&]() -> uint64_t { return filterCost(bq, drive); });
+  }
+
+  // geofence: 200 circles (30-500 m) and 100 star polygons (3-32 corners,
+  // 80-800 m) scattered over 20 x 20 km
+  {
+    static uint32_t blob[16384];
+    static GeofenceVertex polys[100][32];
+    static int polyCount[100];
+    GeofenceWriter writer(blob, sizeof(blob), 300);
+    for (int i = 0; i < 300; i++) {
+      double ce = (rnd() % 20000) - 10000.0, cn = (rnd() % 20000) - 10000.0;
+      char name[16];
+      snprintf(name, sizeof(name), "Z%d", i);
+      if (i < 200) {
+        writer.addCircle((uint16_t)i, geoLat(cn), geoLon(ce), 30000 + rnd() % 470000, name);
+      } else {
+        int k = i - 200, n = 3 + (int)(rnd() % 30);
+        for (int c = 0; c < n; c++) {
+          double a = 2 * M_PI * c / n, r = 80 + rnd() % 720;
+          polys[k][c].lat = geoLat(cn + r * cos(a));
+          polys[k][c].lon = geoLon(ce + r * sin(a));
+        }
+        polyCount[k] = n;
+        writer.addPolygon((uint16_t)i, polys[k], (uint16_t)n, name);
+      }
+    }
+    size_t size = writer.finish();
+    static Geofence fence;
+    Geofence::Config gc;
+    gc.confirmFixes = 1;
+    check(size && fence.load(blob, size, gc), "geofence: blob builds and loads");
+    ((uint8_t*)blob)[100] ^= 1;
+    static Geofence broken;
+    check(!broken.load(blob, size), "geofence: damaged blob rejected");
+    ((uint8_t*)blob)[100] ^= 1;
+
+    // shapes against the double references (1 m band around edges skipped)
+    uint32_t mismatches = 0;
+    for (int t = 0; t < 200000; t++) {
+      uint16_t zi = (uint16_t)(rnd() % 300);
+      const GeofenceZone& z = fence.zone(zi);
+      double ce = zi < 200 ? geoEast(z.lon) : geoEast(z.minLon / 2 + z.maxLon / 2);
+      double cn = zi < 200 ? geoNorth(z.lat) : geoNorth(z.minLat / 2 + z.maxLat / 2);
+      double e = ce + (int)(rnd() % 2000) - 1000.0, n = cn + (int)(rnd() % 2000) - 1000.0;
+      int32_t la = geoLat(n), lo = geoLon(e);
+      bool got = fence.contains(zi, la, lo), want;
+      if (zi < 200) {
+        double d = hypot(geoEast(lo) - ce, geoNorth(la) - cn) - z.radiusMm / 1000.0;
+        if (fabs(d) < 1) continue;
+        want = d < 0;
+      } else {
+        want = refInPolygon(polys[zi - 200], polyCount[zi - 200], geoEast(lo), geoNorth(la));
+        if (want != refInPolygon(polys[zi - 200], polyCount[zi - 200], geoEast(lo) + 1, geoNorth(la)) ||
+            want != refInPolygon(polys[zi - 200], polyCount[zi - 200], geoEast(lo), geoNorth(la) + 1) ||
+            want != refInPolygon(polys[zi - 200], polyCount[zi - 200], geoEast(lo) - 1, geoNorth(la) - 1)) {
+          continue;
+        }
+      }
+      if (got != want) mismatches++;
+    }
+    check(mismatches == 0, "geofence: shape tests match the references");
+
+    // random walk: the inside set must equal a scan of every zone
+    std::vector<int32_t> walkLat, walkLon;
+    double e = 0, n = 0;
+    for (int i = 0; i < 20000; i++) {
+      e += (int)(rnd() % 41) - 20.0;
+      n += (int)(rnd() % 41) - 20.0;
+      if (fabs(e) > 11000) e = 0;
+      if (fabs(n) > 11000) n = 0;
+      walkLat.push_back(geoLat(n));
+      walkLon.push_back(geoLon(e));
+    }
+    uint32_t wrong = 0, events = 0;
+    Geofence::Event ev[8];
+    for (size_t i = 0; i < walkLat.size(); i++) {
+      events += fence.update(walkLat[i], walkLon[i], ev, 8);
+      uint16_t expect = 0;
+      bool same = true;
+      for (uint16_t z = 0; z < 300; z++) {
+        if (!fence.contains(z, walkLat[i], walkLon[i])) continue;
+        expect++;
+        bool held = false;
+        for (uint8_t k = 0; k < fence.insideCount(); k++) held |= fence.inside(k) == z;
+        same &= held;
+      }
+      if (!same || expect != fence.insideCount()) wrong++;
+    }
+    check(wrong == 0 && fence.stats().insideFull == 0, "geofence: inside set matches a full scan");
+    check(events == fence.stats().transitions && fence.stats().eventsDropped == 0,
+          "geofence: every transition reported");
+    printf("geofence     %u zones, %u B blob, max %u zones per cell, %u transitions on a %u-fix walk\n",
+           (unsigned)fence.zoneCount(), (unsigned)size, (unsigned)fence.maxCellZones(), (unsigned)events,
+           (unsigned)walkLat.size());
+
+    fence.resetStats();
+    bench("geofence", "fix", [&]() -> uint64_t {
+      for (size_t i = 0; i < walkLat.size(); i++) sink += fence.update(walkLat[i], walkLon[i], ev, 8);
+      return walkLat.size();
+    });
+    printf("             avg %.2f shape tests, max %u, %.1f polygon edges per fix\n",
+           (double)fence.stats().zoneTests / fence.stats().updates, (unsigned)fence.stats().maxTests,
+           (double)fence.stats().edgeTests / fence.stats().updates);
+  }
+
+  // uplink: the former fixed schedule (a point every 5 s at SF10) against
+  // the adaptive one at SF10 and at SF9-12 (least airtime per point, and
+  // spending the surplus on range), same day, same channels
+  {
+    static Day day;
+    UplinkScheduler::Config fixedCfg;
+    fixedCfg.minSf = fixedCfg.maxSf = 10;
+    fixedCfg.toleranceMm = 0;
+    fixedCfg.maxGapS = fixedCfg.heartbeatS = 5;
+    UplinkRun runs[4];
+    runs[0] = runUplink(day, fixedCfg, 5);
+    UplinkScheduler::Config motionCfg;
+    motionCfg.minSf = motionCfg.maxSf = 10;
+    runs[1] = runUplink(day, motionCfg, 1);
+    UplinkScheduler::Config rangeCfg;
+    rangeCfg.minSf = 9;
+    runs[2] = runUplink(day, rangeCfg, 1);
+    UplinkScheduler::Config surplusCfg = rangeCfg;
+    surplusCfg.rangeFromSurplus = true;
+    runs[3] = runUplink(day, surplusCfg, 1);
+
+    static const char* const kNames[] = { "fixed 5 s", "SF10", "SF9-12", "SF9-12 rng" };
+    bool dutyOk = true;
+    for (int i = 0; i < 4; i++) {
+      printf("%-12s %-10s %4u points, %3u frames, %5.1f s on air (worst hour %4.1f s), error %4.1f m rms, %4.1f m max\n",
+             i ? "" : "uplink", kNames[i], (unsigned)runs[i].points, (unsigned)runs[i].frames,
+             runs[i].airtimeMs / 1000.0, runs[i].worstHourMs / 1000.0, runs[i].rmsM, runs[i].maxM);
+      dutyOk &= runs[i].worstHourMs <= 36000;
+    }
+    check(dutyOk, "uplink: 1 % duty cycle in every hour");
+    AirtimeBucket slow(1);
+    slow.sent(0, slow.capacityUs());
+    check(slow.availableUs(3600000) == slow.capacityUs(), "uplink: an empty 0.1 % bucket refills within the hour");
+    check(runs[1].airtimeMs < runs[0].airtimeMs / 2 && runs[2].airtimeMs < runs[0].airtimeMs,
+          "uplink: adaptive needs less airtime");
+    check(runs[2].airtimeMs <= runs[3].airtimeMs, "uplink: least airtime per point unless range is asked for");
+    check(runs[1].rmsM < 10 && runs[1].maxM < 40 && runs[2].rmsM < 10 && runs[2].maxM < 40,
+          "uplink: adaptive track within the tolerance");
+
+    static UplinkScheduler sched;
+    sched = UplinkScheduler(rangeCfg);
+    sched.addChannel(868100000);
+    std::vector<FixRecord> fixes;
+    for (int t = 1200; t < 4800; t++) fixes.push_back(day.fix(t));
+    uint32_t t0 = 1200;
+    bench("uplink offer", "fix", [&]() -> uint64_t {
+      sched.resetCounters();
+      for (size_t i = 0; i < fixes.size(); i++) {
+        FixRecord r = fixes[i];
+        fixRecordSetTime(r, (1760000000ULL + t0 + i) * 1000);
+        sink += sched.offer(r, (int32_t)(day.velN[1200 + i] * 1000), (int32_t)(day.velE[1200 + i] * 1000));
+      }
+      t0 += (uint32_t)fixes.size();
+      return fixes.size();
+    });
+  }
+
+  // power: the uplink day at 1 Hz, two button presses while parked; the
+  // receiver sends nothing in backup and needs 3 poor fixes after waking
+  {
+    static Day day;
+    PowerGovernor::Config cfg;
+    PowerGovernor gov(cfg);
+    uint32_t wrongBackup = 0, missedMs = 0, worstMissedMs = 0, onWhileIdle = 0, hotStart = 0;
+    for (int t = 0; t < Day::kSeconds; t++) {
+      uint32_t now = (uint32_t)t * 1000 + 500;
+      if (t == 600 || t == 6000) gov.activity(now);
+      double speed = sqrt(day.velN[t] * day.velN[t] + day.velE[t] * day.velE[t]);
+      bool moving = speed >= cfg.movingMms / 1000.0;
+      if (gov.gnss() == PowerGovernor::GNSS_TRACKING) {
+        FixRecord r = day.fix(t);
+        if (hotStart) {
+          fixRecordSetQuality(r, FIX_TYPE_3D, 4, 450);
+          hotStart--;
+        }
+        gov.fix(now, r, (uint32_t)(speed * 1000));
+        missedMs = 0;
+      } else if (moving) {
+        // moving while the receiver sleeps: only a check fix notices
+        missedMs += 1000;
+        if (missedMs > worstMissedMs) worstMissedMs = missedMs;
+      }
+      PowerGovernor::Gnss before = gov.gnss();
+      gov.update(now + 500);
+      if (before == PowerGovernor::GNSS_BACKUP && gov.gnss() == PowerGovernor::GNSS_TRACKING) hotStart = 3;
+      if (gov.gnss() == PowerGovernor::GNSS_BACKUP && moving && missedMs == 0) wrongBackup++;
+      // a red light is 30 s: the display must not go dark at one
+      if (t > 1200 + cfg.offS && t < 4800 && gov.display() == PowerGovernor::DISPLAY_OFF) onWhileIdle++;
+    }
+    const PowerGovernor::Stats& st = gov.stats();
+    check(wrongBackup == 0 && onWhileIdle == 0, "power: backup and display off only while parked");
+    check(worstMissedMs <= (cfg.backupS + cfg.checkS) * 1000UL, "power: motion noticed within a backup period");
+    check(st.backups > 4 && st.checks > 4 && st.moved >= 1 && st.displayWakes >= 3,
+          "power: parked periods reach backup, checks and wakes happen");
+    printf("power        %u backups, %u checks (%u moved, %u failed), display on/dim/off %u/%u/%u s,\n"
+           "             rail off %u s, saved %u.%u mA on average, %u mAh\n",
+           (unsigned)st.backups, (unsigned)st.checks, (unsigned)st.moved, (unsigned)st.checkFailed,
+           (unsigned)(st.displayMs[0] / 1000), (unsigned)(st.displayMs[1] / 1000),
+           (unsigned)(st.displayMs[2] / 1000), (unsigned)(st.railOffMs / 1000),
+           (unsigned)(gov.savedUa() / 1000), (unsigned)(gov.savedUa() / 100 % 10), (unsigned)gov.savedMah());
+
+    // a receiver that ignores RXM-PMREQ keeps sending: no backup is counted
+    PowerGovernor deaf(cfg);
+    for (int t = 0; t < Day::kSeconds; t++) {
+      uint32_t now = (uint32_t)t * 1000 + 500;
+      double speed = sqrt(day.velN[t] * day.velN[t] + day.velE[t] * day.velE[t]);
+      deaf.fix(now, day.fix(t), (uint32_t)(speed * 1000));
+      deaf.update(now + 500);
+    }
+    const PowerGovernor::Stats& ds = deaf.stats();
+    check(ds.backupFailed == PowerGovernor::kMaxBackupFailures && ds.backups == 0 && ds.backupMs == 0 &&
+          ds.railOffMs == 0 && deaf.gnss() == PowerGovernor::GNSS_TRACKING,
+          "power: an ignored backup request is detected and not counted");
+  }
+
+  // track codec round trip
+  {
+    FixRecord pts[64], back[64];
+    uint8_t frame[512];
+    for (int i = 0; i < 64; i++) {
+      pts[i] = FixRecord();
+      fixRecordSetTime(pts[i], (1760000000ULL + i * 5) * 1000);
+      fixRecordSetQuality(pts[i], FIX_TYPE_POSITION, 0, 0);
+      pts[i].lat = 525200080 + i * 410 + (int32_t)(rnd() % 50);
+      pts[i].lon = 134049540 + i * 270 - (int32_t)(rnd() % 50);
+    }
+    size_t taken;
+    size_t len = trackEncode(pts, 64, 0, frame, sizeof(frame), taken);
+    check(taken == 64 && trackDecode(frame, len, back, 64) == 64 && !memcmp(pts, back, sizeof(pts)),
+          "track codec: lossless round trip at q = 0");
+    bench("track codec", "pt", [&]() -> uint64_t {
+      size_t n = trackEncode(pts, 64, 2, frame, sizeof(frame), taken);
+      sink += (uint32_t)trackDecode(frame, n, back, 64);
+      return 64;
+    });
+  }
+
+  // track buffer: random push / peek / drop against a flat reference FIFO
+  {
+    static FixRecord arena[1000];   // 15 batches of 64 after rounding
+    static TrackBuffer<256, 64> buf;
+    buf.attachArena(arena, 1000);
+    std::vector<FixRecord> ref;
+    FixRecord out[100];
+    bool same = true;
+    uint32_t next = 0, lost = 0;
+    for (int i = 0; i < 200000 && same; i++) {
+      uint32_t op = rnd() % 8;
+      if (op < 5) {
+        FixRecord r = {};
+        r.lat = (int32_t)next++;
+        buf.push(r);
+        ref.push_back(r);
+        if (ref.size() > buf.size()) {   // a spill overwrote the oldest points
+          size_t n = ref.size() - buf.size();
+          ref.erase(ref.begin(), ref.begin() + n);
+          lost += (uint32_t)n;
+        }
+      } else if (op < 7) {
+        size_t max = 1 + rnd() % 100;
+        size_t n = buf.peek(out, max);
+        same &= n == (ref.size() < max ? ref.size() : max);
+        for (size_t k = 0; k < n && same; k++) same &= out[k].lat == ref[k].lat;
+      } else {
+        size_t n = rnd() % 80;
+        buf.drop(n);
+        ref.erase(ref.begin(), ref.begin() + (n < ref.size() ? n : ref.size()));
+      }
+      same &= buf.size() == ref.size() && (ref.empty() || buf.at(0).lat == ref[0].lat);
+    }
+    check(same, "track buffer: FIFO order across the hot ring and the arena");
+    check(buf.dropped() == lost, "track buffer: drop count");
+
+    buf.clear();
+    FixRecord r = {};
+    bench("track buffer", "pt", [&]() -> uint64_t {
+      // steady state: one spill per 64 pushes, the uplink drains in batches
+      for (int i = 0; i < 4096; i++) {
+        buf.push(r);
+        if (buf.size() > 512) {
+          sink += (uint32_t)buf.peek(out, 100);
+          buf.drop(100);
+        }
+      }
+      return 4096;
+    });
+    printf("             %u spills, %u KB moved, %u arena runs read\n", buf.stats().spills,
+           buf.stats().spilledBytes / 1024, buf.stats().arenaReads);
+  }
+
+  // track log on a 64-sector RAM image (wraps every 16320 records)
+  {
+    RamFlash flash(64 * TrackLog::kSectorSize);
+    TrackLog log;
+    check(log.begin(flash), "track log: format");
+    uint32_t t = 1760000000u;
+    bench("track log", "rec", [&]() -> uint64_t {
+      for (int i = 0; i < 1000; i++) {
+        FixRecord r = {};
+        fixRecordSetTime(r, (uint64_t)t * 1000 + i * 100);
+        fixRecordSetQuality(r, FIX_TYPE_3D, 12, 90);
+        r.lat = 525200080 + i;
+        r.lon = 134049540 - i;
+        log.append(r);
+      }
+      t += 100;
+      return 1000;
+    });
+    log.flush();
+    TrackLog recovered;
+    recovered.begin(flash);
+    check(recovered.count() == log.count(), "track log: recovery count");
+    check(flash.overwrites() == 0, "track log: no bit set without erase");
+    uint32_t worn = recovered.stats().maxEraseCount;
+    check(recovered.erase() && recovered.count() == 0 && recovered.stats().maxEraseCount == worn + 1,
+          "track log: erase keeps the wear count");
+    for (int i = 0; i < 300; i++) {
+      FixRecord r = {};
+      fixRecordSetTime(r, (uint64_t)(t + i) * 1000);
+      recovered.append(r);
+    }
+    recovered.flush();
+    TrackLog reopened;
+    check(reopened.begin(flash) && reopened.count() == 300 &&
+          reopened.stats().maxEraseCount == recovered.stats().maxEraseCount,
+          "track log: recovery after erase");
+    printf("             %u records, %u page programs, %u erases\n",
+           (unsigned)log.count(), log.stats().programs, log.stats().erases);
+  }
+
+  // fix bus: one producer, two latest() readers, two ring subscribers
+  {
+    struct Record {
+      uint32_t seq;
+      int32_t lat;
+      int32_t lon;
+      uint32_t check;   // ~seq ^ lat ^ lon: a torn copy fails it
+    };
+    static FixBus<Record, 4, 64> bus;
+    int8_t subs[2] = { bus.subscribe(), bus.subscribe() };
+    std::atomic<bool> stop(false);
+    std::atomic<uint32_t> torn(0), reads(0), disorder(0);
+    uint32_t received[2] = { 0, 0 };
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 2; r++) {
+      threads.emplace_back([&]() {
+        Record rec;
+        uint32_t last = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+          if (!bus.latest(rec)) continue;
+          if (rec.check != (~rec.seq ^ (uint32_t)rec.lat ^ (uint32_t)rec.lon)) torn++;
+          if (rec.seq < last) disorder++;
+          last = rec.seq;
+          reads++;
+        }
+      });
+    }
+    for (int s = 0; s < 2; s++) {
+      threads.emplace_back([&, s]() {
+        Record rec;
+        uint32_t expect = 1;
+        for (;;) {
+          if (!bus.next(subs[s], rec)) {
+            if (stop.load(std::memory_order_acquire) && !bus.pending(subs[s])) break;
+            continue;
+          }
+          if (rec.seq < expect) disorder++;
+          expect = rec.seq + 1;
+          received[s]++;
+        }
+      });
+    }
+
+    uint32_t seq = 0;
+    bench("fix bus", "rec", [&]() -> uint64_t {
+      for (int i = 0; i < 1000; i++) {
+        Record rec;
+        rec.seq = ++seq;
+        rec.lat = (int32_t)(seq * 2654435761u);
+        rec.lon = -(int32_t)seq;
+        rec.check = ~rec.seq ^ (uint32_t)rec.lat ^ (uint32_t)rec.lon;
+        bus.publish(rec);
+      }
+      return 1000;
+    });
+    stop.store(true, std::memory_order_release);
+    for (std::thread& t : threads) t.join();
+
+    printf("             %u latest() reads, ring: %u + %u received, %u + %u dropped\n",
+           reads.load(), received[0], received[1], bus.dropped(subs[0]), bus.dropped(subs[1]));
+    check(torn == 0, "fix bus: no torn latest() copy");
+    check(disorder == 0, "fix bus: records in publish order");
+    check(received[0] + bus.dropped(subs[0]) == seq && received[1] + bus.dropped(subs[1]) == seq,
+          "fix bus: every record received or counted as dropped");
+  }
+
+  printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * Boot Time Breakdown: Reset -> setup() -> First GNSS Byte -> First Fix
+ *
+ * Measures where a duty-cycled node spends its awake time before it has a
+ * fix, to compare board profiles (heltec_wifi_lora_32_V4.json against
+ * heltec_wifi_lora_32_V4_fastboot.json, optionally with the bootloader
+ * options of sdkconfig.fastboot.defaults) and GNSS start modes.
+ *
+ * What It Does:
+ * - Timestamps with the RTC timer, which runs from chip reset and through
+ *   deep sleep:
+ *   - reset / wake   RTC time 0 after a power-on or RST reset; after a
+ *                    deep-sleep wake, the moment the sleep timer expired
+ *   - C++ init       a global constructor, i.e. ROM + bootloader + image
+ *                    load + IDF startup up to the constructors
+ *   - setup()        after the rest of the IDF and Arduino init
+ *   - GNSS byte      first byte in the GnssUart ring
+ *   - sentence       first checksum-valid NMEA sentence
+ *   - fix            first sentence with valid time and location
+ * - Prints one line per cycle only after the fix, so printing never
+ *   delays the phases it measures; setup() does not wait for Serial
+ * - BOOT_SLEEP_S > 0: deep-sleeps and repeats, with the GNSS in backup
+ *   mode (u-blox, hot start) or powered off, and the ROM log disabled for
+ *   the wake (esp_deep_sleep_disable_rom_logging())
+ *
+ * The RTC timer runs on the internal 136 kHz RC oscillator unless a 32 kHz
+ * crystal is fitted: expect a few percent of error on the reset -> C++
+ * init phase, esp_timer (40 MHz crystal) times everything after it.
+ *
+ * Serial output: UART0 on GPIO 43/44 (115200 8N1) with either board JSON;
+ * neither defines ARDUINO_USB_CDC_ON_BOOT, so nothing waits for a USB host.
+ *
+ * Usage:
+ * 1. Upload this sketch to your Heltec V4 board (either board JSON)
+ * 2. Open the Serial Monitor at 115200 baud
+ * 3. Compare the cycle lines; the first one after upload is a cold start
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <esp_system.h>
+#include <esp_private/esp_clk.h>
+#include <driver/gpio.h>
+#include "HT_TinyGPS++.h"
+#include "GnssUart.h"
+#include "GnssPower.h"
+#include "GnssAutoDetect.h"
+#include "NmeaFramer.h"
+#include "UbxConfig.h"
+#include "HeltecV4Board.h"
+
+using GnssPins = HeltecV4::Gnss;
+
+#define BOOT_SLEEP_S       30    // deep sleep between cycles, 0 = one measurement
+#define BOOT_GNSS_BACKUP   1     // 1 = u-blox backup mode (hot start), 0 = GNSS off (cold start)
+#define BOOT_FIX_TIMEOUT_S 180   // report without a fix after this long
+
+TinyGPSPlus GPS;
+
+static StaticByteRing<2048> gnssRing;
+static GnssUart gnssUart;
+static NmeaFramer gnssFramer;
+static GnssPowerSequencer gnssPower;
+
+// survive deep sleep (RTC slow memory is not cleared on a timer wake)
+RTC_DATA_ATTR static uint64_t rtcWakeAtUs;   // RTC time the sleep timer expires
+RTC_DATA_ATTR static uint32_t rtcCycles;
+RTC_DATA_ATTR static uint32_t rtcMagic;
+static const uint32_t kMagic = 0x42544D31;  // "BTM1"
+
+// phase timestamps; RTC timer for the early ones, esp_timer afterwards
+static uint64_t ctorRtcUs;
+static uint64_t setupRtcUs;
+static int64_t setupUs, byteUs, sentenceUs, fixUs;
+
+// runs from do_global_ctors(), before app_main() and the Arduino init
+__attribute__((constructor)) static void markConstructors() {
+  ctorRtcUs = esp_clk_rtc_time();
+}
+
+static void feedTinyGps(const NmeaSentence& s, void*) {
+  gnssPower.dataSeen();
+  if (!sentenceUs) sentenceUs = esp_timer_get_time();
+  for (size_t i = 0; i < s.size(); i++) GPS.encode(s.at(i));
+}
+
+static bool timerWake() {
+  return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER && rtcMagic == kMagic;
+}
+
+static float ms(int64_t fromUs, int64_t toUs) {
+  return toUs ? (toUs - fromUs) / 1000.0f : -1.0f;
+}
+
+static void report() {
+  // phases before setup() come from the RTC timer
+  uint64_t resetRtcUs = timerWake() ? rtcWakeAtUs : 0;
+  float toCtors = (int64_t)(ctorRtcUs - resetRtcUs) / 1000.0f;
+  float toSetup = (int64_t)(setupRtcUs - ctorRtcUs) / 1000.0f;
+
+  Serial.printf("cycle %lu (%s, reset reason %d, GNSS %s): reset->C++ init %.1f ms, ->setup() %.1f ms, "
+                "->GNSS byte %.1f ms, ->sentence %.1f ms, ->fix %.1f ms, total %.1f ms\n",
+                (unsigned long)rtcCycles, timerWake() ? "deep-sleep wake" : "power-on/reset",
+                (int)esp_reset_reason(),
+                timerWake() ? (BOOT_GNSS_BACKUP ? "backup" : "off") : "cold",
+                toCtors, toSetup, ms(setupUs, byteUs), ms(byteUs, sentenceUs),
+                ms(sentenceUs, fixUs),
+                toCtors + toSetup + (fixUs ? ms(setupUs, fixUs) : ms(setupUs, esp_timer_get_time())));
+  if (!fixUs) Serial.printf("  no fix within %d s\n", BOOT_FIX_TIMEOUT_S);
+  Serial.flush();
+}
+
+#if BOOT_SLEEP_S
+static void goToSleep() {
+#if BOOT_GNSS_BACKUP
+  ubxEnterBackup(gnssUart);   // supply stays on, ephemeris and RTC kept
+#else
+  gnssPower.powerOff();
+#endif
+  gpio_hold_en((gpio_num_t)GnssPins::ctrl);
+  gpio_deep_sleep_hold_en();
+
+  uint64_t sleepUs = BOOT_SLEEP_S * 1000000ULL;
+  rtcMagic = kMagic;
+  rtcCycles++;
+  esp_deep_sleep_disable_rom_logging();   // next wake only
+  esp_sleep_enable_timer_wakeup(sleepUs);
+  rtcWakeAtUs = esp_clk_rtc_time() + sleepUs;
+  esp_deep_sleep_start();
+}
+#endif
+
+void setup() {
+  setupRtcUs = esp_clk_rtc_time();
+  setupUs = esp_timer_get_time();
+  if (!timerWake()) rtcCycles = 0;
+
+  gnssFramer.setFrameSink(feedTinyGps);
+  GnssPowerSequencer::Timing timing;
+  bool warm = timerWake() && BOOT_GNSS_BACKUP;
+  if (warm) {
+    timing.settleMs = 10;   // supply never went off
+    timing.resetMs = 0;     // keep the hot-start data
+  }
+  gnssPower.start<GnssPins>(timing);
+  gpio_hold_dis((gpio_num_t)GnssPins::ctrl);
+
+  GnssPortConfig port = GnssAutoDetect::defaultPort<GnssPins>();
+  GnssAutoDetect::loadSaved(port);
+  gnssUart.begin(UART_NUM_1, port.rxPin, port.txPin, port.baud, gnssRing);
+  if (warm) ubxWake(gnssUart);
+
+  Serial.begin(115200);
+}
+
+void loop() {
+  gnssUart.waitForData(100);
+  if (!byteUs && gnssUart.counters().bytes) byteUs = esp_timer_get_time();
+  gnssFramer.poll(gnssRing);
+
+  if (!fixUs && GPS.location.isValid() && GPS.time.isValid()) fixUs = esp_timer_get_time();
+
+  bool timedOut = esp_timer_get_time() - setupUs > BOOT_FIX_TIMEOUT_S * 1000000LL;
+  static bool reported = false;
+  if (!reported && (fixUs || timedOut)) {
+    reported = true;
+    report();
+#if BOOT_SLEEP_S
+    goToSleep();
+#endif
+  }
+}
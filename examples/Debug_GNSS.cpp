@@ -7,12 +7,18 @@
  * identify correct settings.
  * 
  * What It Does:
+ * - Reuses a configuration saved in NVS by a previous run (one frame to verify)
+ * - Otherwise auto-detects it: hardware baud measurement on each pin variant,
+ *   stopping at the first checksum-valid NMEA/UBX frame, then saves it to NVS
+ * - If auto-detection fails, falls back to the full brute-force sweep:
  * - Tests 2 power states (HIGH/LOW on VGNSS_CTRL pin)
  * - Tests 2 wake signal levels (HIGH/LOW on GNSS_WAKE pin)
  * - Tests both possible pin configurations (Pin Variant A & B)
  * - Tests 3 common baud rates (9600, 38400, 115200)
  * - Captures and displays raw UART data in HEX + ASCII format
  * - Counts received bytes for each test combination
+ * - Reports UART FIFO overflows / RX buffer overruns, so the byte count
+ *   can be trusted even at 115200 baud
  * 
  * Usage:
  * 1. Upload this sketch to your Heltec V4 board
@@ -29,7 +35,9 @@
  * Important Notes:
  * - This sketch runs in setup() only and outputs to Serial (115200 baud)
  * - UART data is captured on Serial1 (GNSS module)
- * - Each test lasts 3 seconds of data capture
+ * - Auto-detection normally finishes within one NMEA burst (~1 s after boot)
+ * - Set FORGET_SAVED_CONFIG to 1 to force a new detection
+ * - Each test of the full sweep lasts 3 seconds of data capture
  * - Valid GNSS data typically starts with $ (0x24) followed by letters
  * - Common patterns: $GPRMC, $GPGGA, $GPGSA, $GPGSV
  * 
@@ -40,8 +48,10 @@
  * - GNSS_RST: GPIO 42 (hardware reset pin)
  * 
  * Output Format:
- * Each line shows: [HEX bytes] [ASCII representation]
- * Example: "47 50 52 4D 43 . GPRMC"
+ * Each line shows: [HEX bytes] [ASCII representation], 16 bytes per line
+ * Example: "24 47 50 52 4D 43 2C ... $GPRMC,..."
+ * Lines are formatted into a preallocated buffer and sent with one
+ * Serial.write() each, so the USB console keeps up with fast baud rates.
  * 
  * Author: Paul Marx
  * Date: February 2026
@@ -49,39 +59,125 @@
  */
 
 #include <Arduino.h>
+#include "GnssAutoDetect.h"
+#include "HeltecV4Board.h"
 
-#define VGNSS_CTRL 34
-#define GNSS_WAKE  40
-#define GNSS_RST   42
+#define FORGET_SAVED_CONFIG 0
+#define BULK_DUMP 1   // 0 = legacy per-byte Serial.print dump
 
-// UART-Pins (Variante A: rx=39 tx=38)
-static const int RXA = 39;
-static const int TXA = 38;
-
-// UART-Pins (Variante B: rx=38 tx=39) – zum Gegentest
-static const int RXB = 38;
-static const int TXB = 39;
+// Pins aus HeltecV4Board.h: Variante A = HeltecV4::Gnss (rx=39 tx=38),
+// Variante B = HeltecV4::GnssSwapped (rx=38 tx=39) – zum Gegentest
+using GnssPins = HeltecV4::Gnss;
+using GnssPinsB = HeltecV4::GnssSwapped;
+using GnssRst = FastPin<GnssPins::rst>;
+using GnssWake = FastPin<GnssPins::wake>;
+using GnssCtrl = FastPin<GnssPins::ctrl>;
 
 void pulseReset() {
-  pinMode(GNSS_RST, OUTPUT);
-  digitalWrite(GNSS_RST, LOW);
+  GnssRst::output();
+  GnssRst::low();
   delay(80);
-  digitalWrite(GNSS_RST, HIGH);
+  GnssRst::high();
   delay(500);
 }
 
 void setWake(bool level) {
-  pinMode(GNSS_WAKE, OUTPUT);
-  digitalWrite(GNSS_WAKE, level ? HIGH : LOW);
+  GnssWake::output();
+  GnssWake::write(level);
   delay(200);
 }
 
 void setGnssPower(bool level) {
-  pinMode(VGNSS_CTRL, OUTPUT);
-  digitalWrite(VGNSS_CTRL, level ? HIGH : LOW);
+  GnssCtrl::output();
+  GnssCtrl::write(level);
   delay(300);
 }
 
+#if BULK_DUMP
+// --- buffered dump: block reads, one Serial.write per 16-byte line ---
+
+static const char kHex[] = "0123456789ABCDEF";
+
+// "XX " x16 + ' ' + 16 ASCII + "\r\n"
+static char lineBuf[16 * 3 + 1 + 16 + 2];
+
+static volatile uint32_t fifoOverflows = 0;
+static volatile uint32_t bufferFull = 0;
+static volatile uint32_t lineErrors = 0;
+
+void onUartError(hardwareSerial_error_t err) {
+  switch (err) {
+    case UART_FIFO_OVF_ERROR:    fifoOverflows++; break;
+    case UART_BUFFER_FULL_ERROR: bufferFull++; break;
+    case UART_BREAK_ERROR:
+    case UART_FRAME_ERROR:
+    case UART_PARITY_ERROR:      lineErrors++; break;
+    default: break;
+  }
+}
+
+// formats up to 16 bytes as one hex + ASCII line
+size_t formatLine(const uint8_t* b, size_t n) {
+  char* p = lineBuf;
+  for (size_t i = 0; i < 16; i++) {
+    if (i < n) {
+      *p++ = kHex[b[i] >> 4];
+      *p++ = kHex[b[i] & 0x0F];
+    } else {
+      *p++ = ' ';
+      *p++ = ' ';
+    }
+    *p++ = ' ';
+  }
+  *p++ = ' ';
+  for (size_t i = 0; i < n; i++) {
+    // ASCII daneben (druckbare Zeichen)
+    *p++ = (b[i] >= 32 && b[i] <= 126) ? (char)b[i] : '.';
+  }
+  *p++ = '\r';
+  *p++ = '\n';
+  return (size_t)(p - lineBuf);
+}
+
+void dumpForMs(uint32_t ms) {
+  uint32_t endAt = millis() + ms;
+  uint32_t cnt = 0;
+  uint8_t block[256];
+  uint8_t pending[16];
+  size_t npending = 0;
+
+  fifoOverflows = bufferFull = lineErrors = 0;
+
+  while (millis() < endAt) {
+    size_t avail = Serial1.available();
+    if (!avail) {
+      delay(1);
+      continue;
+    }
+    size_t n = Serial1.read(block, avail < sizeof(block) ? avail : sizeof(block));
+    cnt += n;
+
+    for (size_t i = 0; i < n; i++) {
+      pending[npending++] = block[i];
+      if (npending == 16) {
+        Serial.write((const uint8_t*)lineBuf, formatLine(pending, 16));
+        npending = 0;
+      }
+    }
+  }
+  if (npending) Serial.write((const uint8_t*)lineBuf, formatLine(pending, npending));
+
+  Serial.print("bytes read: ");
+  Serial.println(cnt);
+  Serial.print("fifo overflows: ");
+  Serial.print(fifoOverflows);
+  Serial.print("  rx buffer full: ");
+  Serial.print(bufferFull);
+  Serial.print("  line errors: ");
+  Serial.println(lineErrors);
+  if (fifoOverflows || bufferFull) Serial.println("WARNING: bytes were lost, count is a lower bound");
+}
+#else
 void dumpForMs(uint32_t ms) {
   uint32_t endAt = millis() + ms;
   uint32_t cnt = 0;
@@ -105,6 +201,7 @@ void dumpForMs(uint32_t ms) {
   Serial.print("bytes read: ");
   Serial.println(cnt);
 }
+#endif
 
 void tryCombo(const char* name, int rx, int tx, int baud) {
   Serial.println("--------------------------------");
@@ -118,18 +215,66 @@ void tryCombo(const char* name, int rx, int tx, int baud) {
 
   Serial1.end();
   delay(50);
+#if BULK_DUMP
+  Serial1.setRxBufferSize(4096);   // ~350 ms at 115200 while the console catches up
+  Serial1.onReceiveError(onUartError);
+#endif
   Serial1.begin(baud, SERIAL_8N1, rx, tx);
   delay(200);
 
   dumpForMs(3000);
 }
 
-void setup() {
-  Serial.begin(115200);
-  delay(300);
+void printConfig(const GnssPortConfig& cfg) {
+  Serial.print("POWER=");
+  Serial.print(cfg.powerLevel ? "HIGH" : "LOW");
+  Serial.print("  WAKE=");
+  Serial.print(cfg.wakeLevel ? "HIGH" : "LOW");
+  Serial.print("  rx=");
+  Serial.print(cfg.rxPin);
+  Serial.print(" tx=");
+  Serial.print(cfg.txPin);
+  Serial.print(" baud=");
+  Serial.print(cfg.baud);
+  Serial.print(" proto=");
+  if (cfg.protocols & GNSS_PROTO_NMEA) Serial.print("NMEA ");
+  if (cfg.protocols & GNSS_PROTO_UBX) Serial.print("UBX");
+  Serial.println();
+}
 
-  Serial.println("GNSS bring-up debug");
+// saved config or auto-detect; returns false if neither found the module
+bool findGnss(GnssPortConfig& cfg) {
+  static const GnssAutoDetect::PinPair pins[] = {
+    GnssAutoDetect::pinsOf<GnssPins>(), GnssAutoDetect::pinsOf<GnssPinsB>()
+  };
+  GnssAutoDetect detector = GnssAutoDetect::forBoard<GnssPins>();
 
+  if (FORGET_SAVED_CONFIG) GnssAutoDetect::forget();
+
+  uint32_t t0 = millis();
+  bool found = false;
+  if (GnssAutoDetect::loadSaved(cfg) && detector.verify(cfg, 2500)) {
+    Serial.print("saved config verified in ");
+    found = true;
+  } else {
+    GnssAutoDetect::Options opt;
+    opt.pins = pins;
+    opt.pinCount = 2;
+    if (detector.detect(cfg, opt)) {
+      Serial.print("detected and saved in ");
+      found = true;
+    }
+  }
+  detector.end();   // hand UART1 back to Serial1
+
+  if (!found) return false;
+  Serial.print(millis() - t0);
+  Serial.println(" ms");
+  printConfig(cfg);
+  return true;
+}
+
+void fullSweep() {
   // Test alle Kombinationen kurz:
   for (int p = 0; p < 2; p++) {            // power HIGH/LOW
     for (int w = 0; w < 2; w++) {          // wake HIGH/LOW
@@ -146,16 +291,32 @@ void setup() {
       pulseReset();
 
       // Pins A
-      tryCombo("PinsA", RXA, TXA, 9600);
-      tryCombo("PinsA", RXA, TXA, 38400);
-      tryCombo("PinsA", RXA, TXA, 115200);
+      tryCombo("PinsA", GnssPins::rx, GnssPins::tx, 9600);
+      tryCombo("PinsA", GnssPins::rx, GnssPins::tx, 38400);
+      tryCombo("PinsA", GnssPins::rx, GnssPins::tx, 115200);
 
       // Pins B (Gegentest)
-      tryCombo("PinsB", RXB, TXB, 9600);
-      tryCombo("PinsB", RXB, TXB, 38400);
-      tryCombo("PinsB", RXB, TXB, 115200);
+      tryCombo("PinsB", GnssPinsB::rx, GnssPinsB::tx, 9600);
+      tryCombo("PinsB", GnssPinsB::rx, GnssPinsB::tx, 38400);
+      tryCombo("PinsB", GnssPinsB::rx, GnssPinsB::tx, 115200);
     }
   }
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(300);
+
+  Serial.println("GNSS bring-up debug");
+
+  GnssPortConfig cfg;
+  if (findGnss(cfg)) {
+    // show a few seconds of data with the found settings
+    tryCombo("Found", cfg.rxPin, cfg.txPin, cfg.baud);
+  } else {
+    Serial.println("auto-detect failed, running full sweep");
+    fullSweep();
+  }
 
   Serial.println("DONE");
 }
@@ -0,0 +1,132 @@
+/**
+ * Fixed-Point Formatting Benchmark
+ *
+ * Compares the snprintf() calls used by the GPSwithOLED status screen with the
+ * integer-only formatters from GnssFormat (lib/GnssCore) on the ESP32-S3.
+ *
+ * What It Does:
+ * - Checks that both paths produce identical strings for 100k random
+ *   coordinates, times and uptimes (exact half-microdegree ties are counted
+ *   separately, see GnssFormat.h)
+ * - Measures the average CPU cycles per call for LAT/LON, HH:MM:SS.cs and
+ *   uptime formatting with esp_cpu_get_cycle_count()
+ * - Prints a results table to Serial (115200 baud) once per run
+ *
+ * Usage:
+ * 1. Upload this sketch to your Heltec V4 board
+ * 2. Open the Serial Monitor at 115200 baud
+ * 3. Press RST to repeat the run
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include <esp_random.h>
+#include "GnssFormat.h"
+
+static const int kSamples = 64;
+static const int kRounds = 200;
+
+static GnssCoord coords[kSamples];
+static volatile uint32_t sink;   // keeps the compiler from dropping the work
+
+static GnssCoord randomCoord(uint16_t maxDeg) {
+  GnssCoord c;
+  c.deg = esp_random() % (maxDeg + 1);
+  c.billionths = esp_random() % 1000000000UL;
+  c.negative = esp_random() & 1;
+  return c;
+}
+
+static double toDouble(const GnssCoord& c) {
+  double v = c.deg + c.billionths / 1000000000.0;
+  return c.negative ? -v : v;
+}
+
+static void verify() {
+  char a[GNSS_FMT_COORD_LEN], b[GNSS_FMT_COORD_LEN];
+  uint32_t mismatches = 0, ties = 0;
+
+  for (uint32_t i = 0; i < 100000; i++) {
+    GnssCoord c = randomCoord(180);
+    formatCoordinate(a, "LON: ", c);
+    snprintf(b, sizeof(b), "LON: %.6f", toDouble(c));
+    if (strcmp(a, b) != 0) {
+      if (c.billionths % 1000 == 500) ties++;
+      else mismatches++;
+    }
+
+    uint8_t h = i % 24, m = i % 60, s = (i / 60) % 60, cs = i % 100;
+    formatTime(a, h, m, s, cs);
+    snprintf(b, sizeof(b), "%02d:%02d:%02d.%02d", (int)h, (int)m, (int)s, (int)cs);
+    if (strcmp(a, b) != 0) mismatches++;
+
+    uint32_t up = esp_random() >> (i % 32);
+    formatUptime(a, up);
+    snprintf(b, sizeof(b), "%lus", (unsigned long)up);
+    if (strcmp(a, b) != 0) mismatches++;
+  }
+
+  Serial.printf("verify: %lu mismatches, %lu half-microdegree ties\n",
+                (unsigned long)mismatches, (unsigned long)ties);
+}
+
+// average cycles per call of fn(i) over kRounds * kSamples calls
+template <typename Fn>
+static uint32_t cyclesPerCall(Fn fn) {
+  uint32_t start = esp_cpu_get_cycle_count();
+  for (int r = 0; r < kRounds; r++) {
+    for (int i = 0; i < kSamples; i++) sink += fn(i);
+  }
+  return (esp_cpu_get_cycle_count() - start) / (kRounds * kSamples);
+}
+
+static void report(const char* what, uint32_t printfCycles, uint32_t fixedCycles) {
+  Serial.printf("%-10s %9lu %9lu %7.1fx\n", what,
+                (unsigned long)printfCycles, (unsigned long)fixedCycles,
+                fixedCycles ? (double)printfCycles / fixedCycles : 0.0);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(500);
+  Serial.println("GnssFormat benchmark");
+
+  for (int i = 0; i < kSamples; i++) coords[i] = randomCoord(90);
+  verify();
+
+  char buf[GNSS_FMT_COORD_LEN];
+  uint32_t pc, fc;
+
+  Serial.println("format     snprintf     fixed  speedup   (cycles/call @ 240 MHz)");
+
+  pc = cyclesPerCall([&](int i) {
+    return snprintf(buf, sizeof(buf), "LAT: %.6f", toDouble(coords[i]));
+  });
+  fc = cyclesPerCall([&](int i) {
+    return (int)formatCoordinate(buf, "LAT: ", coords[i]);
+  });
+  report("lat/lon", pc, fc);
+
+  pc = cyclesPerCall([&](int i) {
+    return snprintf(buf, sizeof(buf), "%02d:%02d:%02d.%02d", i % 24, i % 60, (i * 7) % 60, i % 100);
+  });
+  fc = cyclesPerCall([&](int i) {
+    return (int)formatTime(buf, i % 24, i % 60, (i * 7) % 60, i % 100);
+  });
+  report("time", pc, fc);
+
+  pc = cyclesPerCall([&](int i) {
+    return snprintf(buf, sizeof(buf), "%lus", (unsigned long)(coords[i].billionths / 10));
+  });
+  fc = cyclesPerCall([&](int i) {
+    return (int)formatUptime(buf, coords[i].billionths / 10);
+  });
+  report("uptime", pc, fc);
+
+  Serial.println("DONE");
+}
+
+void loop() {}
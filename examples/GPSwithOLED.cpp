@@ -7,30 +7,134 @@
  * 
  * Features:
  * - GNSS module initialization and power management
- * - UART serial communication at 9600 baud
+ * - Non-blocking GNSS power-up, overlapped with OLED init
+ * - Event-driven UART ingest at 9600 baud (no busy polling)
+ * - Optional 2/5/10 Hz navigation rate with PPS-based latency report
+ * - Optional light sleep between GNSS bursts (PPS / UART wakeup)
+ * - Optional Kalman smoothing, position redrawn at up to 10 Hz between fixes
+ * - Optional cycle-count instrumentation with a stats page (GNSS_PERF)
+ * - Optional power governor: OLED dimmed / off without activity, a stable
+ *   receiver in backup mode (GNSS_POWER_GOVERNOR)
  * - Real-time position tracking (latitude, longitude)
- * - Time synchronization from GPS signal
+ * - Time synchronization from GPS signal, PPS-disciplined between fixes
  * - OLED display with search progress indicator
  * - Antenna status monitoring (open/shorted detection)
  * - Uptime counter display
  * - Serial output for debugging
  * 
- * Hardware Pins (Heltec V4):
+ * Hardware Pins (Heltec V4, HeltecV4::Gnss / HeltecV4::Oled in HeltecV4Board.h):
  * - GNSS RX: GPIO 39 (receives data from GPS module)
  * - GNSS TX: GPIO 38 (sends commands to GPS module)
  * - GNSS RST: GPIO 42 (GPS reset pin)
  * - GNSS WAKE: GPIO 40 (GPS wake pin)
  * - VGNSS_CTRL: GPIO 34 (GPS power control, active LOW)
- * - OLED: I2C with predefined SDA_OLED, SCL_OLED, RST_OLED pins
+ * - GNSS PPS: GPIO 41 (pulse per second: timebase, latency measurement)
+ * - OLED: I2C on the HeltecV4::Oled pins (SDA 17, SCL 18, RST 21)
  * 
  * Required Libraries:
  * - Heltec ESP32 Dev-Boards (for OLED and board support)
  * - TinyGPS++ (for GPS data parsing)
+ * - GnssCore, HeltecV4 (from this repository's lib/ folder)
+ *
+ * GNSS Ingest:
+ * - UART1 is driven by the ESP-IDF driver instead of Serial1 (see GnssUart)
+ * - A FreeRTOS task moves RX chunks (FIFO threshold or idle line) into a ring
+ * - loop() sleeps until a chunk arrives or the next UI refresh is due
+ * - NmeaFramer frames and checksums sentences in place inside the ring;
+ *   TinyGPS++ gets every valid sentence, antenna status only sees TXT
  * 
+ * UBX Mode (GNSS_USE_UBX 1, u-blox receivers):
+ * - Default NMEA output is disabled, the UART is raised to GNSS_UBX_BAUD
+ * - Only UBX-NAV-PVT (+ MON-HW for the antenna) is sent, ~5x fewer bytes
+ * - NAV-PVT is decoded by memcpy into a packed struct instead of TinyGPS++
+ *
+ * Navigation Rate (GNSS_NAV_RATE_HZ > 1, u-blox receivers):
+ * - CFG-PRT raises the baud rate to carry the rate (gnssBaudForRate), then
+ *   CFG-RATE sets the measurement period
+ * - One snapshot is published per epoch, the render task always draws the
+ *   newest one and skips what it could not keep up with
+ * - Every GNSS_REPORT_MS Serial shows PPS -> fix latency (min/avg/max),
+ *   missed epochs, rendered/published frames and UART overruns
+ *
+ * Timebase:
+ * - PpsTimebase timestamps every PPS edge and ties it to the UTC second of
+ *   the next fix; gnssTime.utcMicros() is then valid at any moment, without
+ *   parser latency, and keeps running (drift compensated) if PPS drops out
+ * - The clock on screen is read from the timebase at draw time once locked
+ *
+ * Smoothing (GNSS_SMOOTH_HZ > 0):
+ * - The render task runs every published record through a constant-velocity
+ *   Kalman filter (PositionFilterF) and draws its prediction for the
+ *   current PPS time, GNSS_SMOOTH_HZ times per second
+ * - Noisy fixes are averaged and outliers rejected, a moving receiver moves
+ *   smoothly on screen instead of jumping once per epoch
+ * - Needs the PPS timebase (locked) and a fix with date; Serial still logs
+ *   once per epoch. Not useful together with GNSS_LIGHT_SLEEP
+ *
+ * Geofence (GNSS_GEOFENCE 1):
+ * - loop() evaluates every new fix against the zones of the "geofence"
+ *   flash partition (Geofence + PartitionGeofence, a bounded number of
+ *   shape tests per fix through a grid index)
+ * - Enter / exit transitions are logged to Serial; while inside a zone the
+ *   top-right status shows its name instead of "ANT OK" (an open antenna
+ *   still wins)
+ * - Without a zone partition a GEOFENCE_DEMO_RADIUS_M circle "HOME" is
+ *   placed at the first fix
+ *
+ * Power Governor (GNSS_POWER_GOVERNOR 1, u-blox receivers, see PowerGovernor.h):
+ * - Without activity (PRG button, any Serial input, moving faster than
+ *   walking pace) the OLED dims after OLED_DIM_S and goes dark after
+ *   OLED_OFF_S (SSD1306 display off); loop() then skips the idle refresh,
+ *   nothing is drawn or sent over I2C, Serial still logs every epoch
+ * - Good fixes (3D or NMEA with the type unknown, >= 6 satellites,
+ *   HDOP <= 2) within GNSS_STABLE_RADIUS_M for GNSS_STABLE_S put the
+ *   receiver into backup (CFG-CFG to BBR, then RXM-PMREQ) with VGNSS_CTRL
+ *   on, so it resumes with a hot start; every GNSS_BACKUP_S a check fix
+ *   shows whether it moved
+ * - Vext (OLED and active antenna) goes off while the panel is dark and
+ *   the receiver in backup; the panel gets a fresh init when it lights up
+ * - A press on a dim or dark panel only wakes it (and the receiver); the
+ *   report shows the states and the estimated current saved
+ *
+ * Light Sleep (GNSS_LIGHT_SLEEP 1):
+ * - Once the epoch's final sentence is parsed (learned by NmeaFramer from
+ *   the gaps between bursts, NAV-PVT in UBX mode) and the render task has
+ *   flushed the frame, the chip enters light sleep (see GnssLightSleep)
+ * - Wakeup on PPS (GPIO 41 high), UART RX on GNSS_RX or a timer for the
+ *   next UI refresh / the next epoch between PPS edges at > 1 Hz
+ * - The report shows the share of time asleep and the wake-up sources
+ *
+ * Instrumentation (GNSS_PERF 1, see PerfStats.h):
+ * - min/avg/max and a log2 histogram of the parse, publish, render, flush
+ *   and loop-iteration times; the GnssUart ingest task is timed as well
+ *   when GNSS_PERF=1 is passed as a build flag
+ * - the PRG button (GPIO 0) or 'p' on Serial toggles a second OLED page
+ *   with the averages/maxima, UART overruns and checksum errors
+ * - 's' on Serial dumps every timer and counter with percentiles,
+ *   'r' resets them
+ * - compiled out (no code, no RAM) with GNSS_PERF 0
+ *
+ * Display Refresh:
+ * - StatusScreen keeps every text field and only redraws the ones that changed
+ * - Only the changed SSD1306 page/column slices are sent over I2C
+ * - Labels and digits come pre-rasterised from a TextCache: a changed
+ *   coordinate is a few column-byte copies, not per-pixel font decoding
+ * - OLED_ASYNC_I2C 1: slices go out as queued i2c_master transactions at
+ *   1 MHz (I2cOledTransport), the render task returns while the bus drains;
+ *   OledBenchmark measures the frame rate at each clock
+ *
+ * Tasks:
+ * - loop() (core 1): GNSS parsing, publishes each epoch as a 16-byte
+ *   FixRecord (1e-7 deg, UTC week-ms, type/satellites/HDOP class, antenna)
+ * - render task (core 0): expands the record, draws and flushes the OLED
+ * - the two meet on a lock-free FixBus (seqlock latest slot), nobody waits
+ *   for I2C; a logger or radio task can subscribe to its own ring of every
+ *   epoch without touching TinyGPS++
+ *
  * Display Output:
  * - Searching state: "Searching GPS ..." with progress bar
  * - Locked state: Time (HH:MM:SS.CS), Latitude, Longitude
- * - Top right: Antenna status (ANT OK / ANT OPEN)
+ * - Top right: Antenna status (ANT OK / ANT OPEN) or the geofence zone
  * - Bottom right: Device uptime in seconds
  * 
  * Author: Paul Marx
@@ -42,161 +146,896 @@
 #include "HT_TinyGPS++.h"
 #include <Wire.h>
 #include "HT_SSD1306Wire.h"
+#include "GnssUart.h"
+#include "GnssPower.h"
+#include "GnssAutoDetect.h"
+#include "NmeaFramer.h"
+#include "StatusScreen.h"
+#include "GnssFix.h"
+#include "FixRecord.h"
+#include "GnssFormat.h"
+#include "FixBus.h"
+#include "Ubx.h"
+#include "UbxConfig.h"
+#include "PpsTimebase.h"
+#include "PositionFilter.h"
+#include "Geofence.h"
+#include "GnssLatency.h"
+#include "GnssLightSleep.h"
+#include "HeltecV4Board.h"
 
-TinyGPSPlus GPS;
+// 1 = switch a u-blox receiver to binary UBX-NAV-PVT only (see UbxConfig.h)
+#define GNSS_USE_UBX  0
+#define GNSS_UBX_BAUD 38400
+
+// navigation solutions per second (1, 2, 5 or 10)
+#define GNSS_NAV_RATE_HZ 1
+#define GNSS_EPOCH_MS    (1000 / GNSS_NAV_RATE_HZ)
+#define GNSS_REPORT_MS   10000   // latency / keep-up report, 0 = off
+
+// redraw without new data (uptime, search bar)
+#define UI_IDLE_REFRESH_MS 1000
+
+// > 0 = draw the Kalman-smoothed position this many times per second
+#define GNSS_SMOOTH_HZ 0
+
+// 1 = evaluate each fix against geofence zones, zone name in the status line
+#define GNSS_GEOFENCE          0
+#define GEOFENCE_DEMO_RADIUS_M 30   // zone at the first fix if no partition
+#if GNSS_GEOFENCE
+#include "PartitionGeofence.h"
+#endif
+
+// 1 = dim / blank the OLED without activity and put the receiver into
+// backup while the position is stable (PowerGovernor)
+#define GNSS_POWER_GOVERNOR  0
+#define OLED_DIM_S           30    // no activity: lowest contrast
+#define OLED_OFF_S           120   // no activity: display off
+#define GNSS_STABLE_S        60    // good fixes this long ...
+#define GNSS_STABLE_RADIUS_M 15    // ... within this radius: receiver to backup
+#define GNSS_BACKUP_S        300   // backup this long, then a hot-start check fix
+#if GNSS_POWER_GOVERNOR
+#include "PowerGovernor.h"
+#endif
+
+// 1 = OLED on the IDF i2c_master driver at OLED_I2C_HZ, page slices queued
+// asynchronously (I2cOledTransport); 0 = blocking Wire at 500 kHz
+#define OLED_ASYNC_I2C 0
+#define OLED_I2C_HZ    1000000
+#if OLED_ASYNC_I2C
+#include "I2cOledTransport.h"
+#endif
+
+// 1 = light sleep between the receiver's bursts
+#define GNSS_LIGHT_SLEEP  0
+#define GNSS_IDLE_GAP_MS  (GNSS_EPOCH_MS / 5)   // quiet line = burst over (epoch end learning)
+
+// 1 = stage timers, stats page and Serial dump (a -DGNSS_PERF=1 build flag
+// overrides this and also instruments the libraries)
+#ifndef GNSS_PERF
+#define GNSS_PERF 0
+#endif
+#include "PerfStats.h"
+
+// every pin comes from HeltecV4Board.h; the PRG button toggles the stats page
+using Board = HeltecV4;
+using GnssPins = Board::Gnss;
+using OledPins = Board::Oled;
+static FastPin<Board::vext, Board::vextActiveLow> vext;
 
-// UART Pins (final bestätigt)
-#define GNSS_RX 39   // ESP32 RX <- GNSS_TX
-#define GNSS_TX 38   // ESP32 TX -> GNSS_RX
+PERF_TIMER(perfParse, "parse");       // framer + TinyGPS++ / UBX per loop pass
+PERF_TIMER(perfPublish, "publish");   // snapshot + fix bus
+PERF_TIMER(perfRender, "render");     // formatting + StatusScreen fields
+PERF_TIMER(perfFlush, "flush");       // rasterise + I2C (only queuing with OLED_ASYNC_I2C)
+PERF_TIMER(perfLoop, "loop");         // busy part of one loop() pass
+PERF_COUNTER(perfIdleRefresh, "idle refresh");
 
-// Power/Control (final bestätigt)
-#define VGNSS_CTRL 34   // active LOW
-#define GNSS_WAKE  40   // active HIGH
-#define GNSS_RST   42
-#define GNSS_PPS   41   // optional
+TinyGPSPlus GPS;
+
+static StaticByteRing<2048> gnssRing;
+static GnssUart gnssUart;
+static NmeaFramer gnssFramer;
+static GnssPowerSequencer gnssPower;
+static PpsTimebase gnssTime;     // PPS-disciplined UTC, see utcMicros()
+static GnssLatency gnssLatency;
+#if GNSS_LIGHT_SLEEP
+static GnssLightSleep lightSleep;
+#endif
 
 bool antennaOpen = false;
 uint32_t lastAntennaMsg = 0;
 
-static SSD1306Wire display(0x3c, 500000, SDA_OLED, SCL_OLED, GEOMETRY_128_64, RST_OLED);
+// loop() (core 1) -> render task (core 0)
+static FixBus<FixRecord, 4, 16> fixBus;
+#if GNSS_SMOOTH_HZ
+static PositionFilterF smoother;   // render task only
+#endif
+#if GNSS_GEOFENCE
+static Geofence fence;                      // loop() only
+static PartitionGeofence fencePartition;
+static uint32_t demoFenceBlob[32];          // one circle, if no partition
+static volatile int16_t fenceZone = -1;     // zone for the status line (render task reads)
+#endif
+#if GNSS_POWER_GOVERNOR
+static PowerGovernor::Config governorConfig() {
+  PowerGovernor::Config c;
+  c.dimS = OLED_DIM_S;
+  c.offS = OLED_OFF_S;
+  c.stableS = GNSS_STABLE_S;
+  c.stableRadiusMm = GNSS_STABLE_RADIUS_M * 1000UL;
+  c.backupS = GNSS_BACKUP_S;
+  return c;
+}
+static PowerGovernor governor(governorConfig());   // loop() only
+// loop() -> render task: what the panel and Vext should do
+static volatile uint8_t panelTarget = PowerGovernor::DISPLAY_ON;
+static volatile bool antennaTarget = true;          // receiver tracking: the antenna needs Vext
+static volatile uint32_t buttonPresses = 0;         // PRG interrupt -> loop()
+#endif
+static TaskHandle_t renderTaskHandle = nullptr;
+static TaskHandle_t loopTaskHandle = nullptr;
+static volatile uint32_t fixesPublished = 0;
+static volatile uint32_t framesRendered = 0;
+static volatile uint32_t framesFlushed = 0;   // fixesPublished as of the last flush
+static uint32_t lastUi = 0;
 
-void VextON()  { pinMode(Vext, OUTPUT); digitalWrite(Vext, LOW); }
-void VextOFF() { pinMode(Vext, OUTPUT); digitalWrite(Vext, HIGH); }
+static SSD1306Wire display(OledPins::address, 500000, OledPins::sda, OledPins::scl,
+                           GEOMETRY_128_64, OledPins::rst);
+#if OLED_ASYNC_I2C
+static I2cOledTransport oledLink;
+#else
+static WireOledTransport oledLink(OledPins::address);
+#endif
+static StatusScreen screen(display, oledLink);
 
-static void gnssPowerOn() {
-  pinMode(VGNSS_CTRL, OUTPUT);
-  digitalWrite(VGNSS_CTRL, LOW);     // ON
+// labels and glyphs of the fix page, rasterised once in setupScreen()
+static const char* const kScreenLabels[] = {
+  "LAT: ", "LON: ", "Searching GPS ...", "ANT OK", "ANT OPEN"
+};
+static TextCache textCache;
 
-  pinMode(GNSS_WAKE, OUTPUT);
-  digitalWrite(GNSS_WAKE, HIGH);     // WAKE
+// screen layout (fields may overlap, only one layout is visible at a time)
+static int8_t searchField, progressField;
+static int8_t timeField, latField, lonField;
+static int8_t antennaField, uptimeField;
+#if GNSS_PERF
+static const uint8_t kStatsLines = 5;
+static int8_t statsFields[kStatsLines];
+static volatile bool statsPage = false;
+#endif
 
-  pinMode(GNSS_RST, OUTPUT);
-  digitalWrite(GNSS_RST, HIGH);
-  delay(200);
+static void setupScreen() {
+  // renders with the current font and clears the framebuffer
+  if (!textCache.build(display, "0123456789:.-s", kScreenLabels,
+                       sizeof(kScreenLabels) / sizeof(kScreenLabels[0]))) {
+    Serial.println("text cache full");
+  }
+  screen.setTextCache(&textCache);
 
-  // Reset pulse
-  digitalWrite(GNSS_RST, LOW);
-  delay(50);
-  digitalWrite(GNSS_RST, HIGH);
-  delay(500);
+  searchField   = screen.addText(0, 10, 100);
+  progressField = screen.addBar(0, 32, 120, 10);
+  timeField     = screen.addText(0, 0, 76);
+  latField      = screen.addText(0, 12, 100);
+  lonField      = screen.addText(0, 24, 100);
+  antennaField  = screen.addText(127, 0, 50, StatusScreen::AlignRight);
+  uptimeField   = screen.addText(127, 54, 40, StatusScreen::AlignRight);
+#if GNSS_PERF
+  for (uint8_t i = 0; i < kStatsLines; i++) statsFields[i] = screen.addText(0, i * 12, 128);
+#endif
 }
 
-void setup() {
-  Serial.begin(115200);
-  delay(200);
-  Serial.println("Program started. Setting up...");
+void VextON()  { vext.output(); vext.on(); }
+void VextOFF() { vext.output(); vext.off(); }
 
-  // OLED
-  VextON();
-  delay(100);
+#define VEXT_SETTLE_MS 10   // OLED supply ramp before the panel init
+
+// SSD1306 init after Vext came up (setup, or the rail was off)
+static void initPanel() {
+#if OLED_ASYNC_I2C
+  // SSD1306Wire only draws; the transport owns the bus and inits the panel
+  I2cOledTransport::Config oledCfg;
+  oledCfg.clockHz = OLED_I2C_HZ;
+  if (!oledLink.begin(oledCfg)) Serial.println("OLED i2c_master init failed");
+#else
   display.init();
-  display.setFont(ArialMT_Plain_10);
-  display.setTextAlignment(TEXT_ALIGN_LEFT);
-  display.clear();
-  display.drawString(0, 0, "Initializing ...");
-  display.display();
+#endif
+}
 
-  // GNSS
-  gnssPowerOn();
-  Serial1.begin(9600, SERIAL_8N1, GNSS_RX, GNSS_TX);
-  Serial.println("GNSS UART started @9600");
+// every checksum-valid sentence goes to TinyGPS++
+static void feedTinyGps(const NmeaSentence& s, void*) {
+  gnssPower.dataSeen();
+  for (size_t i = 0; i < s.size(); i++) GPS.encode(s.at(i));
 }
 
-void loop() {
-  // --- GNSS input ---
-  while (Serial1.available()) {
-    char c = Serial1.read();
-    GPS.encode(c);
+// $xxTXT,01,01,01,ANTENNA OPEN*25 / ANTENNA OK
+static void onTxtSentence(const NmeaSentence& s, void*) {
+  if (s.contains("ANTENNA")) {
+    antennaOpen = s.contains("OPEN");
+    lastAntennaMsg = millis();
+  }
+}
+
+#if GNSS_USE_UBX
+static UbxParser ubxParser;
+static GnssFix pvtFix = {};
+static bool pvtUpdated = false;
+static bool pvtLast = false;   // NAV-PVT closes the epoch
+static uint32_t pvtSpeedMms = 0;   // ground speed
+
+// UBX frames found between sentences by the framer
+static void feedUbx(const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, void*) {
+  ubxParser.feed(p1, n1);
+  ubxParser.feed(p2, n2);
+}
+
+// NAV-PVT fills the fix fields, MON-HW replaces the antenna TXT sentence
+static void onUbxFrame(const UbxFrame& f, void*) {
+  UbxNavPvt pvt;
+  GnssAntenna ant;
+  if (ubxDecodeNavPvt(f, pvt)) {
+    gnssPower.dataSeen();
+    ubxNavPvtToFix(pvt, pvtFix);
+    pvtSpeedMms = pvt.gSpeed > 0 ? (uint32_t)pvt.gSpeed : 0;
+    pvtUpdated = true;
+    pvtLast = true;
+    return;
+  }
+  pvtLast = false;
+  if (ubxDecodeAntenna(f, ant) && ant != ANTENNA_UNKNOWN) {
+    antennaOpen = ant == ANTENNA_OPEN;
+    lastAntennaMsg = millis();
+  }
+}
+#endif
+
+#if GNSS_GEOFENCE
+// one evaluation per navigation solution; zone records are read-only, so
+// the render task may read the name of fenceZone
+static void evaluateGeofence(const FixRecord& record) {
+  if (!fence.loaded()) {
+    GeofenceWriter writer(demoFenceBlob, sizeof(demoFenceBlob), 1);
+    writer.addCircle(1, record.lat, record.lon, GEOFENCE_DEMO_RADIUS_M * 1000UL, "HOME");
+    if (!fence.load(demoFenceBlob, writer.finish())) return;
+    Serial.printf("geofence: demo zone HOME, %u m around the first fix\n", GEOFENCE_DEMO_RADIUS_M);
+  }
 
-    // very lightweight GPTXT sniffing (ANTENNA status)
-    static char txtBuf[80];
-    static uint8_t idx = 0;
+  Geofence::Event events[4];
+  uint8_t n = fence.update(record.lat, record.lon, events, 4);
+  for (uint8_t i = 0; i < n; i++) {
+    const GeofenceZone& z = fence.zone(events[i].zone);
+    Serial.printf("geofence: %s %.12s (id %u)\n", events[i].entered ? "enter" : "exit", z.name, z.id);
+  }
+  fenceZone = fence.insideCount() ? (int16_t)fence.inside(0) : -1;
+}
+#endif
+
+#if GNSS_POWER_GOVERNOR
+// ground speed of the newest epoch, mm/s
+static uint32_t gnssSpeedMms() {
+#if GNSS_USE_UBX
+  return pvtSpeedMms;
+#else
+  return GPS.speed.isValid() ? (uint32_t)(GPS.speed.mps() * 1000) : 0;
+#endif
+}
+#endif
+
+// packs the parser state into a FixRecord and wakes the render task;
+// newEpoch = a fresh navigation solution (not an idle refresh)
+static void publishFix(bool newEpoch) {
+  GnssFix fix = {};
+#if GNSS_USE_UBX
+  fix = pvtFix;
+#else
+  fix.timeValid = GPS.time.isValid();
+  fix.locationValid = GPS.location.isValid();
+
+  fix.hour = GPS.time.hour();
+  fix.minute = GPS.time.minute();
+  fix.second = GPS.time.second();
+  fix.centisecond = GPS.time.centisecond();
+
+  fix.dateValid = GPS.date.isValid();
+  fix.year = GPS.date.year();
+  fix.month = GPS.date.month();
+  fix.day = GPS.date.day();
+
+  const RawDegrees& lat = GPS.location.rawLat();
+  const RawDegrees& lon = GPS.location.rawLng();
+  fix.lat = { lat.deg, lat.billionths, lat.negative };
+  fix.lon = { lon.deg, lon.billionths, lon.negative };
+
+  fix.satellites = GPS.satellites.isValid() ? (uint8_t)GPS.satellites.value() : 0;
+  fix.hdop = GPS.hdop.isValid() ? (uint16_t)GPS.hdop.value() : 0;
+#endif
+
+  if (millis() - lastAntennaMsg < 5000) {
+    fix.antenna = antennaOpen ? ANTENNA_OPEN : ANTENNA_OK;
+  }
+
+  if (newEpoch) {
+    gnssTime.tie(fix);
+    gnssLatency.fixAvailable(fix);
+  }
+  FixRecord record;
+  fixRecordFromFix(fix, record);
+#if GNSS_GEOFENCE
+  if (newEpoch && fix.locationValid) evaluateGeofence(record);
+#endif
+#if GNSS_POWER_GOVERNOR
+  if (newEpoch) governor.fix(millis(), record, gnssSpeedMms());
+#endif
+  fixBus.publish(record);
+  // counted after publishing: a render pass that saw the count also sees the fix
+  fixesPublished++;
+  if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+}
+
+// draws one snapshot into the back buffer; StatusScreen sends the changes,
+// logs it to Serial if it is a new one
+static void renderFix(const GnssFix& fix, bool log) {
+#if GNSS_PERF
+  for (uint8_t i = 0; i < kStatsLines; i++) screen.hide(statsFields[i]);
+#endif
 
-    if (c == '$') {
-      idx = 0;
+  if (!fix.timeValid && !fix.locationValid) {
+    static int counter = 0;
+    int progress = (counter / 5) % 100;
+    counter++;
+
+    screen.hide(timeField);
+    screen.hide(latField);
+    screen.hide(lonField);
+    screen.setText(searchField, "Searching GPS ...");
+    screen.setBar(progressField, progress);
+  } else {
+    char t[GNSS_FMT_TIME_LEN], la[GNSS_FMT_COORD_LEN], lo[GNSS_FMT_COORD_LEN];
+
+    // integer formatting, same output as the former snprintf("%.6f") calls
+    if (gnssTime.locked()) {
+      // current UTC instead of the epoch the snapshot was decoded from
+      uint32_t cs = (uint32_t)(gnssTime.utcMicros() % 86400000000LL / 10000);
+      formatTime(t, cs / 360000, cs / 6000 % 60, cs / 100 % 60, cs % 100);
+    } else if (fix.timeValid) {
+      formatTime(t, fix.hour, fix.minute, fix.second, fix.centisecond);
+    } else {
+      strcpy(t, "--:--:--.--");
     }
-    if (idx < sizeof(txtBuf) - 1) {
-      txtBuf[idx++] = c;
-      txtBuf[idx] = 0;
+
+    if (fix.locationValid) {
+      formatCoordinate(la, "LAT: ", fix.lat);
+      formatCoordinate(lo, "LON: ", fix.lon);
+    } else {
+      strcpy(la, "LAT: ----");
+      strcpy(lo, "LON: ----");
     }
 
-    if (c == '\n') {
-      if (strstr(txtBuf, "ANTENNA")) {
-        antennaOpen = strstr(txtBuf, "OPEN");
-        lastAntennaMsg = millis();
-      }
-      idx = 0;
+    // Serial
+    if (log) {
+      Serial.println(t);
+      Serial.println(la);
+      Serial.println(lo);
     }
+
+    // OLED
+    screen.hide(searchField);
+    screen.hide(progressField);
+    screen.setText(timeField, t);
+    screen.setText(latField, la);
+    screen.setText(lonField, lo);
   }
 
-  // --- UI update logic ---
-  static uint32_t lastUi = 0;
-  bool gpsUpdated =
-      GPS.location.isUpdated() ||
-      GPS.time.isUpdated();
+  // --- Antenna status (top right) ---
+#if GNSS_GEOFENCE
+  int16_t zone = fenceZone;
+  if (fix.antenna != ANTENNA_OPEN && zone >= 0) {
+    char name[9];   // what fits the field
+    snprintf(name, sizeof(name), "%.8s", fence.zone(zone).name);
+    screen.setText(antennaField, name);
+  } else
+#endif
+  if (fix.antenna != ANTENNA_UNKNOWN) {
+    screen.setText(antennaField, fix.antenna == ANTENNA_OPEN ? "ANT OPEN" : "ANT OK");
+  } else {
+    screen.hide(antennaField);
+  }
 
-  // refresh if new GPS data OR once per second
-  if (gpsUpdated || millis() - lastUi >= 1000) {
-    lastUi = millis();
+  // --- Uptime footer ---
+  char up[GNSS_FMT_UPTIME_LEN];
+  formatUptime(up, millis() / 1000);
+  screen.setText(uptimeField, up);
+}
 
-    display.clear();
+#if GNSS_PERF
+// second page: where the time goes, in us at the current CPU clock
+static void renderStats() {
+  screen.hide(searchField);
+  screen.hide(progressField);
+  screen.hide(timeField);
+  screen.hide(latField);
+  screen.hide(lonField);
+  screen.hide(antennaField);
+  screen.hide(uptimeField);
+
+  uint32_t mhz = getCpuFrequencyMhz();
+  const PerfTimer* rows[kStatsLines - 1] = { &perfParse, &perfRender, &perfFlush, &perfLoop };
+  char line[StatusScreen::kTextMax];
+  for (uint8_t i = 0; i < kStatsLines - 1; i++) {
+    snprintf(line, sizeof(line), "%-7s%5lu /%6lu us", rows[i]->name(),
+             (unsigned long)(rows[i]->avg() / mhz), (unsigned long)(rows[i]->max() / mhz));
+    screen.setText(statsFields[i], line);
+  }
 
-    bool hasTime = GPS.time.isValid();
-    bool hasLoc  = GPS.location.isValid();
+  const GnssUart::Counters& uc = gnssUart.counters();
+  snprintf(line, sizeof(line), "ovf %lu drop %lu cs %lu",
+           (unsigned long)(uc.fifoOverflows + uc.driverFull), (unsigned long)uc.ringDropped,
+           (unsigned long)gnssFramer.counters().checksumErrors);
+  screen.setText(statsFields[kStatsLines - 1], line);
+}
+
+// every timer and counter, with histogram percentiles
+static void dumpPerf() {
+  float mhz = getCpuFrequencyMhz();
+  Serial.println("timer           count     min     avg     p50     p99     max  (us)");
+  for (const PerfTimer* t = PerfTimer::first(); t; t = t->next()) {
+    Serial.printf("%-12s %8lu %7.1f %7.1f %7.1f %7.1f %7.1f\n", t->name(), (unsigned long)t->count(),
+                  t->min() / mhz, t->avg() / mhz, t->percentile(50) / mhz,
+                  t->percentile(99) / mhz, t->max() / mhz);
+  }
+  for (const PerfCounter* c = PerfCounter::first(); c; c = c->next()) {
+    Serial.printf("%-12s %8lu\n", c->name(), (unsigned long)c->value());
+  }
+  Serial.printf("text cache: %lu hits, %lu misses, %u bytes\n",
+                (unsigned long)textCache.stats().hits, (unsigned long)textCache.stats().misses,
+                (unsigned)textCache.poolUsed());
+}
+
+static void pollPerfCommands() {
+  while (Serial.available()) {
+    switch (Serial.read()) {
+      case 's': dumpPerf(); break;
+      case 'r': PerfTimer::resetAll(); PerfCounter::resetAll(); Serial.println("perf reset"); break;
+      case 'p':
+        statsPage = !statsPage;
+        if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+        break;
+      default: break;
+    }
+  }
+}
+#endif
 
-    if (!hasTime && !hasLoc) {
-      static int counter = 0;
-      int progress = (counter / 5) % 100;
-      counter++;
+#if GNSS_PERF || GNSS_POWER_GOVERNOR
+static void IRAM_ATTR onPrgButton() {
+  static uint32_t lastMs = 0;
+  uint32_t now = millis();
+  if (now - lastMs < 250) return;   // contact bounce
+  lastMs = now;
 
-      display.setTextAlignment(TEXT_ALIGN_LEFT);
-      display.drawString(0, 10, "Searching GPS ...");
-      display.drawProgressBar(0, 32, 120, 10, progress);
+  BaseType_t woken = pdFALSE;
+#if GNSS_POWER_GOVERNOR
+  // loop() feeds the governor; a press on a dim or dark panel only wakes it
+  buttonPresses++;
+  if (loopTaskHandle) vTaskNotifyGiveFromISR(loopTaskHandle, &woken);
+  bool lit = panelTarget == PowerGovernor::DISPLAY_ON;
+#else
+  bool lit = true;
+#endif
+#if GNSS_PERF
+  if (lit) {
+    statsPage = !statsPage;
+    if (renderTaskHandle) vTaskNotifyGiveFromISR(renderTaskHandle, &woken);
+  }
+#else
+  (void)lit;
+#endif
+  portYIELD_FROM_ISR(woken);
+}
+#endif
+
+#if GNSS_POWER_GOVERNOR
+// render task: brings panel and Vext to what loop() asked for; true if the
+// panel is lit and a flush makes sense
+static bool applyPanelPower() {
+  static const uint8_t kOn[] = { 0x81, 0xCF, 0xAF };    // init contrast, display on
+  static const uint8_t kDim[] = { 0x81, 0x01, 0xAF };   // lowest contrast
+  static const uint8_t kOff[] = { 0xAE };               // panel sleep, RAM kept
+  static uint8_t applied = PowerGovernor::DISPLAY_ON;
+  static bool railOn = true;
+  static bool cold = false;   // the rail was off: the panel forgot its setup and RAM
+
+  uint8_t want = panelTarget;
+  bool rail = want != PowerGovernor::DISPLAY_OFF || antennaTarget;
+  if (rail && !railOn) {
+    VextON();
+    vTaskDelay(pdMS_TO_TICKS(VEXT_SETTLE_MS));
+    railOn = true;
+  }
+  if (cold && want != PowerGovernor::DISPLAY_OFF) {
+    initPanel();
+    screen.invalidate();
+    cold = false;
+    applied = PowerGovernor::DISPLAY_OFF;   // contrast below
+  }
+  if (want != applied) {
+    if (want == PowerGovernor::DISPLAY_ON) oledLink.writeCommands(kOn, sizeof(kOn));
+    else if (want == PowerGovernor::DISPLAY_DIM) oledLink.writeCommands(kDim, sizeof(kDim));
+    else if (railOn) oledLink.writeCommands(kOff, sizeof(kOff));
+    applied = want;
+  }
+  if (!rail && railOn) {
+    oledLink.drain(100);
+    VextOFF();
+    railOn = false;
+    cold = true;
+  }
+  return want != PowerGovernor::DISPLAY_OFF;
+}
+#endif
+
+// owns the display after setup(): formatting and the I2C flush
+// run on core 0, so GNSS parsing on core 1 never waits for the bus
+static void renderTask(void*) {
+  GnssFix fix = {};
+  uint32_t renderedSeq = 0;
+  for (;;) {
+    uint32_t waitMs = UI_IDLE_REFRESH_MS;
+#if GNSS_SMOOTH_HZ
+    if (smoother.valid() && gnssTime.locked()) waitMs = 1000 / GNSS_SMOOTH_HZ;
+#endif
+#if GNSS_POWER_GOVERNOR
+    // a dark panel needs no idle redraws, only what loop() publishes
+    bool dark = panelTarget == PowerGovernor::DISPLAY_OFF;
+    ulTaskNotifyTake(pdTRUE, dark ? portMAX_DELAY : pdMS_TO_TICKS(waitMs));
+    bool lit = applyPanelPower();
+#else
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+    bool lit = true;
+#endif
+    uint32_t published = fixesPublished;
+    // newest record; the previous one stays on screen if nothing new
+    FixRecord record;
+    uint32_t seq;
+    bool fresh = false;
+    if (fixBus.latest(record, &seq) && seq != renderedSeq) {
+      renderedSeq = seq;
+      fixRecordToFix(record, fix);
+#if GNSS_SMOOTH_HZ
+      smoother.update(record);   // idle republishes of the same epoch count as stale
+#endif
+      framesRendered++;
+      fresh = true;
+    }
+
+    GnssFix shown = fix;
+#if GNSS_SMOOTH_HZ
+    // where the receiver is now, not where it was at the last epoch
+    int32_t lat, lon;
+    if (fix.locationValid && gnssTime.locked() && smoother.predict(gnssTime.utcMicros(), lat, lon)) {
+      shown.lat = fixCoordFrom1e7(lat);
+      shown.lon = fixCoordFrom1e7(lon);
+    }
+#endif
+
+    PERF_BEGIN(perfRender);
+#if GNSS_PERF
+    if (statsPage) renderStats();
+    else renderFix(shown, fresh);
+#else
+    renderFix(shown, fresh);
+#endif
+    PERF_END(perfRender);
+
+    // dark: the fields follow the fixes, the panel gets them when it lights up
+    if (lit) {
+      PERF_BEGIN(perfFlush);
+      screen.flush();
+      PERF_END(perfFlush);
+    }
+#if GNSS_LIGHT_SLEEP
+    // the I2C peripheral stops in light sleep: the slices must be out first
+    oledLink.drain(100);
+#endif
+    framesFlushed = published;
+#if GNSS_LIGHT_SLEEP
+    // loop() may be waiting for the flush to go to sleep
+    if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+#endif
+  }
+}
+
+// baud rate and navigation rate, sent once the receiver streams NMEA
+static void configureGnss() {
+  bool ok = true;
+#if GNSS_USE_UBX
+  uint32_t baud = max((uint32_t)GNSS_UBX_BAUD, gnssBaudForRate(GNSS_NAV_RATE_HZ, UBX_EPOCH_BYTES_NAV_PVT));
+  ok = ubxSwitchToNavPvt(gnssUart, baud);
+  Serial.printf("UBX NAV-PVT @%lu %s\n", (unsigned long)baud, ok ? "configured" : "config failed");
+#else
+  if (GNSS_NAV_RATE_HZ == 1) return;   // module defaults
+  uint32_t baud = gnssBaudForRate(GNSS_NAV_RATE_HZ, UBX_EPOCH_BYTES_NMEA);
+  ok = ubxSetPort(gnssUart, baud, UBX_PROTO_NMEA);
+  Serial.printf("GNSS UART @%lu %s\n", (unsigned long)baud, ok ? "configured" : "config failed");
+#endif
+  if (ok && GNSS_NAV_RATE_HZ != 1) {
+    ok = ubxSetNavRate(gnssUart, GNSS_EPOCH_MS);
+    Serial.printf("GNSS rate %d Hz %s\n", GNSS_NAV_RATE_HZ, ok ? "configured" : "config failed");
+  }
+}
+
+// PPS -> fix latency and whether UART, parser and OLED keep up with the rate
+static void reportLatency() {
+  const GnssLatency::Stats& st = gnssLatency.stats();
+  const GnssUart::Counters& uc = gnssUart.counters();
+
+  if (st.epochs) {
+    Serial.printf("latency PPS->fix min/avg/max %lu/%lu/%lu us over %lu epochs\n",
+                  (unsigned long)st.minUs, (unsigned long)st.avgUs(),
+                  (unsigned long)st.maxUs, (unsigned long)st.epochs);
+  } else {
+    Serial.printf("latency: no PPS (%lu edges, %lu fixes)\n",
+                  (unsigned long)gnssTime.stats().edges, (unsigned long)st.noPps);
+  }
+
+  static const char* const kTimeState[] = { "unlocked", "locked", "holdover" };
+  const PpsTimebase::Stats& ts = gnssTime.stats();
+  Serial.printf("timebase %s, drift %ld ppb, last error %ld us, steps %lu, resyncs %lu\n",
+                kTimeState[gnssTime.state()], (long)gnssTime.driftPpb(), (long)ts.lastErrorUs,
+                (unsigned long)ts.steps, (unsigned long)ts.resyncs);
+  Serial.printf("keep-up: missed %lu epochs, rendered %lu/%lu, uart ovf %lu full %lu drop %lu, bad cs %lu\n",
+                (unsigned long)st.missed, (unsigned long)framesRendered, (unsigned long)fixesPublished,
+                (unsigned long)uc.fifoOverflows, (unsigned long)uc.driverFull,
+                (unsigned long)uc.ringDropped, (unsigned long)gnssFramer.counters().checksumErrors);
+#if GNSS_LIGHT_SLEEP
+  const GnssLightSleep::Stats& ss = lightSleep.stats();
+  uint16_t asleep = ss.permilleAsleep();
+  Serial.printf("light sleep %u.%u%%, %lu sleeps, wake pps %lu uart %lu timer %lu, epoch end %s\n",
+                asleep / 10, asleep % 10, (unsigned long)ss.sleeps, (unsigned long)ss.wakePps,
+                (unsigned long)ss.wakeUart, (unsigned long)ss.wakeTimer,
+                GNSS_USE_UBX ? "NAV-PVT" : gnssFramer.epochEndId() ? "learned" : "learning");
+  lightSleep.resetStats();
+#endif
+  gnssLatency.resetStats();
+}
+
+#if GNSS_POWER_GOVERNOR
+// PRG button, Serial input and the governor's timers; loop() owns the
+// receiver, the render task panel and Vext
+static void governPower() {
+  static uint32_t seenPresses = 0;
+  static bool tracking = true;
+  static bool configSaved = false;
+
+  uint32_t presses = buttonPresses;
+  bool active = presses != seenPresses || Serial.available();
+  seenPresses = presses;
+#if !GNSS_PERF
+  while (Serial.available()) Serial.read();   // pollPerfCommands() reads it otherwise
+#endif
+  if (active) governor.activity(millis());
+  if (!governor.update(millis())) return;
+
+  static uint32_t seenFailed = 0;
+  bool track = governor.gnss() == PowerGovernor::GNSS_TRACKING;
+  if (track != tracking) {
+    tracking = track;
+    if (track) {
+      ubxWake(gnssUart);   // VGNSS_CTRL stayed on: hot start
+      // fixes kept coming after the request (no ACK for RXM-PMREQ)
+      bool ignored = governor.stats().backupFailed != seenFailed;
+      Serial.println(ignored ? "GNSS ignored the backup request" : "GNSS resumed (hot start)");
     } else {
-      char t[20], la[24], lo[24];
-
-      if (hasTime) {
-        snprintf(t, sizeof(t), "%02d:%02d:%02d.%02d",
-                 (int)GPS.time.hour(),
-                 (int)GPS.time.minute(),
-                 (int)GPS.time.second(),
-                 (int)GPS.time.centisecond());
+      // a receiver woken from backup restarts with what BBR holds
+      if (!configSaved && (GNSS_USE_UBX || GNSS_NAV_RATE_HZ != 1)) configSaved = ubxSaveToBbr(gnssUart);
+      if (ubxEnterBackup(gnssUart)) {
+        Serial.println("GNSS backup, position stable");
       } else {
-        snprintf(t, sizeof(t), "--:--:--.--");
+        Serial.println("GNSS backup request failed");
+        governor.backupFailed(millis());
+        governor.update(millis());
+        track = tracking = true;
       }
+    }
+    seenFailed = governor.stats().backupFailed;
+  }
+  panelTarget = governor.display();
+  antennaTarget = track;
+  if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+}
 
-      if (hasLoc) {
-        snprintf(la, sizeof(la), "LAT: %.6f", (double)GPS.location.lat());
-        snprintf(lo, sizeof(lo), "LON: %.6f", (double)GPS.location.lng());
-      } else {
-        snprintf(la, sizeof(la), "LAT: ----");
-        snprintf(lo, sizeof(lo), "LON: ----");
-      }
+static void reportPower() {
+  static const char* const kDisplay[] = { "on", "dim", "off" };
+  const PowerGovernor::Stats& ps = governor.stats();
+  uint32_t ua = governor.savedUa();
+  Serial.printf("power: display %s, GNSS %s, Vext off %lu s, %lu backups (%lu failed), %lu checks (%lu moved, %lu no fix)\n",
+                kDisplay[governor.display()],
+                governor.gnss() == PowerGovernor::GNSS_BACKUP ? "backup" : "tracking",
+                (unsigned long)(ps.railOffMs / 1000), (unsigned long)ps.backups, (unsigned long)ps.backupFailed,
+                (unsigned long)ps.checks, (unsigned long)ps.moved, (unsigned long)ps.checkFailed);
+  Serial.printf("power: saved ~%lu.%lu mA on average since boot, %lu mAh\n",
+                (unsigned long)(ua / 1000), (unsigned long)(ua / 100 % 10), (unsigned long)governor.savedMah());
+}
+#endif
 
-      // Serial
-      Serial.println(t);
-      Serial.println(la);
-      Serial.println(lo);
+#if GNSS_LIGHT_SLEEP
+// sleeps until the next UI refresh, the next epoch or a wakeup from the receiver
+static void sleepUntilNextEpoch() {
+  uint32_t sinceUi = millis() - lastUi;
+  if (sinceUi >= UI_IDLE_REFRESH_MS) return;
+  uint32_t ms = UI_IDLE_REFRESH_MS - sinceUi;
 
-      // OLED
-      display.setTextAlignment(TEXT_ALIGN_LEFT);
-      display.drawString(0, 0, t);
-      display.drawString(0, 12, la);
-      display.drawString(0, 24, lo);
-    }
+  // between PPS edges an epoch would only announce itself on the UART, and
+  // the bytes that wake the chip are lost; wake by timer at the epoch instead
+  if (GNSS_NAV_RATE_HZ > 1 && gnssTime.locked()) {
+    const int64_t epochUs = GNSS_EPOCH_MS * 1000LL;
+    int64_t next = (gnssTime.utcMicros() / epochUs + 1) * epochUs;
+    int64_t untilUs = gnssTime.localForUtc(next) - esp_timer_get_time();
+    if (untilUs < 1000) return;
+    if (untilUs < (int64_t)ms * 1000) ms = (uint32_t)(untilUs / 1000);
+  }
+
+  Serial.flush();
+  lightSleep.sleep(ms, &gnssTime);
+}
+#endif
+
+void setup() {
+  // power everything first, the GNSS sequence runs in the background
+  VextON();
+  uint32_t vextOnAt = millis();
+
+  gnssFramer.setFrameSink(feedTinyGps);
+  gnssFramer.on(nmeaType("TXT"), onTxtSentence, nullptr, NMEA_MATCH_TYPE);
+#if GNSS_USE_UBX
+  gnssFramer.setBinarySink(feedUbx);
+  ubxParser.setHandler(onUbxFrame);
+#endif
+  gnssPower.start<GnssPins>();
+  gnssTime.begin(GnssPins::pps);
+  gnssLatency.begin(gnssTime, GNSS_EPOCH_MS);
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
+
+  // pins/baud found by Debug_GNSS are kept in NVS; defaults otherwise
+  GnssPortConfig port = GnssAutoDetect::defaultPort<GnssPins>();
+  GnssAutoDetect::loadSaved(port);
+  bool uartOk = gnssUart.begin(UART_NUM_1, port.rxPin, port.txPin, port.baud, gnssRing);
+
+  Serial.begin(115200);
+  Serial.println("Program started. Setting up...");
+  if (uartOk) Serial.printf("GNSS UART started @%lu\n", (unsigned long)port.baud);
+  else Serial.println("GNSS UART driver install failed");
+
+#if GNSS_GEOFENCE
+  if (fencePartition.begin(fence)) Serial.printf("geofence: %u zones\n", fence.zoneCount());
+  else Serial.println("geofence: no zone partition");
+#endif
+
+#if GNSS_LIGHT_SLEEP
+  GnssLightSleep::Config sleepCfg;
+  sleepCfg.ppsPin = GnssPins::pps;
+  if (!uartOk || !lightSleep.begin(sleepCfg)) Serial.println("light sleep unavailable");
+#endif
+
+  // OLED
+  while (millis() - vextOnAt < VEXT_SETTLE_MS) delay(1);
+#if OLED_ASYNC_I2C
+  display.allocateBuffer();
+#endif
+  initPanel();
+  display.setFont(ArialMT_Plain_10);
+  display.setTextAlignment(TEXT_ALIGN_LEFT);
+  display.clear();
+  display.drawString(0, 0, "Initializing ...");
+#if OLED_ASYNC_I2C
+  oledLink.writeFrame(display.buffer);
+#else
+  display.display();
+#endif
+  setupScreen();
+
+  // from here on only the render task touches the display
+  xTaskCreatePinnedToCore(renderTask, "render", 4096, nullptr, 1, &renderTaskHandle, 0);
+
+#if GNSS_PERF || GNSS_POWER_GOVERNOR
+  pinMode(Board::prgButton, INPUT_PULLUP);
+  attachInterrupt(Board::prgButton, onPrgButton, FALLING);
+#endif
+}
+
+void loop() {
+  // --- GNSS input ---
+  // sleep until the ingest task delivers a chunk or the idle UI refresh is due
+  uint32_t sinceUi = millis() - lastUi;
+  uint32_t waitMs = sinceUi >= UI_IDLE_REFRESH_MS ? 0 : UI_IDLE_REFRESH_MS - sinceUi;
+#if GNSS_LIGHT_SLEEP && !GNSS_USE_UBX
+  // until the framer knows the epoch's final sentence, quiet gaps teach it
+  static uint32_t lastDataMs = 0;
+  if (!gnssFramer.epochEndId() && waitMs > GNSS_IDLE_GAP_MS) waitMs = GNSS_IDLE_GAP_MS;
+  if (gnssUart.waitForData(waitMs)) lastDataMs = millis();
+  else if (millis() - lastDataMs >= GNSS_IDLE_GAP_MS) gnssFramer.lineIdle();
+#else
+  gnssUart.waitForData(waitMs);
+#endif
+  PERF_BEGIN(perfLoop);
+
+  PERF_BEGIN(perfParse);
+  gnssFramer.poll(gnssRing);
+  PERF_END(perfParse);
+
+  static bool bootReported = false;
+  if (!bootReported && gnssPower.streaming()) {
+    bootReported = true;
+    Serial.printf("GNSS streaming %lu ms after power-on\n", (unsigned long)gnssPower.timeToDataMs());
+  }
 
-    // --- Antenna status (top right) ---
-    display.setTextAlignment(TEXT_ALIGN_RIGHT);
-    if (millis() - lastAntennaMsg < 5000) {
-      display.drawString(127, 0,
-        antennaOpen ? "ANT OPEN" : "ANT OK");
+  // the receiver boots into NMEA @9600 / 1 Hz; reconfigure once it talks
+  static bool gnssConfigured = false;
+  if (!gnssConfigured && gnssPower.streaming()) {
+    gnssConfigured = true;
+    configureGnss();
+  }
+
+  // --- publish fix snapshot ---
+#if GNSS_USE_UBX
+  bool gpsUpdated = pvtUpdated;
+  pvtUpdated = false;
+#else
+  // RMC and GGA both update the time; publish once per epoch
+  bool gpsUpdated = false;
+  if (GPS.time.isUpdated()) {
+    static uint32_t lastEpoch = UINT32_MAX;
+    uint32_t epoch = GPS.time.value();   // clears the updated flag
+    gpsUpdated = epoch != lastEpoch;
+    lastEpoch = epoch;
+  }
+#endif
+
+  // refresh on every new epoch, or after UI_IDLE_REFRESH_MS without one
+  if (gpsUpdated || millis() - lastUi >= UI_IDLE_REFRESH_MS) {
+    lastUi = millis();
+#if GNSS_POWER_GOVERNOR
+    // nobody sees uptime or the search bar on a dark panel
+    bool publish = gpsUpdated || panelTarget != PowerGovernor::DISPLAY_OFF;
+#else
+    bool publish = true;
+#endif
+    if (publish) {
+      if (!gpsUpdated) PERF_COUNT(perfIdleRefresh, 1);
+      PERF_BEGIN(perfPublish);
+      publishFix(gpsUpdated);
+      PERF_END(perfPublish);
     }
+  }
+
+#if GNSS_POWER_GOVERNOR
+  governPower();
+#endif
+
+#if GNSS_REPORT_MS
+  static uint32_t lastReport = 0;
+  if (millis() - lastReport >= GNSS_REPORT_MS) {
+    lastReport = millis();
+    reportLatency();
+#if GNSS_POWER_GOVERNOR
+    reportPower();
+#endif
+  }
+#endif
 
-    // --- Uptime footer ---
-    char up[12];
-    snprintf(up, sizeof(up), "%lus", (unsigned long)(millis() / 1000));
-    display.drawString(127, 54, up);
+#if GNSS_PERF
+  pollPerfCommands();
+#endif
+  PERF_END(perfLoop);
 
-    display.display();
+#if GNSS_LIGHT_SLEEP
+  // epoch complete and on screen: nothing to do until the next burst
+#if GNSS_USE_UBX
+  bool epochEnded = pvtLast;
+#else
+  bool epochEnded = gnssFramer.epochEnded();
+#endif
+  if (gnssConfigured && epochEnded && framesFlushed == fixesPublished && !gnssRing.available()) {
+    sleepUntilNextEpoch();
   }
+#endif
 }
@@ -0,0 +1,519 @@
+/**
+ * LoRa GNSS Tracker with Adaptive, Delta-Compressed Uplinks
+ *
+ * Picks the fixes worth sending by the receiver's motion, queues them and
+ * sends them over the SX1262 in batches within the EU868 duty cycle: one
+ * absolute point followed by varint/zigzag deltas (see TrackCodec.h).
+ *
+ * Why batching: at 1 % duty cycle every ms on air has to be earned by
+ * 99 ms of silence. Sending one 12-byte fix per frame wastes most of that
+ * airtime on preamble and header; a 51-byte SF10 frame carries ~11 points
+ * at 1e-5 deg (~1 m) resolution for roughly the same time on air.
+ *
+ * Pipeline:
+ * - GnssUart + NmeaFramer + TinyGPS++ as in GPSwithOLED
+ * - every TRACK_INTERVAL_S seconds of GNSS time the fix runs through a
+ *   PositionFilter for its velocity, then UplinkScheduler::offer() decides
+ *   whether the server's straight line would miss it by more than
+ *   TRACK_TOLERANCE_M; parked, one point per TRACK_HEARTBEAT_S goes out,
+ *   moving at least one per TRACK_MAX_GAP_S
+ * - kept fixes are queued as 16-byte FixRecords in a TrackBuffer: the
+ *   newest 256 points in internal SRAM, older ones moved 64 at a time into
+ *   a TRACK_ARENA_KB PSRAM arena (65536 points); only when that is full is
+ *   the oldest dropped
+ * - UplinkScheduler::plan() sends once the points fill a frame or the
+ *   oldest is TRACK_MAX_AGE_S old, on the channel whose EU868 sub-band
+ *   token bucket holds the most airtime, at the SF from LORA_MIN_SF to
+ *   LORA_MAX_SF with the least airtime per point (LORA_SURPLUS_RANGE 1: a
+ *   budget surplus buys the highest SF for range); a short budget raises
+ *   the tolerance instead of overflowing the queue
+ * - points leave the queue only after TX done
+ *
+ * Radio: raw LoRa (no LoRaWAN) through the interrupt-driven Sx1262 driver
+ * (lib/HeltecV4). send() returns as soon as the frame is in the radio;
+ * TX done arrives on the driver's event queue and also wakes loop(), so
+ * GNSS ingest keeps running during the 400 ms (SF10) to 2.5 s (SF12) on
+ * air. The receiving side decodes frames with trackDecode(); with
+ * LORA_MIN_SF != LORA_MAX_SF or several channels it has to be a gateway
+ * that demodulates all of them (SX1302/SX1303), a single SX126x receiver
+ * needs one channel and LORA_MIN_SF == LORA_MAX_SF.
+ *
+ * Deep-Sleep Mode (TRACKER_SLEEP_S > 0, battery operation):
+ * - every TRACKER_SLEEP_S the board wakes from deep sleep, takes one fix,
+ *   queues it, sends a batch if the duty cycle allows and sleeps again
+ * - with a fix per wake the velocity is unknown: a point is queued when the
+ *   tracker moved more than the tolerance or a heartbeat is due
+ * - the GNSS is put into backup mode (UBX-RXM-PMREQ) with VGNSS_CTRL held
+ *   on through deep sleep, so ephemeris and RTC survive and the next fix
+ *   is a hot start (~1-2 s instead of ~30 s); no reset pulse on wake
+ * - Vext (OLED) is cut, the SX1262 sleeps
+ * - queued points, scheduler state (budget, last point, counters), last
+ *   fix and the tracker clock live in RTC memory (RTC_DATA_ATTR) across
+ *   the sleeps; PSRAM does not keep its content, so only the oldest 32
+ *   queued points survive a sleep
+ * - each cycle reports wake-to-fix latency and the average current,
+ *   estimated from the time spent awake / transmitting / asleep times the
+ *   CURRENT_*_UA figures below (measure and adjust them for your board)
+ *
+ * Geofence Mode (TRACKER_GEOFENCE 1):
+ * - every sampled point is evaluated against the zones of the "geofence"
+ *   flash partition (Geofence + PartitionGeofence); only points where a
+ *   zone with GEOFENCE_UPLINK is entered or left are queued, and they are
+ *   sent with the next frame the budget allows (UplinkScheduler::expedite)
+ * - the frame carries the plain points; the server holds the same zone
+ *   list and re-evaluates them to name the transition
+ * - with TRACKER_SLEEP_S the zones the tracker is inside are kept in RTC
+ *   memory and a single fix changes a zone's state (no debounce across
+ *   minutes-apart wakes)
+ * - without a valid zone partition every point is uplinked as usual
+ *
+ * Serial output (115200 baud): one line per uplink with point count,
+ * bytes, SF, channel, airtime, the sub-band's remaining budget and the
+ * scheduler counters (kept / merged / dropped fixes, total airtime); in
+ * deep-sleep mode one line per cycle with the power metrics.
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include "HT_TinyGPS++.h"
+#include "GnssUart.h"
+#include "GnssPower.h"
+#include "GnssAutoDetect.h"
+#include "NmeaFramer.h"
+#include "GnssFix.h"
+#include "TrackCodec.h"
+#include "TrackBuffer.h"
+#include "LoraAirtime.h"
+#include "UplinkScheduler.h"
+#include "PositionFilter.h"
+#include "Sx1262.h"
+#include "PsramArena.h"
+#include "UbxConfig.h"
+#include "Geofence.h"
+#include "PartitionGeofence.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include "HeltecV4Board.h"
+
+using Board = HeltecV4;
+using GnssPins = Board::Gnss;
+static FastPin<Board::vext, Board::vextActiveLow> vext;
+
+// EU868 h1.4 sub-band (868.0-868.6 MHz): 1 % duty cycle, 14 dBm ERP;
+// channels in other sub-bands (869.525 MHz: 10 %) get their own budget
+#define RF_CHANNELS       { 868100000 }   // a gateway: { 868100000, 868300000, 868500000 }
+#define TX_OUTPUT_POWER   14
+#define LORA_BANDWIDTH    125000
+#define LORA_MIN_SF       10         // lowest SF that reaches the receiver
+#define LORA_MAX_SF       10         // > LORA_MIN_SF: the SF with the least airtime per point
+#define LORA_SURPLUS_RANGE 0         // 1 = a budget surplus buys the highest SF for range
+#define LORA_CODINGRATE   1          // 1: 4/5 .. 4: 4/8
+#define LORA_PREAMBLE     8
+
+#define TRACK_INTERVAL_S  1          // GNSS seconds between fixes offered to the scheduler
+#define TRACK_QUANTUM     2          // 1e-7 deg * 10^2 = 1e-5 deg
+#define TRACK_TOLERANCE_M 10         // tolerated deviation from the straight line
+#define TRACK_HEARTBEAT_S 900        // parked: a point this often
+#define TRACK_MAX_GAP_S   60         // moving: at least a point this often
+#define TRACK_MAX_AGE_S   120        // a partly filled frame goes when its oldest point is this old
+#define TRACK_ARENA_KB    1024       // PSRAM behind the SRAM window, 0 = SRAM only
+#define TRACK_ARENA_DMA   0          // 1 = batch moves on the GDMA (see PsramArena.h)
+
+// 1 = uplink only zone transitions (needs the "geofence" partition)
+#define TRACKER_GEOFENCE 0
+
+// deep-sleep duty cycle, 0 = stay awake
+#define TRACKER_SLEEP_S      0       // wake period
+#define TRACKER_FIX_TIMEOUT_S 90     // give up and sleep without a fix
+#define TRACKER_GNSS_BACKUP  1       // 1 = u-blox backup mode (hot start), 0 = GNSS off (cold start)
+
+// current model for the power report (uA)
+#define CURRENT_AWAKE_UA  70000      // ESP32-S3 @240 MHz + GNSS acquiring
+#define CURRENT_TX_UA     45000      // SX1262 at +14 dBm, on top of awake
+#define CURRENT_SLEEP_UA  50         // deep sleep + GNSS backup + SX1262 sleep + regulator
+#define BATTERY_MAH       2000
+
+TinyGPSPlus GPS;
+
+static StaticByteRing<2048> gnssRing;
+static GnssUart gnssUart;
+static NmeaFramer gnssFramer;
+static GnssPowerSequencer gnssPower;
+
+static TrackBuffer<256, 64> trackQueue;
+static PsramArena trackArena;
+static PositionFilterF motion;       // velocity for the scheduler
+static UplinkScheduler::Config uplinkConfig() {
+  UplinkScheduler::Config c;
+  c.minSf = LORA_MIN_SF;
+  c.maxSf = LORA_MAX_SF;
+  c.rangeFromSurplus = LORA_SURPLUS_RANGE;
+  c.bandwidthHz = LORA_BANDWIDTH;
+  c.codingRate = LORA_CODINGRATE;
+  c.preamble = LORA_PREAMBLE;
+  c.quantum = TRACK_QUANTUM;
+  c.toleranceMm = TRACK_TOLERANCE_M * 1000UL;
+  c.heartbeatS = TRACK_HEARTBEAT_S;
+  c.maxGapS = TRACK_MAX_GAP_S;
+  c.maxLatencyS = TRACK_MAX_AGE_S;
+  return c;
+}
+static UplinkScheduler uplink(uplinkConfig());
+static const uint32_t kChannels[] = RF_CHANNELS;
+static uint32_t queueDropped = 0;    // trackQueue.dropped() reported so far
+
+static Sx1262 radio;
+static uint8_t txFrame[222];
+static UplinkScheduler::Plan txPlan;  // the frame on air
+static uint32_t txStartMs = 0;
+static bool txBusy = false;
+
+#if TRACKER_GEOFENCE
+static Geofence fence;
+static PartitionGeofence fencePartition;
+#endif
+
+#if TRACKER_SLEEP_S
+// survives deep sleep; plain data only (a constructor would run on every wake)
+struct RetainedState {
+  uint32_t magic;
+  uint32_t cycles;
+  uint32_t clockMs;          // awake + asleep time since power-on, drives the duty cycle
+  UplinkScheduler::State uplink;
+  FixRecord lastFix;         // no date = none yet
+  uint16_t queued;
+  FixRecord queue[32];
+#if TRACKER_GEOFENCE
+  Geofence::State fence;     // zones inside
+#endif
+
+  // metrics
+  uint32_t fixes;
+  uint32_t fixTimeouts;
+  uint32_t wakeToFixSumMs;
+  uint32_t wakeToFixMaxMs;
+  uint64_t chargeUaMs;       // estimated charge since power-on
+  uint64_t elapsedMs;
+};
+
+static const uint32_t kRetainedMagic = 0x54524B33;   // "TRK3", scheduler state
+RTC_DATA_ATTR static RetainedState rtcState;
+
+static uint32_t wakeToFixMs = 0;   // this wake, 0 = no fix yet
+static uint32_t txMsThisWake = 0;
+#endif
+
+// clock for the duty cycle: keeps counting through deep sleep
+static uint32_t trackerMs() {
+#if TRACKER_SLEEP_S
+  return rtcState.clockMs + millis();
+#else
+  return millis();
+#endif
+}
+
+void VextOFF() { vext.output(); vext.off(); }
+
+static void feedTinyGps(const NmeaSentence& s, void*) {
+  gnssPower.dataSeen();
+  for (size_t i = 0; i < s.size(); i++) GPS.encode(s.at(i));
+}
+
+static bool currentFix(GnssFix& fix) {
+  fix = {};
+  fix.timeValid = GPS.time.isValid();
+  fix.locationValid = GPS.location.isValid();
+  fix.dateValid = GPS.date.isValid();
+  fix.year = GPS.date.year();
+  fix.month = GPS.date.month();
+  fix.day = GPS.date.day();
+  fix.hour = GPS.time.hour();
+  fix.minute = GPS.time.minute();
+  fix.second = GPS.time.second();
+  fix.centisecond = GPS.time.centisecond();
+
+  const RawDegrees& lat = GPS.location.rawLat();
+  const RawDegrees& lon = GPS.location.rawLng();
+  fix.lat = { lat.deg, lat.billionths, lat.negative };
+  fix.lon = { lon.deg, lon.billionths, lon.negative };
+  fix.satellites = GPS.satellites.isValid() ? (uint8_t)GPS.satellites.value() : 0;
+  fix.hdop = GPS.hdop.isValid() ? (uint16_t)GPS.hdop.value() : 0;
+  return fix.locationValid;
+}
+
+// offers a fix every TRACK_INTERVAL_S seconds of GNSS time, queues the kept ones
+static void samplePoint() {
+  static uint32_t lastTime = 0;
+  if (!GPS.time.isUpdated()) return;
+  GPS.time.value();   // clears the updated flag
+
+  GnssFix fix;
+  FixRecord p;
+  if (!currentFix(fix)) return;
+  fixRecordFromFix(fix, p);
+  if (!fixIsComplete(p)) return;
+  uint32_t time = fixUnixSeconds(p);
+  if (lastTime && time - lastTime < TRACK_INTERVAL_S) return;
+
+  lastTime = time;
+
+#if TRACKER_SLEEP_S
+  if (!wakeToFixMs) {
+    wakeToFixMs = millis();
+    rtcState.lastFix = p;
+  }
+#endif
+
+  motion.update(p);
+  bool keep;
+#if TRACKER_GEOFENCE
+  if (fence.loaded()) {
+    Geofence::Event events[4];
+    uint8_t n = fence.update(p.lat, p.lon, events, 4);
+    keep = false;
+    for (uint8_t i = 0; i < n; i++) {
+      const GeofenceZone& z = fence.zone(events[i].zone);
+      Serial.printf("geofence: %s %.12s (id %u)\n", events[i].entered ? "enter" : "exit", z.name, z.id);
+      if (z.flags & GEOFENCE_UPLINK) keep = true;
+    }
+    if (keep) uplink.expedite();
+  } else
+#endif
+  {
+    int32_t northMms, eastMms;
+    motion.velocity(northMms, eastMms);
+    keep = uplink.offer(p, northMms, eastMms);
+  }
+  if (!keep) return;
+
+  trackQueue.push(p);
+  if (trackQueue.dropped() != queueDropped) {
+    uplink.noteDropped(trackQueue.dropped() - queueDropped);
+    queueDropped = trackQueue.dropped();
+  }
+}
+
+static void startUplink() {
+  if (txBusy || trackQueue.empty()) return;
+
+  static FixRecord batch[64];
+  size_t n = trackQueue.peek(batch, sizeof(batch) / sizeof(batch[0]));
+  if (!uplink.plan(trackerMs(), batch, n, txFrame, sizeof(txFrame), txPlan)) return;
+
+  // TX timeout: twice the computed airtime
+  uint32_t timeoutMs = txPlan.airtimeUs / 500 + 100;
+  if (!radio.setChannel(txPlan.frequencyHz, txPlan.sf) || !radio.send(txFrame, txPlan.length, timeoutMs)) return;
+  txBusy = true;
+  txStartMs = millis();
+}
+
+static void onTxDone(const Sx1262::Event& ev) {
+  uint32_t now = trackerMs();
+  // the DIO1 edge is the real end of the frame, not when loop() noticed it
+  uint32_t measured = (uint32_t)(ev.timestampUs / 1000) - txStartMs;
+  uplink.sent(now, txPlan, measured * 1000);
+#if TRACKER_SLEEP_S
+  txMsThisWake += measured;
+#endif
+
+  trackQueue.drop(txPlan.points);
+  txBusy = false;
+  radio.sleep();
+
+  const UplinkScheduler::Counters& c = uplink.counters();
+  AirtimeBucket& budget = uplink.budget().bucket((uint8_t)Eu868Budget::subband(txPlan.frequencyHz));
+  Serial.printf("uplink #%lu: %u points, %u bytes, SF%u @ %lu kHz, %lu ms on air, budget %lu ms, queued %u\n",
+                (unsigned long)c.frames, (unsigned)txPlan.points, (unsigned)txPlan.length, txPlan.sf,
+                (unsigned long)(txPlan.frequencyHz / 1000), (unsigned long)(txPlan.airtimeUs / 1000),
+                (unsigned long)(budget.availableUs(now) / 1000), (unsigned)trackQueue.size());
+  Serial.printf("  fixes %lu: kept %lu, merged %lu, dropped %lu; %lu points sent, %lu ms on air, x%u tolerance\n",
+                (unsigned long)c.fixes, (unsigned long)c.kept, (unsigned long)c.merged,
+                (unsigned long)c.dropped, (unsigned long)c.pointsSent, (unsigned long)(c.airtimeUs / 1000),
+                uplink.pressure());
+}
+
+static void onTxTimeout() {
+  // the frame may have been (partly) radiated: charge it, keep the points
+  uplink.timedOut(trackerMs(), txPlan);
+  txBusy = false;
+  radio.sleep();
+  Serial.printf("uplink timeout (%lu so far)\n", (unsigned long)uplink.counters().timeouts);
+}
+
+#if TRACKER_SLEEP_S
+// cold boot: fresh state; timer wake: pick up the queue and the duty cycle
+static bool restoreState() {
+  bool warm = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER &&
+              rtcState.magic == kRetainedMagic;
+  if (!warm) {
+    memset(&rtcState, 0, sizeof(rtcState));
+    rtcState.magic = kRetainedMagic;
+  }
+  for (uint16_t i = 0; i < rtcState.queued; i++) trackQueue.push(rtcState.queue[i]);
+  if (warm) uplink.restore(rtcState.uplink);
+  return warm;
+}
+
+static void reportCycle(uint32_t awakeMs, uint32_t sleepMs) {
+  const RetainedState& r = rtcState;
+  uint64_t cycleCharge = (uint64_t)awakeMs * CURRENT_AWAKE_UA +
+                         (uint64_t)txMsThisWake * CURRENT_TX_UA +
+                         (uint64_t)sleepMs * CURRENT_SLEEP_UA;
+  uint32_t cycleUa = (uint32_t)(cycleCharge / (awakeMs + sleepMs));
+  uint32_t avgUa = (uint32_t)(r.chargeUaMs / r.elapsedMs);
+  uint32_t days = avgUa ? (uint32_t)((uint64_t)BATTERY_MAH * 1000 / avgUa / 24) : 0;
+
+  if (wakeToFixMs) {
+    Serial.printf("cycle %lu: wake->fix %lu ms (first data %lu ms), avg %lu ms, max %lu ms\n",
+                  (unsigned long)r.cycles, (unsigned long)wakeToFixMs,
+                  (unsigned long)gnssPower.timeToDataMs(),
+                  (unsigned long)(r.wakeToFixSumMs / r.fixes), (unsigned long)r.wakeToFixMaxMs);
+  } else {
+    Serial.printf("cycle %lu: no fix within %d s (%lu timeouts)\n",
+                  (unsigned long)r.cycles, TRACKER_FIX_TIMEOUT_S, (unsigned long)r.fixTimeouts);
+  }
+  Serial.printf("  awake %lu ms, tx %lu ms, sleep %lu ms -> %lu uA this cycle, %lu uA overall, ~%lu days on %d mAh\n",
+                (unsigned long)awakeMs, (unsigned long)txMsThisWake, (unsigned long)sleepMs,
+                (unsigned long)cycleUa, (unsigned long)avgUa, (unsigned long)days, BATTERY_MAH);
+}
+
+// saves state, parks the peripherals and deep-sleeps until the next period
+static void goToSleep() {
+  uint32_t awakeMs = millis();
+  uint32_t periodMs = TRACKER_SLEEP_S * 1000UL;
+  uint32_t sleepMs = awakeMs + 1000 < periodMs ? periodMs - awakeMs : 1000;
+
+  RetainedState& r = rtcState;
+  r.cycles++;
+  if (wakeToFixMs) {
+    r.fixes++;
+    r.wakeToFixSumMs += wakeToFixMs;
+    if (wakeToFixMs > r.wakeToFixMaxMs) r.wakeToFixMaxMs = wakeToFixMs;
+  } else {
+    r.fixTimeouts++;
+  }
+  r.chargeUaMs += (uint64_t)awakeMs * CURRENT_AWAKE_UA + (uint64_t)txMsThisWake * CURRENT_TX_UA +
+                  (uint64_t)sleepMs * CURRENT_SLEEP_UA;
+  r.elapsedMs += awakeMs + sleepMs;
+  reportCycle(awakeMs, sleepMs);
+
+  r.queued = (uint16_t)trackQueue.peek(r.queue, sizeof(r.queue) / sizeof(r.queue[0]));
+  uplink.save(r.uplink);
+  r.clockMs += awakeMs + sleepMs;
+#if TRACKER_GEOFENCE
+  fence.save(r.fence);
+#endif
+
+#if TRACKER_GNSS_BACKUP
+  ubxEnterBackup(gnssUart);   // supply stays on, the module drops to backup current
+#else
+  gnssPower.powerOff();
+#endif
+  gpio_hold_en((gpio_num_t)GnssPins::ctrl);
+  VextOFF();
+  gpio_hold_en((gpio_num_t)Board::vext);
+  gpio_deep_sleep_hold_en();
+  radio.sleep();
+
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000);
+  esp_deep_sleep_start();
+}
+#endif
+
+void setup() {
+  Serial.begin(115200);
+
+  gnssFramer.setFrameSink(feedTinyGps);
+
+  GnssPowerSequencer::Timing timing;
+#if TRACKER_SLEEP_S
+  bool warm = restoreState();
+  if (warm && TRACKER_GNSS_BACKUP) {
+    timing.settleMs = 10;   // supply never went off
+    timing.resetMs = 0;     // a reset would throw away the hot-start data
+  }
+#endif
+  gnssPower.start<GnssPins>(timing);
+#if TRACKER_SLEEP_S
+  // levels are set again above, now release the sleep latches
+  VextOFF();
+  gpio_hold_dis((gpio_num_t)GnssPins::ctrl);
+  gpio_hold_dis((gpio_num_t)Board::vext);
+#endif
+
+  GnssPortConfig port = GnssAutoDetect::defaultPort<GnssPins>();
+  GnssAutoDetect::loadSaved(port);
+  if (!gnssUart.begin(UART_NUM_1, port.rxPin, port.txPin, port.baud, gnssRing)) {
+    Serial.println("GNSS UART driver install failed");
+  }
+#if TRACKER_SLEEP_S && TRACKER_GNSS_BACKUP
+  if (warm) ubxWake(gnssUart);
+#endif
+
+  Sx1262::Config rc;
+  rc.frequencyHz = kChannels[0];
+  rc.powerDbm = TX_OUTPUT_POWER;
+  rc.sf = LORA_MIN_SF;
+  rc.bandwidthHz = LORA_BANDWIDTH;
+  rc.codingRate = LORA_CODINGRATE;
+  rc.preamble = LORA_PREAMBLE;
+  if (radio.begin(Sx1262::Pins::of<Board::Lora>(), rc)) {
+    radio.setNotify(xTaskGetCurrentTaskHandle());   // radio events wake waitForData()
+    radio.sleep();
+  } else {
+    Serial.println("SX1262 init failed");
+  }
+
+#if TRACK_ARENA_KB
+  if (trackArena.begin(TRACK_ARENA_KB * 1024UL)) {
+    trackQueue.attachArena(trackArena.as<FixRecord>(), trackArena.size() / sizeof(FixRecord));
+    if (TRACK_ARENA_DMA && trackArena.enableDma()) trackQueue.setMover(PsramArena::move, &trackArena);
+  } else {
+    Serial.println("no PSRAM, track buffer limited to the SRAM window");
+  }
+#endif
+#if TRACKER_GEOFENCE
+  Geofence::Config fenceCfg;
+  if (TRACKER_SLEEP_S) fenceCfg.confirmFixes = 1;   // fixes are a period apart
+  if (fencePartition.begin(fence, fenceCfg)) {
+#if TRACKER_SLEEP_S
+    if (warm) fence.restore(rtcState.fence);
+#endif
+    Serial.printf("geofence: %u zones, uplink on transitions only\n", (unsigned)fence.zoneCount());
+  } else {
+    Serial.println("geofence: no zone partition, uplinking every point");
+  }
+#endif
+
+  Serial.printf("track buffer: %u points (%u in SRAM)\n", (unsigned)trackQueue.capacity(), 256u);
+
+  for (size_t i = 0; i < sizeof(kChannels) / sizeof(kChannels[0]); i++) {
+    if (!uplink.addChannel(kChannels[i])) Serial.printf("channel %lu Hz outside EU868\n", (unsigned long)kChannels[i]);
+  }
+  Serial.printf("LoRa tracker: SF%d-%d on %u channel(s), %d m tolerance, a point at least every %d s moving\n",
+                LORA_MIN_SF, LORA_MAX_SF, (unsigned)uplink.channelCount(), TRACK_TOLERANCE_M, TRACK_MAX_GAP_S);
+}
+
+void loop() {
+  // GNSS chunks and radio events both wake us; plan() runs at least once a second
+  gnssUart.waitForData(1000);
+  gnssFramer.poll(gnssRing);
+
+  Sx1262::Event ev;
+  while (radio.events() && xQueueReceive(radio.events(), &ev, 0) == pdTRUE) {
+    if (ev.type == Sx1262::TX_DONE) onTxDone(ev);
+    else if (ev.type == Sx1262::TIMEOUT && txBusy) onTxTimeout();
+  }
+
+  samplePoint();
+  startUplink();
+
+#if TRACKER_SLEEP_S
+  // one fix per wake; a started uplink finishes first
+  bool timedOut = millis() >= TRACKER_FIX_TIMEOUT_S * 1000UL;
+  if ((wakeToFixMs || timedOut) && !txBusy) goToSleep();
+#endif
+}
@@ -0,0 +1,140 @@
+/**
+ * OLED Frame Rate Benchmark
+ *
+ * Measures full-frame SSD1306 refresh rates through I2cOledTransport (ESP-IDF
+ * i2c_master, queued transactions) at every SCL clock the panel may accept,
+ * and how much of the frame time the CPU spends queuing instead of waiting.
+ *
+ * What It Does:
+ * - Powers Vext, resets the panel and sends the SSD1306 init sequence
+ * - For 100 kHz, 400 kHz, 500 kHz (the GPSwithOLED Wire clock), 800 kHz and
+ *   1 MHz (Fast-mode Plus):
+ *   - back-to-back: 200 full frames (8 x 141-byte page transactions), fps
+ *     from the wall time until the queue drained, CPU % spent in
+ *     writeFrame() (copy + queue)
+ *   - render overlap: each frame is preceded by kRenderUs of busy work,
+ *     once waiting for the previous frame to drain (what a blocking
+ *     transport does) and once queuing straight away
+ *   - bus errors (NACK / timeout): a clock the panel cannot follow shows
+ *     up here and its fps figure must be ignored
+ * - Prints a results table to Serial (115200 baud) and leaves a test pattern
+ *   on the panel
+ *
+ * Usage:
+ * 1. Upload this sketch to your Heltec V4 board
+ * 2. Open the Serial Monitor at 115200 baud
+ * 3. Press RST to repeat the run
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "I2cOledTransport.h"
+#include "HeltecV4Board.h"
+
+static const uint32_t kClocks[] = { 100000, 400000, 500000, 800000, 1000000 };
+static const int kFrames = 200;
+static const uint32_t kRenderUs = 8000;   // stand-in for drawing one frame
+
+static I2cOledTransport oledLink;
+static FastPin<HeltecV4::vext, HeltecV4::vextActiveLow> vext;
+static uint8_t frames[2][1024];
+
+// moving stripes, so consecutive frames really differ on the panel
+static void makePatterns() {
+  for (int f = 0; f < 2; f++) {
+    for (int i = 0; i < 1024; i++) frames[f][i] = ((i + f * 4) & 8) ? 0xFF : 0x00;
+  }
+}
+
+static void busyFor(uint32_t us) {
+  int64_t until = esp_timer_get_time() + us;
+  while (esp_timer_get_time() < until) {}
+}
+
+struct Result {
+  float fps;
+  float cpuPercent;
+  float blockingFps;
+  float overlapFps;
+  uint32_t errors;
+};
+
+static Result runClock(uint32_t hz) {
+  Result r = {};
+  oledLink.setClock(hz);
+  oledLink.takeError();
+  uint32_t errors = oledLink.stats().errors;
+
+  // back-to-back frames: bus bound
+  int64_t queueUs = 0;
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < kFrames; i++) {
+    int64_t q = esp_timer_get_time();
+    oledLink.writeFrame(frames[i & 1]);
+    queueUs += esp_timer_get_time() - q;
+  }
+  oledLink.drain(2000);
+  int64_t wallUs = esp_timer_get_time() - t0;
+  r.fps = kFrames * 1e6f / wallUs;
+  r.cpuPercent = 100.0f * queueUs / wallUs;
+
+  // render + transfer, serialised as with a blocking transport
+  const int renderFrames = kFrames / 4;
+  t0 = esp_timer_get_time();
+  for (int i = 0; i < renderFrames; i++) {
+    busyFor(kRenderUs);
+    oledLink.writeFrame(frames[i & 1]);
+    oledLink.drain(1000);
+  }
+  r.blockingFps = renderFrames * 1e6f / (esp_timer_get_time() - t0);
+
+  // render while the previous frame drains
+  t0 = esp_timer_get_time();
+  for (int i = 0; i < renderFrames; i++) {
+    busyFor(kRenderUs);
+    oledLink.writeFrame(frames[i & 1]);
+  }
+  oledLink.drain(1000);
+  r.overlapFps = renderFrames * 1e6f / (esp_timer_get_time() - t0);
+
+  r.errors = oledLink.stats().errors - errors;
+  return r;
+}
+
+void setup() {
+  Serial.begin(115200);
+  vext.output();
+  vext.on();
+  delay(500);
+  Serial.println("OLED frame rate benchmark (I2cOledTransport)");
+
+  makePatterns();
+  I2cOledTransport::Config cfg;
+  cfg.clockHz = 400000;   // init at the datasheet clock
+  if (!oledLink.begin(cfg)) {
+    Serial.println("panel did not answer (check Vext and the I2C pins)");
+    return;
+  }
+
+  Serial.printf("   clock     fps  cpu %%  render %lu ms: blocking  async   errors\n",
+                (unsigned long)(kRenderUs / 1000));
+  for (uint32_t hz : kClocks) {
+    Result r = runClock(hz);
+    Serial.printf("%5lu kHz  %6.1f  %5.1f                 %6.1f  %6.1f  %6lu%s\n",
+                  (unsigned long)(hz / 1000), r.fps, r.cpuPercent, r.blockingFps, r.overlapFps,
+                  (unsigned long)r.errors, r.errors ? "  (not supported)" : "");
+  }
+
+  const I2cOledTransport::Stats& st = oledLink.stats();
+  Serial.printf("%lu transactions, %lu slot waits, %lu bytes on the bus\n",
+                (unsigned long)st.transactions, (unsigned long)st.slotWaits,
+                (unsigned long)oledLink.bytesSent());
+  oledLink.setClock(400000);
+  oledLink.writeFrame(frames[0]);
+  oledLink.drain(1000);
+}
+
+void loop() {}
@@ -0,0 +1,632 @@
+/**
+ * GNSS Parse Path Replay Benchmark
+ *
+ * Replays recorded GNSS captures from flash through the parse paths used
+ * by the examples and reports how fast each one is on the ESP32-S3, so
+ * parser changes can be compared against fixed numbers instead of live,
+ * sky-dependent input.
+ *
+ * Paths:
+ * - encode+TXT: the original GPSwithOLED loop, GPS.encode() per byte plus
+ *   a line buffer sniffed for "ANTENNA" with strstr()
+ * - framer+GPS: ByteRing + NmeaFramer, TinyGPS++ fed with every valid
+ *   sentence and TXT matched by type (current GPSwithOLED)
+ * - framer: framing and checksums only
+ * - framer+UBX: NAV-PVT / MON-HW capture through the framer's binary sink,
+ *   UbxParser and ubxNavPvtToFix() (GNSS_USE_UBX 1)
+ *
+ * The ring paths are fed in chunks of kChunk bytes, like the GnssUart RX
+ * threshold delivers them; only poll() is timed, the ring write belongs to
+ * the ingest task.
+ *
+ * Output per path (Serial, 115200 baud):
+ * - bytes/s of CPU time at the current clock
+ * - cycles per sentence (or UBX frame) and per byte, esp_cpu_get_cycle_count()
+ * - worst call: the longest single encode() / poll(); it bounds how long a
+ *   byte waits for the parser (interrupts included, as in the real loop)
+ * - sentences/frames accepted per replay, to spot a parser that got faster
+ *   by dropping data
+ *
+ * Captures: 20 s of u-blox M10 default NMEA output (RMC, VTG, GGA, 4x GSA,
+ * GSV for four constellations, GLL, an antenna TXT every 10 s) and 20
+ * epochs of NAV-PVT with MON-HW every 5th. To replay your own, capture with
+ * Debug_GNSS and convert its hex dump:
+ *
+ *   cut -c1-48 dump.txt | xxd -r -p > capture.bin && xxd -i capture.bin
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include "HT_TinyGPS++.h"
+#include "ByteRing.h"
+#include "NmeaFramer.h"
+#include "Ubx.h"
+#include "GnssFix.h"
+
+static const int kRounds = 20;      // replays per path
+static const size_t kChunk = 100;   // GnssUart::Config::rxThreshold
+
+// --- captures (const data stays in flash) ---
+
+static const char kNmeaCapture[] =
+  "$GNRMC,101500.00,A,5231.20048,N,01324.29724,E,9.760,26.70,141026,,,A,V*31\r\n"
+  "$GNVTG,26.70,T,,M,9.760,N,18.075,K,A*23\r\n"
+  "$GNGGA,101500.00,5231.20048,N,01324.29724,E,1,12,0.78,41.3,M,44.6,M,,*7E\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.20048,N,01324.29724,E,101500.00,A,A*77\r\n"
+  "$GPTXT,01,01,01,ANTENNA OK*35\r\n"
+  "$GNRMC,101501.00,A,5231.20294,N,01324.29886,E,9.890,26.54,141026,,,A,V*32\r\n"
+  "$GNVTG,26.54,T,,M,9.890,N,18.317,K,A*22\r\n"
+  "$GNGGA,101501.00,5231.20294,N,01324.29886,E,1,12,0.78,41.3,M,44.6,M,,*7B\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.20294,N,01324.29886,E,101501.00,A,A*72\r\n"
+  "$GNRMC,101502.00,A,5231.20540,N,01324.30048,E,9.844,27.13,141026,,,A,V*36\r\n"
+  "$GNVTG,27.13,T,,M,9.844,N,18.232,K,A*2F\r\n"
+  "$GNGGA,101502.00,5231.20540,N,01324.30048,E,1,12,0.78,41.3,M,44.6,M,,*74\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.20540,N,01324.30048,E,101502.00,A,A*7D\r\n"
+  "$GNRMC,101503.00,A,5231.20786,N,01324.30210,E,9.653,27.41,141026,,,A,V*3F\r\n"
+  "$GNVTG,27.41,T,,M,9.653,N,17.878,K,A*2B\r\n"
+  "$GNGGA,101503.00,5231.20786,N,01324.30210,E,1,12,0.78,41.3,M,44.6,M,,*72\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.20786,N,01324.30210,E,101503.00,A,A*7B\r\n"
+  "$GNRMC,101504.00,A,5231.21032,N,01324.30372,E,9.645,27.27,141026,,,A,V*33\r\n"
+  "$GNVTG,27.27,T,,M,9.645,N,17.863,K,A*26\r\n"
+  "$GNGGA,101504.00,5231.21032,N,01324.30372,E,1,12,0.78,41.3,M,44.6,M,,*79\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.21032,N,01324.30372,E,101504.00,A,A*70\r\n"
+  "$GNRMC,101505.00,A,5231.21278,N,01324.30534,E,9.658,26.58,141026,,,A,V*3F\r\n"
+  "$GNVTG,26.58,T,,M,9.658,N,17.887,K,A*29\r\n"
+  "$GNGGA,101505.00,5231.21278,N,01324.30534,E,1,12,0.78,41.3,M,44.6,M,,*70\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.21278,N,01324.30534,E,101505.00,A,A*79\r\n"
+  "$GNRMC,101506.00,A,5231.21524,N,01324.30696,E,9.800,28.05,141026,,,A,V*3C\r\n"
+  "$GNVTG,28.05,T,,M,9.800,N,18.149,K,A*28\r\n"
+  "$GNGGA,101506.00,5231.21524,N,01324.30696,E,1,12,0.78,41.3,M,44.6,M,,*76\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.21524,N,01324.30696,E,101506.00,A,A*7F\r\n"
+  "$GNRMC,101507.00,A,5231.21770,N,01324.30858,E,9.680,26.85,141026,,,A,V*32\r\n"
+  "$GNVTG,26.85,T,,M,9.680,N,17.926,K,A*26\r\n"
+  "$GNGGA,101507.00,5231.21770,N,01324.30858,E,1,12,0.78,41.3,M,44.6,M,,*78\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.21770,N,01324.30858,E,101507.00,A,A*71\r\n"
+  "$GNRMC,101508.00,A,5231.22016,N,01324.31020,E,9.881,28.30,141026,,,A,V*30\r\n"
+  "$GNVTG,28.30,T,,M,9.881,N,18.300,K,A*28\r\n"
+  "$GNGGA,101508.00,5231.22016,N,01324.31020,E,1,12,0.78,41.3,M,44.6,M,,*75\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.22016,N,01324.31020,E,101508.00,A,A*7C\r\n"
+  "$GNRMC,101509.00,A,5231.22262,N,01324.31182,E,9.861,27.19,141026,,,A,V*33\r\n"
+  "$GNVTG,27.19,T,,M,9.861,N,18.262,K,A*27\r\n"
+  "$GNGGA,101509.00,5231.22262,N,01324.31182,E,1,12,0.78,41.3,M,44.6,M,,*7C\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.22262,N,01324.31182,E,101509.00,A,A*75\r\n"
+  "$GNRMC,101510.00,A,5231.22508,N,01324.31344,E,10.021,26.49,141026,,,A,V*08\r\n"
+  "$GNVTG,26.49,T,,M,10.021,N,18.558,K,A*19\r\n"
+  "$GNGGA,101510.00,5231.22508,N,01324.31344,E,1,12,0.78,41.3,M,44.6,M,,*77\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.22508,N,01324.31344,E,101510.00,A,A*7E\r\n"
+  "$GPTXT,01,01,01,ANTENNA OK*35\r\n"
+  "$GNRMC,101511.00,A,5231.22754,N,01324.31506,E,9.973,26.98,141026,,,A,V*38\r\n"
+  "$GNVTG,26.98,T,,M,9.973,N,18.471,K,A*29\r\n"
+  "$GNGGA,101511.00,5231.22754,N,01324.31506,E,1,12,0.78,41.3,M,44.6,M,,*7D\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.22754,N,01324.31506,E,101511.00,A,A*74\r\n"
+  "$GNRMC,101512.00,A,5231.23000,N,01324.31668,E,9.688,26.64,141026,,,A,V*3F\r\n"
+  "$GNVTG,26.64,T,,M,9.688,N,17.942,K,A*23\r\n"
+  "$GNGGA,101512.00,5231.23000,N,01324.31668,E,1,12,0.78,41.3,M,44.6,M,,*72\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.23000,N,01324.31668,E,101512.00,A,A*7B\r\n"
+  "$GNRMC,101513.00,A,5231.23246,N,01324.31830,E,9.753,28.03,141026,,,A,V*35\r\n"
+  "$GNVTG,28.03,T,,M,9.753,N,18.063,K,A*2E\r\n"
+  "$GNGGA,101513.00,5231.23246,N,01324.31830,E,1,12,0.78,41.3,M,44.6,M,,*70\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.23246,N,01324.31830,E,101513.00,A,A*79\r\n"
+  "$GNRMC,101514.00,A,5231.23492,N,01324.31992,E,9.702,27.56,141026,,,A,V*3F\r\n"
+  "$GNVTG,27.56,T,,M,9.702,N,17.969,K,A*29\r\n"
+  "$GNGGA,101514.00,5231.23492,N,01324.31992,E,1,12,0.78,41.3,M,44.6,M,,*71\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.23492,N,01324.31992,E,101514.00,A,A*78\r\n"
+  "$GNRMC,101515.00,A,5231.23738,N,01324.32154,E,9.886,27.14,141026,,,A,V*39\r\n"
+  "$GNVTG,27.14,T,,M,9.886,N,18.308,K,A*2E\r\n"
+  "$GNGGA,101515.00,5231.23738,N,01324.32154,E,1,12,0.78,41.3,M,44.6,M,,*72\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.23738,N,01324.32154,E,101515.00,A,A*7B\r\n"
+  "$GNRMC,101516.00,A,5231.23984,N,01324.32316,E,9.849,26.53,141026,,,A,V*36\r\n"
+  "$GNVTG,26.53,T,,M,9.849,N,18.241,K,A*23\r\n"
+  "$GNGGA,101516.00,5231.23984,N,01324.32316,E,1,12,0.78,41.3,M,44.6,M,,*7C\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.23984,N,01324.32316,E,101516.00,A,A*75\r\n"
+  "$GNRMC,101517.00,A,5231.24230,N,01324.32478,E,9.654,26.81,141026,,,A,V*36\r\n"
+  "$GNVTG,26.81,T,,M,9.654,N,17.879,K,A*20\r\n"
+  "$GNGGA,101517.00,5231.24230,N,01324.32478,E,1,12,0.78,41.3,M,44.6,M,,*71\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.24230,N,01324.32478,E,101517.00,A,A*78\r\n"
+  "$GNRMC,101518.00,A,5231.24476,N,01324.32640,E,9.902,27.26,141026,,,A,V*34\r\n"
+  "$GNVTG,27.26,T,,M,9.902,N,18.339,K,A*20\r\n"
+  "$GNGGA,101518.00,5231.24476,N,01324.32640,E,1,12,0.78,41.3,M,44.6,M,,*73\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.24476,N,01324.32640,E,101518.00,A,A*7A\r\n"
+  "$GNRMC,101519.00,A,5231.24722,N,01324.32802,E,9.756,27.57,141026,,,A,V*36\r\n"
+  "$GNVTG,27.57,T,,M,9.756,N,18.067,K,A*21\r\n"
+  "$GNGGA,101519.00,5231.24722,N,01324.32802,E,1,12,0.78,41.3,M,44.6,M,,*78\r\n"
+  "$GNGSA,A,3,02,12,13,15,20,25,29,,,,,,1.35,0.78,1.10,1*00\r\n"
+  "$GNGSA,A,3,66,72,81,,,,,,,,,,1.35,0.78,1.10,2*06\r\n"
+  "$GNGSA,A,3,04,09,36,,,,,,,,,,1.35,0.78,1.10,3*03\r\n"
+  "$GNGSA,A,3,07,10,,,,,,,,,,,1.35,0.78,1.10,4*0A\r\n"
+  "$GPGSV,3,1,09,02,45,120,38,05,12,040,29,12,67,280,44,13,30,200,35,1*60\r\n"
+  "$GPGSV,3,2,09,15,22,310,31,18,08,080,,20,55,170,41,25,40,095,37,1*6B\r\n"
+  "$GPGSV,3,3,09,29,18,250,33,1*58\r\n"
+  "$GLGSV,1,1,04,65,35,060,30,66,70,150,39,72,25,290,32,81,48,210,36,1*7E\r\n"
+  "$GAGSV,1,1,04,04,52,110,40,09,28,330,34,11,15,020,27,36,61,190,42,1*7D\r\n"
+  "$GBGSV,1,1,02,07,44,230,35,10,33,140,31,1*72\r\n"
+  "$GNGLL,5231.24722,N,01324.32802,E,101519.00,A,A*71\r\n"
+;
+static const uint8_t kUbxCapture[] = {
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x20, 0x2D, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F,
+  0x00, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x04, 0x6F,
+  0xFD, 0x07, 0xD0, 0xEA, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05,
+  0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF,
+  0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF,
+  0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x27, 0xE8, 0xB5, 0x62, 0x0A, 0x09, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0xB6, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x08, 0x31,
+  0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x01, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x12, 0x70, 0xFD, 0x07, 0x6A, 0xEC, 0x4D, 0x1F, 0x8C, 0x4F,
+  0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22,
+  0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF,
+  0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xBF, 0xFF, 0xB5, 0x62, 0x01, 0x07,
+  0x5C, 0x00, 0xF0, 0x34, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x02, 0x37, 0x19, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x20, 0x71, 0xFD, 0x07, 0x03, 0xEE,
+  0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08,
+  0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26,
+  0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x7B,
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xD8, 0x38, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F,
+  0x03, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x2E, 0x72,
+  0xFD, 0x07, 0x9E, 0xEF, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05,
+  0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF,
+  0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF,
+  0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0xED, 0x93, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xC0, 0x3C, 0xBA, 0x16, 0xEA, 0x07,
+  0x0A, 0x0E, 0x0A, 0x0F, 0x04, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01,
+  0xEA, 0x12, 0x3C, 0x73, 0xFD, 0x07, 0x37, 0xF1, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1,
+  0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11,
+  0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01,
+  0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x84, 0x6A, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xA8, 0x40,
+  0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x05, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x4A, 0x74, 0xFD, 0x07, 0xD2, 0xF2, 0x4D, 0x1F, 0x8C, 0x4F,
+  0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22,
+  0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF,
+  0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1C, 0x82, 0xB5, 0x62, 0x0A, 0x09,
+  0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0xB6,
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x90, 0x44, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F,
+  0x06, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x58, 0x75,
+  0xFD, 0x07, 0x6B, 0xF4, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05,
+  0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF,
+  0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF,
+  0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0xB3, 0x59, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x78, 0x48, 0xBA, 0x16, 0xEA, 0x07,
+  0x0A, 0x0E, 0x0A, 0x0F, 0x07, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01,
+  0xEA, 0x12, 0x66, 0x76, 0xFD, 0x07, 0x06, 0xF6, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1,
+  0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11,
+  0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01,
+  0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4C, 0xB0, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x60, 0x4C,
+  0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x08, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x74, 0x77, 0xFD, 0x07, 0xA0, 0xF7, 0x4D, 0x1F, 0x8C, 0x4F,
+  0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22,
+  0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF,
+  0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE3, 0x88, 0xB5, 0x62, 0x01, 0x07,
+  0x5C, 0x00, 0x48, 0x50, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x09, 0x37, 0x19, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x82, 0x78, 0xFD, 0x07, 0x39, 0xF9,
+  0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08,
+  0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26,
+  0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7A, 0x5F,
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x30, 0x54, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F,
+  0x0A, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x90, 0x79,
+  0xFD, 0x07, 0xD4, 0xFA, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05,
+  0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF,
+  0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF,
+  0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x12, 0x77, 0xB5, 0x62, 0x0A, 0x09, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0xB6, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x18, 0x58,
+  0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x0B, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x9E, 0x7A, 0xFD, 0x07, 0x6D, 0xFC, 0x4D, 0x1F, 0x8C, 0x4F,
+  0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22,
+  0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF,
+  0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA9, 0x4E, 0xB5, 0x62, 0x01, 0x07,
+  0x5C, 0x00, 0x00, 0x5C, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x0C, 0x37, 0x19, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0xAC, 0x7B, 0xFD, 0x07, 0x08, 0xFE,
+  0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08,
+  0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26,
+  0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0xA5,
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xE8, 0x5F, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F,
+  0x0D, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0xBA, 0x7C,
+  0xFD, 0x07, 0xA1, 0xFF, 0x4D, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05,
+  0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF,
+  0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF,
+  0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0xD7, 0xE2, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xD0, 0x63, 0xBA, 0x16, 0xEA, 0x07,
+  0x0A, 0x0E, 0x0A, 0x0F, 0x0E, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01,
+  0xEA, 0x12, 0xC8, 0x7D, 0xFD, 0x07, 0x3C, 0x01, 0x4E, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1,
+  0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11,
+  0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01,
+  0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x71, 0x77, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xB8, 0x67,
+  0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x0F, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0xD6, 0x7E, 0xFD, 0x07, 0xD6, 0x02, 0x4E, 0x1F, 0x8C, 0x4F,
+  0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22,
+  0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF,
+  0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x4F, 0xB5, 0x62, 0x0A, 0x09,
+  0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0xB6,
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xA0, 0x6B, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F,
+  0x10, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0xE4, 0x7F,
+  0xFD, 0x07, 0x6F, 0x04, 0x4E, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05,
+  0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF,
+  0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF,
+  0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x9F, 0x26, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x88, 0x6F, 0xBA, 0x16, 0xEA, 0x07,
+  0x0A, 0x0E, 0x0A, 0x0F, 0x11, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01,
+  0xEA, 0x12, 0xF2, 0x80, 0xFD, 0x07, 0x0A, 0x06, 0x4E, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1,
+  0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11,
+  0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01,
+  0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x7D, 0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x70, 0x73,
+  0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x12, 0x37, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x00, 0x82, 0xFD, 0x07, 0xA3, 0x07, 0x4E, 0x1F, 0x8C, 0x4F,
+  0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0x10, 0x22,
+  0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26, 0x00, 0x00, 0x20, 0xCF,
+  0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xCF, 0x58, 0xB5, 0x62, 0x01, 0x07,
+  0x5C, 0x00, 0x58, 0x77, 0xBA, 0x16, 0xEA, 0x07, 0x0A, 0x0E, 0x0A, 0x0F, 0x13, 0x37, 0x19, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x12, 0x0E, 0x83, 0xFD, 0x07, 0x3E, 0x09,
+  0x4E, 0x1F, 0x8C, 0x4F, 0x01, 0x00, 0x54, 0xA1, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x34, 0x08,
+  0x00, 0x00, 0x10, 0x22, 0x00, 0x00, 0xA8, 0x11, 0x00, 0x00, 0xE2, 0xFF, 0xFF, 0xFF, 0x66, 0x26,
+  0x00, 0x00, 0x20, 0xCF, 0x29, 0x00, 0x36, 0x01, 0x00, 0x00, 0x20, 0xBF, 0x02, 0x00, 0x87, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x68, 0xAF,
+};
+
+struct Result {
+  uint64_t cycles;
+  uint32_t worstCycles;
+  uint32_t bytes;
+  uint32_t units;      // sentences / frames accepted
+};
+
+static uint32_t timerOverhead = 0;
+
+static void calibrate() {
+  uint32_t best = UINT32_MAX;
+  for (int i = 0; i < 1000; i++) {
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    uint32_t t1 = esp_cpu_get_cycle_count();
+    if (t1 - t0 < best) best = t1 - t0;
+  }
+  timerOverhead = best;
+}
+
+static void account(Result& r, uint32_t t0, uint32_t t1) {
+  uint32_t c = t1 - t0;
+  c = c > timerOverhead ? c - timerOverhead : 0;
+  r.cycles += c;
+  if (c > r.worstCycles) r.worstCycles = c;
+}
+
+// --- encode+TXT: the original per-byte loop ---
+
+static TinyGPSPlus legacyGps;
+static char legacyLine[100];
+static size_t legacyLen = 0;
+static volatile bool antennaOpen = false;
+
+static void legacyByte(char c) {
+  legacyGps.encode(c);
+  if (c == '\n') {
+    legacyLine[legacyLen] = '\0';
+    if (strstr(legacyLine, "TXT") && strstr(legacyLine, "ANTENNA")) {
+      antennaOpen = strstr(legacyLine, "OPEN") != nullptr;
+    }
+    legacyLen = 0;
+  } else if (legacyLen < sizeof(legacyLine) - 1) {
+    legacyLine[legacyLen++] = c;
+  }
+}
+
+static Result runLegacy() {
+  Result r = {};
+  uint32_t before = legacyGps.passedChecksum();
+  for (int round = 0; round < kRounds; round++) {
+    for (size_t i = 0; i < sizeof(kNmeaCapture) - 1; i++) {
+      uint32_t t0 = esp_cpu_get_cycle_count();
+      legacyByte(kNmeaCapture[i]);
+      account(r, t0, esp_cpu_get_cycle_count());
+    }
+  }
+  r.bytes = kRounds * (sizeof(kNmeaCapture) - 1);
+  r.units = legacyGps.passedChecksum() - before;
+  return r;
+}
+
+// --- ring + framer paths ---
+
+static StaticByteRing<2048> ring;
+static TinyGPSPlus framerGps;
+static UbxParser ubxParser;
+static uint32_t ubxFrames = 0;
+
+static void feedTinyGps(const NmeaSentence& s, void*) {
+  for (size_t i = 0; i < s.size(); i++) framerGps.encode(s.at(i));
+}
+
+static void onTxt(const NmeaSentence& s, void*) {
+  if (s.contains("ANTENNA")) antennaOpen = s.contains("OPEN");
+}
+
+static void feedUbx(const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, void*) {
+  ubxParser.feed(p1, n1);
+  ubxParser.feed(p2, n2);
+}
+
+static void onUbxFrame(const UbxFrame& f, void*) {
+  UbxNavPvt pvt;
+  GnssAntenna ant;
+  static GnssFix fix;
+  if (ubxDecodeNavPvt(f, pvt)) ubxNavPvtToFix(pvt, fix);
+  else if (ubxDecodeAntenna(f, ant)) antennaOpen = ant == ANTENNA_OPEN;
+  ubxFrames++;
+}
+
+static Result runFramer(NmeaFramer& framer, const uint8_t* data, size_t len, bool ubx) {
+  Result r = {};
+  uint32_t before = ubx ? ubxFrames : framer.counters().sentences;
+  ring.clear();
+  for (int round = 0; round < kRounds; round++) {
+    for (size_t pos = 0; pos < len; pos += kChunk) {
+      size_t n = len - pos < kChunk ? len - pos : kChunk;
+      ring.write(data + pos, n);
+      uint32_t t0 = esp_cpu_get_cycle_count();
+      framer.poll(ring);
+      account(r, t0, esp_cpu_get_cycle_count());
+    }
+  }
+  r.bytes = kRounds * len;
+  r.units = (ubx ? ubxFrames : framer.counters().sentences) - before;
+  return r;
+}
+
+static void report(const char* name, const Result& r, size_t bytesPerCall) {
+  uint32_t hz = getCpuFrequencyMhz() * 1000000UL;
+  double seconds = (double)r.cycles / hz;
+  Serial.printf("%-11s %9.0f %8lu %6.1f %7lu %7.1f %6lu  (%u B/call)\n", name,
+                seconds > 0 ? r.bytes / seconds : 0.0,
+                (unsigned long)(r.units ? r.cycles / r.units : 0),
+                (double)r.cycles / r.bytes,
+                (unsigned long)r.worstCycles, (double)r.worstCycles * 1e6 / hz,
+                (unsigned long)(r.units / kRounds), (unsigned)bytesPerCall);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(500);
+  calibrate();
+  Serial.printf("GNSS parse replay: %u B NMEA, %u B UBX, %d replays, %lu MHz\n",
+                (unsigned)(sizeof(kNmeaCapture) - 1), (unsigned)sizeof(kUbxCapture), kRounds,
+                (unsigned long)getCpuFrequencyMhz());
+  Serial.println("path           bytes/s  cyc/snt  cyc/B   worst  worst us  /replay");
+
+  report("encode+TXT", runLegacy(), 1);
+
+  const uint8_t* nmea = (const uint8_t*)kNmeaCapture;
+  size_t nmeaLen = sizeof(kNmeaCapture) - 1;
+
+  NmeaFramer withGps;
+  withGps.setFrameSink(feedTinyGps);
+  withGps.on(nmeaType("TXT"), onTxt, nullptr, NMEA_MATCH_TYPE);
+  report("framer+GPS", runFramer(withGps, nmea, nmeaLen, false), kChunk);
+
+  NmeaFramer bare;
+  report("framer", runFramer(bare, nmea, nmeaLen, false), kChunk);
+
+  NmeaFramer withUbx;
+  withUbx.setBinarySink(feedUbx);
+  ubxParser.setHandler(onUbxFrame);
+  report("framer+UBX", runFramer(withUbx, kUbxCapture, sizeof(kUbxCapture), true), kChunk);
+
+  Serial.println("DONE");
+}
+
+void loop() {}
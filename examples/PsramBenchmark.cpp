@@ -0,0 +1,146 @@
+/**
+ * SRAM <-> PSRAM Move Benchmark
+ *
+ * Measures what the two-tier TrackBuffer pays for moving fix batches
+ * between internal SRAM and the PSRAM arena, with memcpy and with the
+ * GDMA copy engine (PsramArena::enableDma()).
+ *
+ * What It Does:
+ * - Reports PSRAM size and free heap per memory type
+ * - Copies 256 B .. 64 KB blocks SRAM->PSRAM, PSRAM->SRAM and SRAM->SRAM:
+ *   - memcpy: MB/s and us per copy; the PSRAM side walks through a 1 MB
+ *     block, so the figures are for cold cache lines, not cache hits
+ *   - DMA: the same copies through esp_async_memcpy, waiting for each one
+ * - TrackBuffer<256, 64> with a 1 MB PSRAM arena: cycles per push
+ *   (avg / worst, the worst being the push that spills a 1 KB batch) and
+ *   per 64-point peek out of the arena, memcpy and DMA mover
+ * - Prints a table to Serial (115200 baud); requires the board JSON with
+ *   BOARD_HAS_PSRAM and memory_type qio_qspi
+ *
+ * Usage:
+ * 1. Upload this sketch to your Heltec V4 board
+ * 2. Open the Serial Monitor at 115200 baud
+ * 3. Press RST to repeat the run
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <esp_cpu.h>
+#include "PsramArena.h"
+#include "TrackBuffer.h"
+
+static const size_t kSizes[] = { 256, 1024, 4096, 16384, 65536 };
+static const size_t kArenaBytes = 1 << 20;
+static const size_t kMaxBlock = 65536;
+
+static PsramArena arena;
+static uint8_t* sram = nullptr;     // kMaxBlock of internal, DMA-capable RAM
+static uint8_t* sram2 = nullptr;
+
+enum Direction { TO_PSRAM, FROM_PSRAM, SRAM_ONLY };
+static const char* const kDirection[] = { "SRAM->PSRAM", "PSRAM->SRAM", "SRAM->SRAM " };
+
+// MB/s of `reps` copies of `bytes`, the PSRAM address advancing through the arena
+static float measure(Direction dir, size_t bytes, bool dma, float& usPerCopy) {
+  const int reps = (int)(kArenaBytes / bytes < 64 ? 64 : kArenaBytes / bytes);
+  size_t offset = 0;
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < reps; i++) {
+    uint8_t* ps = arena.data() + offset;
+    offset = (offset + bytes) % kArenaBytes;
+    void* dst = dir == TO_PSRAM ? (void*)ps : dir == FROM_PSRAM ? (void*)sram : (void*)sram2;
+    const void* src = dir == FROM_PSRAM ? (const void*)ps : (const void*)sram;
+    if (dma) arena.copy(dst, src, bytes);
+    else memcpy(dst, src, bytes);
+  }
+  int64_t us = esp_timer_get_time() - t0;
+  usPerCopy = (float)us / reps;
+  return (float)bytes * reps / us;
+}
+
+static void copyTable(bool dma) {
+  Serial.printf("%s copies\n", dma ? "GDMA" : "memcpy");
+  Serial.println("  direction      bytes      MB/s    us/copy");
+  for (int d = 0; d < 3; d++) {
+    for (size_t bytes : kSizes) {
+      float us;
+      float mbs = measure((Direction)d, bytes, dma, us);
+      Serial.printf("  %s  %6u  %8.1f  %9.1f\n", kDirection[d], (unsigned)bytes, mbs, us);
+    }
+  }
+}
+
+// push / spill / peek costs in CPU cycles
+static void trackBufferTable(bool dma) {
+  static TrackBuffer<256, 64> buf;
+  buf.attachArena(arena.as<FixRecord>(), arena.size() / sizeof(FixRecord));
+  buf.setMover(dma ? PsramArena::move : nullptr, &arena);
+
+  FixRecord r = {};
+  uint32_t sum = 0, worst = 0;
+  const int pushes = 32768;   // 512 spills
+  for (int i = 0; i < pushes; i++) {
+    r.lat = i;
+    uint32_t c0 = esp_cpu_get_cycle_count();
+    buf.push(r);
+    uint32_t c = esp_cpu_get_cycle_count() - c0;
+    sum += c;
+    if (c > worst) worst = c;
+  }
+
+  static FixRecord out[64];
+  uint32_t peekSum = 0;
+  const int peeks = 256;
+  for (int i = 0; i < peeks; i++) {
+    uint32_t c0 = esp_cpu_get_cycle_count();
+    buf.peek(out, 64);
+    peekSum += esp_cpu_get_cycle_count() - c0;
+    buf.drop(64);
+  }
+
+  uint32_t mhz = getCpuFrequencyMhz();
+  Serial.printf("TrackBuffer<256,64>, %s mover: push avg %lu cycles, worst (spill) %lu cycles = %.1f us,"
+                " 64-point peek %lu cycles = %.1f us, %lu spills\n",
+                dma ? "GDMA" : "memcpy", (unsigned long)(sum / pushes), (unsigned long)worst,
+                (float)worst / mhz, (unsigned long)(peekSum / peeks), (float)peekSum / peeks / mhz,
+                (unsigned long)buf.stats().spills);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(500);
+  Serial.println("SRAM <-> PSRAM move benchmark");
+  Serial.printf("PSRAM %u KB, free: internal %u KB, PSRAM %u KB\n",
+                (unsigned)(ESP.getPsramSize() / 1024),
+                (unsigned)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024),
+                (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024));
+
+  sram = (uint8_t*)heap_caps_aligned_alloc(PsramArena::kAlign, kMaxBlock, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+  sram2 = (uint8_t*)heap_caps_aligned_alloc(PsramArena::kAlign, kMaxBlock, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+  if (!sram || !sram2 || !arena.begin(kArenaBytes)) {
+    Serial.println("allocation failed (no PSRAM? check BOARD_HAS_PSRAM in the board JSON)");
+    return;
+  }
+  memset(sram, 0x5A, kMaxBlock);
+  memset(arena.data(), 0, arena.size());
+
+  copyTable(false);
+  trackBufferTable(false);
+
+  if (arena.enableDma()) {
+    copyTable(true);
+    trackBufferTable(true);
+    const PsramArena::Stats& st = arena.stats();
+    Serial.printf("GDMA: %lu copies, %lu below %u B or unaligned, %lu errors\n",
+                  (unsigned long)st.dmaCopies, (unsigned long)st.cpuCopies,
+                  (unsigned)PsramArena::kDmaMinBytes, (unsigned long)st.dmaErrors);
+  } else {
+    Serial.println("esp_async_memcpy unavailable, GDMA skipped");
+  }
+}
+
+void loop() {}
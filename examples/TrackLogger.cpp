@@ -0,0 +1,227 @@
+/**
+ * GNSS Track Logger on Raw Flash
+ *
+ * Logs every navigation solution (up to 10 Hz) to the `tracklog` data
+ * partition as 16-byte binary records and exports the log over USB serial.
+ * No filesystem: records are appended to round-robin flash sectors by
+ * TrackLog (lib/GnssCore), staged in RAM and programmed one flash page
+ * (16 records) at a time. At 10 Hz that is one page write every 1.6 s
+ * and one sector erase every 25 s; the ~7.8 MB partition keeps the last
+ * ~14 hours (~6 days at 1 Hz) and drops the oldest sector when full.
+ *
+ * Requires the partition table partitions_tracklog_16MB.csv (the board
+ * JSON in this repository selects it).
+ *
+ * Pipeline:
+ * - GnssUart + NmeaFramer as in GPSwithOLED; once the receiver streams,
+ *   it is switched to UBX-NAV-PVT only at TRACK_LOG_RATE_HZ (u-blox)
+ * - every NAV-PVT with a valid date, time and position is appended
+ * - the stage is also flushed after TRACK_LOG_FLUSH_MS without a page
+ *   write, so at most that much track is lost on a power cut
+ *
+ * Serial commands (115200 baud, one per line):
+ *   info          record count, capacity, time span, wear, write errors
+ *   dump [unix]   binary export from the first record at/after `unix`:
+ *                 "TLOG <count>\n" followed by count raw 16-byte records
+ *                 (little endian FixRecord, see FixRecord.h; check
+ *                 with its CRC-8)
+ *   csv [unix]    the same as text: unix_ms,lat,lon (1e-7 deg),type,sats,hdop_class
+ *   erase         erases the whole log (~20 s)
+ * Logging pauses while an export runs.
+ *
+ * Date: October 2026
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include "GnssUart.h"
+#include "GnssPower.h"
+#include "GnssAutoDetect.h"
+#include "NmeaFramer.h"
+#include "GnssFix.h"
+#include "Ubx.h"
+#include "UbxConfig.h"
+#include "TrackLog.h"
+#include "PartitionTrackStorage.h"
+#include "HeltecV4Board.h"
+
+using GnssPins = HeltecV4::Gnss;
+
+#define TRACK_LOG_RATE_HZ    10      // 1, 2, 5 or 10
+#define TRACK_LOG_FLUSH_MS   5000    // longest time a fix stays in RAM
+#define GNSS_CONFIG_RETRY_MS 10000   // NAV-PVT setup not acknowledged: next attempt
+
+static StaticByteRing<2048> gnssRing;
+static GnssUart gnssUart;
+static NmeaFramer gnssFramer;
+static GnssPowerSequencer gnssPower;
+static UbxParser ubxParser;
+
+static PartitionTrackStorage trackFlash;
+static TrackLog trackLog;
+static bool logReady = false;
+static uint32_t lastProgramMs = 0;
+
+static void feedUbx(const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, void*) {
+  ubxParser.feed(p1, n1);
+  ubxParser.feed(p2, n2);
+}
+
+static void onSentence(const NmeaSentence&, void*) {
+  gnssPower.dataSeen();
+}
+
+static void onUbxFrame(const UbxFrame& f, void*) {
+  UbxNavPvt pvt;
+  if (!ubxDecodeNavPvt(f, pvt)) return;
+  gnssPower.dataSeen();
+
+  GnssFix fix = {};
+  ubxNavPvtToFix(pvt, fix);
+  FixRecord r;
+  fixRecordFromFix(fix, r);
+  if (logReady && fixIsComplete(r)) {
+    uint32_t programs = trackLog.stats().programs;
+    trackLog.append(r);
+    if (trackLog.stats().programs != programs) lastProgramMs = millis();
+  }
+}
+
+static void printInfo() {
+  const TrackLog::Stats& st = trackLog.stats();
+  size_t n = trackLog.count();
+  Serial.printf("log: %u/%u records, %u staged, %lu appended this boot\n",
+                (unsigned)n, (unsigned)trackLog.capacity(), (unsigned)trackLog.staged(),
+                (unsigned long)st.appended);
+
+  FixRecord first, last;
+  if (n && trackLog.read(0, first) && trackLog.read(n - 1, last)) {
+    uint32_t t0 = fixUnixSeconds(first), t1 = fixUnixSeconds(last);
+    Serial.printf("span: %lu .. %lu (%lu s)\n", (unsigned long)t0, (unsigned long)t1,
+                  (unsigned long)(t1 - t0));
+  }
+  Serial.printf("flash: %lu page writes, %lu erases, max erase count %lu, %lu recycled, %lu errors\n",
+                (unsigned long)st.programs, (unsigned long)st.erases,
+                (unsigned long)st.maxEraseCount, (unsigned long)st.recycled,
+                (unsigned long)st.writeErrors);
+}
+
+// streams the log from `from` in sector-sized reads straight to the USB port
+static void exportLog(uint32_t from, bool binary) {
+  trackLog.flush();
+  size_t index = from ? trackLog.seek(from) : 0;
+  size_t total = trackLog.count();
+
+  static FixRecord buf[TrackLog::kRecordsPerSector];
+  if (binary) Serial.printf("TLOG %u\n", (unsigned)(total - index));
+  else Serial.println("unix_ms,lat,lon,type,sats,hdop_class");
+
+  uint32_t startMs = millis();
+  while (index < total) {
+    size_t n = trackLog.read(index, buf, TrackLog::kRecordsPerSector);
+    if (!n) break;
+    if (binary) {
+      Serial.write((const uint8_t*)buf, n * sizeof(FixRecord));
+    } else {
+      for (size_t i = 0; i < n; i++) {
+        const FixRecord& r = buf[i];
+        if (!fixRecordValid(r)) continue;
+        Serial.printf("%llu,%ld,%ld,%u,%u,%u\n", (unsigned long long)fixUnixMs(r), (long)r.lat,
+                      (long)r.lon, fixType(r), fixSatellites(r), fixHdopClass(r));
+      }
+    }
+    index += n;
+  }
+  Serial.flush();
+  if (!binary) Serial.printf("# %u ms\n", (unsigned)(millis() - startMs));
+}
+
+static void handleCommand(char* line) {
+  char* arg = strchr(line, ' ');
+  if (arg) *arg++ = '\0';
+  uint32_t from = arg ? strtoul(arg, nullptr, 10) : 0;
+
+  if (!logReady) {
+    Serial.println("no tracklog partition");
+  } else if (!strcmp(line, "info")) {
+    printInfo();
+  } else if (!strcmp(line, "dump")) {
+    exportLog(from, true);
+  } else if (!strcmp(line, "csv")) {
+    exportLog(from, false);
+  } else if (!strcmp(line, "erase")) {
+    Serial.println(trackLog.erase() ? "erased" : "erase failed");
+  } else if (*line) {
+    Serial.println("commands: info, dump [unix], csv [unix], erase");
+  }
+}
+
+static void pollSerial() {
+  static char line[32];
+  static size_t len = 0;
+  while (Serial.available()) {
+    char c = (char)Serial.read();
+    if (c == '\r') continue;
+    if (c == '\n') {
+      line[len] = '\0';
+      len = 0;
+      handleCommand(line);
+    } else if (len < sizeof(line) - 1) {
+      line[len++] = c;
+    }
+  }
+}
+
+void setup() {
+  gnssFramer.setFrameSink(onSentence);
+  gnssFramer.setBinarySink(feedUbx);
+  ubxParser.setHandler(onUbxFrame);
+  gnssPower.start<GnssPins>();
+
+  GnssPortConfig port = GnssAutoDetect::defaultPort<GnssPins>();
+  GnssAutoDetect::loadSaved(port);
+  bool uartOk = gnssUart.begin(UART_NUM_1, port.rxPin, port.txPin, port.baud, gnssRing);
+
+  Serial.begin(115200);
+  Serial.println("Track logger");
+  if (!uartOk) Serial.println("GNSS UART driver install failed");
+
+  uint32_t t0 = millis();
+  logReady = trackFlash.begin() && trackLog.begin(trackFlash);
+  if (logReady) {
+    Serial.printf("tracklog partition 0x%lx, %lu KB, recovered in %lu ms\n",
+                  (unsigned long)trackFlash.partition()->address,
+                  (unsigned long)(trackFlash.size() / 1024), (unsigned long)(millis() - t0));
+    printInfo();
+  } else {
+    Serial.println("no tracklog partition (flash partitions_tracklog_16MB.csv)");
+  }
+}
+
+void loop() {
+  // short timeout: serial commands and the stage flush need a look now and then
+  gnssUart.waitForData(50);
+  gnssFramer.poll(gnssRing);
+
+  // NMEA @9600 / 1 Hz at boot; NAV-PVT only at the logging rate once it
+  // talks. Only NAV-PVT is logged, so a failed attempt is retried
+  static bool gnssConfigured = false;
+  static uint32_t lastConfigMs = 0;
+  if (!gnssConfigured && gnssPower.streaming() &&
+      (!lastConfigMs || millis() - lastConfigMs >= GNSS_CONFIG_RETRY_MS)) {
+    lastConfigMs = millis();
+    uint32_t baud = gnssBaudForRate(TRACK_LOG_RATE_HZ, UBX_EPOCH_BYTES_NAV_PVT);
+    bool ok = ubxSwitchToNavPvt(gnssUart, baud);
+    if (ok && TRACK_LOG_RATE_HZ != 1) ok = ubxSetNavRate(gnssUart, 1000 / TRACK_LOG_RATE_HZ);
+    gnssConfigured = ok;
+    Serial.printf("GNSS NAV-PVT %d Hz @%lu %s\n", TRACK_LOG_RATE_HZ, (unsigned long)baud,
+                  ok ? "configured" : "config failed, retrying (u-blox receiver?)");
+  }
+
+  if (logReady && trackLog.staged() && millis() - lastProgramMs >= TRACK_LOG_FLUSH_MS) {
+    trackLog.flush();
+    lastProgramMs = millis();
+  }
+
+  pollSerial();
+}
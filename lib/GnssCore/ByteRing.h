@@ -0,0 +1,118 @@
+/**
+ * Single-producer / single-consumer byte ring buffer
+ *
+ * Lock-free FIFO used to hand raw GNSS UART bytes from the ingest task to
+ * the parser. One task writes, one task reads; no mutex is needed because
+ * head and tail are only ever advanced by their owner.
+ *
+ * - Capacity must be a power of two (index wrap is a mask, not a modulo)
+ * - head/tail are free-running 32-bit counters, so full/empty never alias
+ * - peek() exposes the readable bytes as at most two contiguous spans, so a
+ *   consumer can parse in place and consume() afterwards without copying
+ *
+ * The header has no Arduino dependency and builds on any C++11 compiler.
+ */
+
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+class ByteRing {
+public:
+  // storage must hold `capacity` bytes; capacity must be a power of two
+  ByteRing(uint8_t* storage, size_t capacity)
+    : _buf(storage), _mask(capacity - 1), _head(0), _tail(0) {}
+
+  size_t capacity() const { return _mask + 1; }
+
+  size_t available() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+  }
+
+  size_t space() const {
+    return capacity() - (_head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire));
+  }
+
+  // --- producer side ---
+
+  // copies as much of src as fits, returns the number of bytes stored
+  size_t write(const uint8_t* src, size_t n) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    size_t room = capacity() - (head - _tail.load(std::memory_order_acquire));
+    if (n > room) n = room;
+
+    size_t at = head & _mask;
+    size_t first = capacity() - at;
+    if (first > n) first = n;
+    memcpy(_buf + at, src, first);
+    memcpy(_buf, src + first, n - first);
+
+    _head.store(head + (uint32_t)n, std::memory_order_release);
+    return n;
+  }
+
+  // --- consumer side ---
+
+  // byte at `offset` from the read position (offset < available())
+  uint8_t at(size_t offset) const {
+    return _buf[(_tail.load(std::memory_order_relaxed) + offset) & _mask];
+  }
+
+  // readable bytes as up to two spans; returns the total length
+  size_t peek(const uint8_t** p1, size_t* n1, const uint8_t** p2, size_t* n2) const {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    size_t n = _head.load(std::memory_order_acquire) - tail;
+    size_t at = tail & _mask;
+    size_t first = capacity() - at;
+    if (first > n) first = n;
+    *p1 = _buf + at;
+    *n1 = first;
+    *p2 = _buf;
+    *n2 = n - first;
+    return n;
+  }
+
+  void consume(size_t n) {
+    _tail.store(_tail.load(std::memory_order_relaxed) + (uint32_t)n, std::memory_order_release);
+  }
+
+  // copies up to n bytes out and consumes them
+  size_t read(uint8_t* dst, size_t n) {
+    const uint8_t *p1, *p2;
+    size_t n1, n2;
+    size_t avail = peek(&p1, &n1, &p2, &n2);
+    if (n > avail) n = avail;
+    size_t first = n < n1 ? n : n1;
+    memcpy(dst, p1, first);
+    memcpy(dst + first, p2, n - first);
+    consume(n);
+    return n;
+  }
+
+  // drops everything currently readable (consumer side only)
+  void clear() {
+    _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  uint8_t* _buf;
+  size_t _mask;
+  std::atomic<uint32_t> _head;   // written by the producer
+  std::atomic<uint32_t> _tail;   // written by the consumer
+};
+
+// ByteRing with its own storage
+template <size_t N>
+class StaticByteRing : public ByteRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ring capacity must be a power of two");
+public:
+  StaticByteRing() : ByteRing(_storage, N) {}
+private:
+  uint8_t _storage[N];
+};
+
+#endif // BYTE_RING_H
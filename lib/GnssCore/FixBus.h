@@ -0,0 +1,174 @@
+/**
+ * Lock-free publish/subscribe bus for fix records
+ *
+ * One producer (the GNSS parser) fans every record out to any number of
+ * consumer tasks (display, radio, logger, ...), each reading at its own
+ * rate. Two ways to read:
+ *
+ * - latest(): the most recent record from a seqlock slot. Any task, any
+ *   number of readers, never blocks the producer; a reader that raced a
+ *   publish simply copies again. For consumers that only care about "now"
+ *   (the display).
+ * - next(id): the records in order from the subscriber's own SPSC ring.
+ *   For consumers that need every epoch (logger, track uplink). A ring that
+ *   is full drops the new record for that subscriber only and counts it;
+ *   the producer never waits for a slow consumer.
+ *
+ * No mutexes and no allocation. The seqlock copies the record as 32-bit
+ * relaxed atomics between two sequence loads, so a torn copy is always
+ * detected. T must be trivially copyable; keep it small, because publish()
+ * copies it into the slot and into every ring.
+ *
+ * subscribe() is meant for setup (one task at a time); a subscriber added
+ * while the producer runs starts with the next record. The optional
+ * notify callback runs in the producer's context after each push (e.g.
+ * xTaskNotifyGive on the consumer task).
+ *
+ *   static FixBus<FixRecord, 4, 16> bus;
+ *   int8_t logSub = bus.subscribe();         // setup()
+ *   bus.publish(fix);                        // parser task
+ *   if (bus.latest(fix)) draw(fix);          // display task
+ *   while (bus.next(logSub, fix)) log(fix);  // logger task
+ *
+ * The header has no Arduino dependency and builds on any C++11 compiler.
+ */
+
+#ifndef FIX_BUS_H
+#define FIX_BUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// single-producer / single-consumer FIFO of T, N a power of two
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+  // producer side; false (nothing stored) if full
+  bool push(const T& v) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == N) return false;
+    _items[head & (N - 1)] = v;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer side; false if empty
+  bool pop(T& out) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (_head.load(std::memory_order_acquire) == tail) return false;
+    out = _items[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+  static constexpr size_t capacity() { return N; }
+
+  // consumer side: drops everything currently queued
+  void clear() { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+  T _items[N];
+  std::atomic<uint32_t> _head{0};   // written by the producer
+  std::atomic<uint32_t> _tail{0};   // written by the consumer
+};
+
+template <typename T, uint8_t MaxSubscribers = 4, size_t Depth = 16>
+class FixBus {
+public:
+  typedef void (*Notify)(void* arg);
+
+  // returns the subscriber id, -1 when the table is full
+  int8_t subscribe(Notify notify = nullptr, void* arg = nullptr) {
+    uint8_t n = _count.load(std::memory_order_relaxed);
+    if (n >= MaxSubscribers) return -1;
+    Subscriber& s = _subs[n];
+    s.ring.clear();
+    s.dropped.store(0, std::memory_order_relaxed);
+    s.notify = notify;
+    s.arg = arg;
+    _count.store((uint8_t)(n + 1), std::memory_order_release);
+    return (int8_t)n;
+  }
+
+  // --- producer side ---
+
+  void publish(const T& v) {
+    // seqlock write: odd while the slot is inconsistent
+    uint32_t words[kWords] = {};
+    memcpy(words, &v, sizeof(T));
+    uint32_t seq = _seq.load(std::memory_order_relaxed);
+    _seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; i++) _slot[i].store(words[i], std::memory_order_relaxed);
+    _seq.store(seq + 2, std::memory_order_release);
+
+    uint8_t n = _count.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; i++) {
+      Subscriber& s = _subs[i];
+      if (!s.ring.push(v)) s.dropped.fetch_add(1, std::memory_order_relaxed);
+      if (s.notify) s.notify(s.arg);
+    }
+  }
+
+  // --- consumer side ---
+
+  // newest record; false if nothing was published yet. `sequence` (optional)
+  // receives the publish count, so a reader can tell whether it is new.
+  bool latest(T& out, uint32_t* sequence = nullptr) const {
+    uint32_t words[kWords];
+    for (;;) {
+      uint32_t s1 = _seq.load(std::memory_order_acquire);
+      if (!s1) return false;
+      if (s1 & 1) continue;   // write in progress, a few hundred ns at most
+      for (size_t i = 0; i < kWords; i++) words[i] = _slot[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (_seq.load(std::memory_order_relaxed) != s1) continue;
+      memcpy(&out, words, sizeof(T));
+      if (sequence) *sequence = s1 / 2;
+      return true;
+    }
+  }
+
+  // oldest record queued for subscriber `id`; false if none
+  bool next(int8_t id, T& out) {
+    if (!valid(id)) return false;
+    return _subs[id].ring.pop(out);
+  }
+
+  size_t pending(int8_t id) const { return valid(id) ? _subs[id].ring.size() : 0; }
+  uint32_t dropped(int8_t id) const {
+    return valid(id) ? _subs[id].dropped.load(std::memory_order_relaxed) : 0;
+  }
+
+  // records published so far
+  uint32_t published() const { return _seq.load(std::memory_order_acquire) / 2; }
+  uint8_t subscribers() const { return _count.load(std::memory_order_acquire); }
+
+private:
+  static const size_t kWords = (sizeof(T) + 3) / 4;
+
+  struct Subscriber {
+    SpscRing<T, Depth> ring;
+    std::atomic<uint32_t> dropped{0};
+    Notify notify = nullptr;
+    void* arg = nullptr;
+  };
+
+  bool valid(int8_t id) const {
+    return id >= 0 && id < (int8_t)_count.load(std::memory_order_acquire);
+  }
+
+  std::atomic<uint32_t> _seq{0};
+  std::atomic<uint32_t> _slot[kWords];
+  std::atomic<uint8_t> _count{0};
+  Subscriber _subs[MaxSubscribers];
+};
+
+#endif // FIX_BUS_H
@@ -0,0 +1,133 @@
+#include "FixRecord.h"
+
+static const uint32_t kDayMs = 86400000u;
+// upper HDOP bound (0.01) of classes 1-6; class 7 is anything above
+static const uint16_t kHdopClassMax[] = { 0, 100, 200, 300, 500, 1000, 2000, 9999 };
+
+// CRC-8, polynomial 0x07
+static uint8_t crc8(const uint8_t* p, size_t n) {
+  uint8_t crc = 0;
+  while (n--) {
+    crc ^= *p++;
+    for (uint8_t b = 0; b < 8; b++) crc = crc & 0x80 ? (uint8_t)(crc << 1 ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+int32_t fixCoord1e7(const GnssCoord& c) {
+  int32_t v = (int32_t)c.deg * 10000000L + (int32_t)(c.billionths / 100);
+  return c.negative ? -v : v;
+}
+
+GnssCoord fixCoordFrom1e7(int32_t v) {
+  GnssCoord c;
+  uint32_t a = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+  c.negative = v < 0;
+  c.deg = (uint16_t)(a / 10000000UL);
+  c.billionths = (a % 10000000UL) * 100;
+  return c;
+}
+
+static uint8_t hdopClass(uint16_t hdop) {
+  if (!hdop) return 0;
+  uint8_t c = 1;
+  while (c < 7 && hdop > kHdopClassMax[c]) c++;
+  return c;
+}
+
+void fixRecordSetQuality(FixRecord& r, FixType type, uint8_t satellites, uint16_t hdop) {
+  r.week = (uint16_t)(fixWeek(r) | (uint16_t)type << 13);
+  r.quality = (uint8_t)((satellites > 31 ? 31 : satellites) | hdopClass(hdop) << 5);
+}
+
+void fixRecordSetAntenna(FixRecord& r, GnssAntenna antenna) {
+  r.time = (r.time & FIX_TOW_NONE) | (uint32_t)antenna << 30;
+}
+
+void fixRecordSetTime(FixRecord& r, uint64_t unixMs) {
+  uint32_t week = 0, tow = 0;
+  if (unixMs >= (FIX_UNIX_1980 + 7 * 86400ULL) * 1000) {
+    uint64_t ms = unixMs - FIX_UNIX_1980 * 1000ULL;
+    week = (uint32_t)(ms / FIX_WEEK_MS);
+    tow = (uint32_t)(ms % FIX_WEEK_MS);
+    if (week > 0x1FFF) week = 0;   // past 2137: keep the time of day only
+  }
+  if (!week) tow = (uint32_t)(unixMs % kDayMs);
+  r.time = (r.time & ~FIX_TOW_NONE) | tow;
+  r.week = (uint16_t)((r.week & 0xE000) | week);
+}
+
+void fixRecordFromFix(const GnssFix& fix, FixRecord& out) {
+  out = FixRecord();
+  if (fix.locationValid) {
+    out.lat = fixCoord1e7(fix.lat);
+    out.lon = fixCoord1e7(fix.lon);
+  }
+
+  out.time = FIX_TOW_NONE;
+  if (fix.timeValid) {
+    uint32_t dayMs = ((fix.hour * 60u + fix.minute) * 60u + fix.second) * 1000u + fix.centisecond * 10u;
+    int64_t unixS = fix.dateValid ? gnssUnixSeconds(fix) : -1;
+    if (unixS >= 0) fixRecordSetTime(out, (uint64_t)unixS * 1000 + dayMs % 1000);
+    else out.time = dayMs;
+  }
+  fixRecordSetAntenna(out, fix.antenna);
+
+  FixType type = fix.fixType;
+  if (type == FIX_TYPE_NONE) {
+    type = fix.locationValid ? FIX_TYPE_POSITION : fix.timeValid ? FIX_TYPE_TIME_ONLY : FIX_TYPE_NONE;
+  }
+  fixRecordSetQuality(out, type, fix.satellites, fix.hdop);
+}
+
+// civil date of a day number since 1970-01-01 (civil-from-days)
+static void civilFromDays(int32_t z, uint16_t& year, uint8_t& month, uint8_t& day) {
+  z += 719468;
+  int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+  uint32_t doe = (uint32_t)(z - era * 146097);
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;                 // March = 0
+  day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+  month = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+  year = (uint16_t)((int32_t)yoe + era * 400 + (month <= 2));
+}
+
+void fixRecordToFix(const FixRecord& r, GnssFix& out) {
+  out = GnssFix();
+  out.locationValid = fixHasPosition(r);
+  if (out.locationValid) {
+    out.lat = fixCoordFrom1e7(r.lat);
+    out.lon = fixCoordFrom1e7(r.lon);
+  }
+
+  out.timeValid = fixHasTime(r);
+  if (out.timeValid) {
+    uint32_t ms = fixTowMs(r) % kDayMs;
+    out.hour = (uint8_t)(ms / 3600000);
+    out.minute = (uint8_t)(ms / 60000 % 60);
+    out.second = (uint8_t)(ms / 1000 % 60);
+    out.centisecond = (uint8_t)(ms % 1000 / 10);
+  }
+  out.dateValid = fixHasDate(r);
+  if (out.dateValid) {
+    civilFromDays((int32_t)((fixUnixMs(r) / 1000) / 86400), out.year, out.month, out.day);
+  }
+
+  out.antenna = fixAntenna(r);
+  out.fixType = fixType(r);
+  out.satellites = fixSatellites(r);
+  out.hdop = fixHdopMax(r);
+}
+
+uint16_t fixHdopMax(const FixRecord& r) {
+  return kHdopClassMax[fixHdopClass(r)];
+}
+
+void fixRecordSeal(FixRecord& r) {
+  r.check = crc8((const uint8_t*)&r, sizeof(r) - 1);
+}
+
+bool fixRecordValid(const FixRecord& r) {
+  return r.time != 0xFFFFFFFF && r.check == crc8((const uint8_t*)&r, sizeof(r) - 1);
+}
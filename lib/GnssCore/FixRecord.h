@@ -0,0 +1,105 @@
+/**
+ * Compact 16-byte fix record, the in-memory format of every fix consumer
+ *
+ * GnssFix keeps the receiver's split fields (degrees + billionths, hour /
+ * minute / second / centisecond) for formatting. Everything that stores or
+ * moves fixes in bulk - the fix bus, the uplink queue, the flash log, the
+ * LoRa encoder - uses this packed record instead: four 32-bit words, no
+ * padding, so it copies as four word stores and a 32-byte cache line holds
+ * exactly two. 4096 of them are 64 KB, a fifth of the 320 KB of internal
+ * SRAM the application may use, without touching PSRAM.
+ *
+ * Layout (little endian):
+ *
+ *   lat      int32   1e-7 deg
+ *   lon      int32   1e-7 deg
+ *   time     bits 0-29  ms into the UTC week (FIX_TOW_NONE = no time)
+ *            bits 30-31 antenna (GnssAntenna)
+ *   week     bits 0-12  UTC weeks since 1980-01-06 (0 = no date; the time
+ *                       is then the ms of the day)
+ *            bits 13-15 FixType
+ *   quality  bits 0-4   satellites used (saturates at 31)
+ *            bits 5-7   HDOP class: 0 unknown, 1 <= 1, 2 <= 2, 3 <= 3,
+ *                       4 <= 5, 5 <= 10, 6 <= 20, 7 > 20
+ *   check    CRC-8 (polynomial 0x07) of the first 15 bytes, set by
+ *            fixRecordSeal() where records are stored (flash log)
+ *
+ * Weeks and week-ms count UTC, like the GPS week numbering but without
+ * the leap-second offset, so fixUnixMs() is plain arithmetic. 13 bits of
+ * week run until 2137. A record of all 1 bits (erased flash) has antenna
+ * value 3 and is never valid.
+ *
+ * Precision: 1e-7 deg is ~1.1 cm; formatCoordinate() of fixRecordToFix()
+ * prints the same six decimals as the receiver's billionths.
+ */
+
+#ifndef FIX_RECORD_H
+#define FIX_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GnssFix.h"
+
+#define FIX_TOW_NONE  0x3FFFFFFFu
+#define FIX_UNIX_1980 315964800u    // 1980-01-06 00:00:00 UTC, week 0
+#define FIX_WEEK_MS   604800000u
+
+struct FixRecord {
+  int32_t lat;        // 1e-7 deg
+  int32_t lon;        // 1e-7 deg
+  uint32_t time;      // week-ms | antenna << 30
+  uint16_t week;      // week | FixType << 13
+  uint8_t quality;    // satellites | HDOP class << 5
+  uint8_t check;      // CRC-8 of the first 15 bytes
+};
+
+static_assert(sizeof(FixRecord) == 16, "FixRecord must stay 16 bytes");
+
+inline uint32_t fixTowMs(const FixRecord& r) { return r.time & FIX_TOW_NONE; }
+inline GnssAntenna fixAntenna(const FixRecord& r) { return (GnssAntenna)(r.time >> 30); }
+inline uint16_t fixWeek(const FixRecord& r) { return r.week & 0x1FFF; }
+inline FixType fixType(const FixRecord& r) { return (FixType)(r.week >> 13); }
+inline uint8_t fixSatellites(const FixRecord& r) { return r.quality & 0x1F; }
+inline uint8_t fixHdopClass(const FixRecord& r) { return r.quality >> 5; }
+
+inline bool fixHasTime(const FixRecord& r) { return fixTowMs(r) != FIX_TOW_NONE; }
+inline bool fixHasDate(const FixRecord& r) { return fixHasTime(r) && fixWeek(r) != 0; }
+inline bool fixHasPosition(const FixRecord& r) {
+  FixType t = fixType(r);
+  return (t >= FIX_TYPE_2D && t <= FIX_TYPE_GNSS_DR) || t == FIX_TYPE_POSITION;
+}
+// what a track point needs: date, time and position
+inline bool fixIsComplete(const FixRecord& r) { return fixHasDate(r) && fixHasPosition(r); }
+
+// ms / seconds since 1970-01-01 UTC; 0 without a date
+inline uint64_t fixUnixMs(const FixRecord& r) {
+  if (!fixHasDate(r)) return 0;
+  return FIX_UNIX_1980 * 1000ULL + (uint64_t)fixWeek(r) * FIX_WEEK_MS + fixTowMs(r);
+}
+inline uint32_t fixUnixSeconds(const FixRecord& r) { return (uint32_t)(fixUnixMs(r) / 1000); }
+
+// 1e-7 deg from degrees + billionths (truncated, like the receiver's output)
+int32_t fixCoord1e7(const GnssCoord& c);
+GnssCoord fixCoordFrom1e7(int32_t v);
+
+// packs a snapshot: position if locationValid, time if timeValid (week 0
+// unless dateValid too); the type is derived when the fix has none
+void fixRecordFromFix(const GnssFix& fix, FixRecord& out);
+// expands a record for the formatters (centiseconds truncated, HDOP as
+// the upper bound of its class)
+void fixRecordToFix(const FixRecord& r, GnssFix& out);
+
+// sets week and week-ms from Unix ms (no date before 1980-01-13)
+void fixRecordSetTime(FixRecord& r, uint64_t unixMs);
+// hdop in 0.01, 0 = unknown
+void fixRecordSetQuality(FixRecord& r, FixType type, uint8_t satellites, uint16_t hdop);
+void fixRecordSetAntenna(FixRecord& r, GnssAntenna antenna);
+// HDOP (0.01) as the upper bound of the record's class, 0 = unknown
+uint16_t fixHdopMax(const FixRecord& r);
+
+// CRC-8 over the first 15 bytes
+void fixRecordSeal(FixRecord& r);
+// false for an erased slot or a torn / unsealed record
+bool fixRecordValid(const FixRecord& r);
+
+#endif // FIX_RECORD_H
@@ -0,0 +1,329 @@
+#include "Geofence.h"
+#include <string.h>
+#include "LocalFrame.h"
+
+static const int64_t kMaxPolygonSpan = 1LL << 30;   // ~107 deg, keeps the crossing products in int64
+
+// CRC-32 (IEEE, reflected), bitwise: runs once per load
+static uint32_t blobCrc32(const uint8_t* p, size_t n, uint32_t crc = 0) {
+  crc = ~crc;
+  while (n--) {
+    crc ^= *p++;
+    for (uint8_t b = 0; b < 8; b++) crc = crc & 1 ? crc >> 1 ^ 0xEDB88320u : crc >> 1;
+  }
+  return ~crc;
+}
+
+static size_t blobSize(uint16_t zones, uint32_t vertices) {
+  return sizeof(GeofenceHeader) + (size_t)zones * sizeof(GeofenceZone) + (size_t)vertices * sizeof(GeofenceVertex);
+}
+
+// --- Geofence ---
+
+bool Geofence::load(const void* blob, size_t len) {
+  return load(blob, len, Config());
+}
+
+bool Geofence::load(const void* blob, size_t len, const Config& config) {
+  unload();
+  if (!blob || ((uintptr_t)blob & 3) || len < sizeof(GeofenceHeader)) return false;
+  const GeofenceHeader* h = (const GeofenceHeader*)blob;
+  if (h->magic != GEOFENCE_MAGIC || h->zones == 0 || h->zones > kMaxZones) return false;
+  if ((uint64_t)h->vertices * sizeof(GeofenceVertex) > len || blobSize(h->zones, h->vertices) > len) return false;
+
+  const uint8_t* body = (const uint8_t*)(h + 1);
+  if (blobCrc32(body, blobSize(h->zones, h->vertices) - sizeof(GeofenceHeader)) != h->crc) return false;
+
+  const GeofenceZone* zones = (const GeofenceZone*)body;
+  int32_t minLat = INT32_MAX, minLon = INT32_MAX, maxLat = INT32_MIN, maxLon = INT32_MIN;
+  for (uint16_t i = 0; i < h->zones; i++) {
+    const GeofenceZone& z = zones[i];
+    if (z.minLat > z.maxLat || z.minLon > z.maxLon) return false;
+    if (z.shape == GEOFENCE_CIRCLE) {
+      if (!z.radiusMm) return false;
+    } else if (z.shape == GEOFENCE_POLYGON) {
+      if (z.count < 3 || z.count > kMaxVertices || (uint64_t)z.first + z.count > h->vertices) return false;
+      if ((int64_t)z.maxLat - z.minLat >= kMaxPolygonSpan || (int64_t)z.maxLon - z.minLon >= kMaxPolygonSpan) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    if (z.minLat < minLat) minLat = z.minLat;
+    if (z.minLon < minLon) minLon = z.minLon;
+    if (z.maxLat > maxLat) maxLat = z.maxLat;
+    if (z.maxLon > maxLon) maxLon = z.maxLon;
+  }
+
+  _minLat = minLat;
+  _minLon = minLon;
+  _cellLat = (uint32_t)(((int64_t)maxLat - minLat) / kGrid + 1);
+  _cellLon = (uint32_t)(((int64_t)maxLon - minLon) / kGrid + 1);
+
+  // counts per cell, running sums (= end of each cell), then filled from
+  // the ends down, which leaves _cellStart[c] at the start of cell c
+  const uint16_t cells = kGrid * kGrid;
+  memset(_cellStart, 0, sizeof(_cellStart));
+  uint32_t refs = 0;
+  for (uint16_t i = 0; i < h->zones; i++) {
+    uint32_t y0, y1, x0, x1;
+    cellRange(zones[i], y0, y1, x0, x1);
+    refs += (y1 - y0 + 1) * (x1 - x0 + 1);
+    if (refs > kMaxRefs) return false;
+    for (uint32_t y = y0; y <= y1; y++) {
+      for (uint32_t x = x0; x <= x1; x++) _cellStart[y * kGrid + x]++;
+    }
+  }
+  _maxCellZones = 0;
+  for (uint16_t c = 0; c < cells; c++) {
+    if (_cellStart[c] > _maxCellZones) _maxCellZones = _cellStart[c];
+    if (c) _cellStart[c] += _cellStart[c - 1];
+  }
+  _cellStart[cells] = (uint16_t)refs;
+  for (uint16_t i = 0; i < h->zones; i++) {
+    uint32_t y0, y1, x0, x1;
+    cellRange(zones[i], y0, y1, x0, x1);
+    for (uint32_t y = y0; y <= y1; y++) {
+      for (uint32_t x = x0; x <= x1; x++) _refs[--_cellStart[y * kGrid + x]] = i;
+    }
+  }
+
+  _zones = zones;
+  _vertices = (const GeofenceVertex*)(zones + h->zones);
+  _zoneCount = h->zones;
+  _vertexCount = h->vertices;
+  _cfg = config;
+  if (!_cfg.confirmFixes) _cfg.confirmFixes = 1;
+  memset(_state, 0, sizeof(_state));
+  _insideCount = 0;
+  return true;
+}
+
+void Geofence::unload() {
+  _zones = nullptr;
+  _vertices = nullptr;
+  _zoneCount = 0;
+  _vertexCount = 0;
+  _insideCount = 0;
+  _maxCellZones = 0;
+}
+
+int16_t Geofence::find(uint16_t id) const {
+  for (uint16_t i = 0; i < _zoneCount; i++) {
+    if (_zones[i].id == id) return (int16_t)i;
+  }
+  return -1;
+}
+
+void Geofence::cellRange(const GeofenceZone& z, uint32_t& y0, uint32_t& y1, uint32_t& x0, uint32_t& x1) const {
+  y0 = (uint32_t)(((int64_t)z.minLat - _minLat) / _cellLat);
+  y1 = (uint32_t)(((int64_t)z.maxLat - _minLat) / _cellLat);
+  x0 = (uint32_t)(((int64_t)z.minLon - _minLon) / _cellLon);
+  x1 = (uint32_t)(((int64_t)z.maxLon - _minLon) / _cellLon);
+}
+
+bool Geofence::cellOf(int32_t lat, int32_t lon, uint16_t& cell) const {
+  if (lat < _minLat || lon < _minLon) return false;
+  uint32_t y = (uint32_t)(((int64_t)lat - _minLat) / _cellLat);
+  uint32_t x = (uint32_t)(((int64_t)lon - _minLon) / _cellLon);
+  if (y >= kGrid || x >= kGrid) return false;
+  cell = (uint16_t)(y * kGrid + x);
+  return true;
+}
+
+// ray crossing towards +lon, on coordinates relative to the fix
+bool Geofence::polygonContains(const GeofenceZone& z, int32_t lat, int32_t lon) const {
+  const GeofenceVertex* v = _vertices + z.first;
+  int64_t ax = (int64_t)v[z.count - 1].lon - lon, ay = (int64_t)v[z.count - 1].lat - lat;
+  bool in = false;
+  for (uint16_t i = 0; i < z.count; i++) {
+    int64_t bx = (int64_t)v[i].lon - lon, by = (int64_t)v[i].lat - lat;
+    if ((ay > 0) != (by > 0)) {
+      // the edge crosses the fix's latitude at x = num / den
+      int64_t num = ax * by - bx * ay;
+      int64_t den = by - ay;
+      if (num != 0 && (num > 0) == (den > 0)) in = !in;
+    }
+    ax = bx;
+    ay = by;
+  }
+  return in;
+}
+
+bool Geofence::contains(uint16_t index, int32_t lat, int32_t lon) const {
+  const GeofenceZone& z = _zones[index];
+  if (lat < z.minLat || lat > z.maxLat || lon < z.minLon || lon > z.maxLon) return false;
+  if (z.shape == GEOFENCE_POLYGON) return polygonContains(z, lat, lon);
+
+  LocalFrame frame;
+  frame.setOrigin(z.lat, z.lon);
+  int32_t e, n;
+  frame.toLocal(lat, lon, e, n);
+  return (int64_t)e * e + (int64_t)n * n <= (int64_t)z.radiusMm * z.radiusMm;
+}
+
+void Geofence::observe(uint16_t index, bool in, Event* events, uint8_t maxEvents, uint8_t& n) {
+  ZoneState& s = _state[index];
+  bool consecutive = s.seen == (uint16_t)(_updateSeq - 1);
+  s.seen = _updateSeq;
+  if (in == s.in) {
+    s.pending = 0;
+    return;
+  }
+  s.pending = consecutive && s.pending < 255 ? s.pending + 1 : 1;
+  if (s.pending < _cfg.confirmFixes) return;
+  s.pending = 0;
+
+  if (in) {
+    if (_insideCount == kMaxInside) {
+      _stats.insideFull++;
+      return;
+    }
+    _inside[_insideCount++] = index;
+  } else {
+    for (uint8_t i = 0; i < _insideCount; i++) {
+      if (_inside[i] == index) {
+        _inside[i] = _inside[--_insideCount];
+        break;
+      }
+    }
+  }
+  s.in = in;
+  _stats.transitions++;
+  if (n < maxEvents) {
+    events[n].zone = index;
+    events[n].entered = in;
+    n++;
+  } else {
+    _stats.eventsDropped++;
+  }
+}
+
+uint8_t Geofence::update(int32_t lat, int32_t lon, Event* events, uint8_t maxEvents) {
+  uint8_t n = 0;
+  if (!_zones) return 0;
+  _updateSeq++;
+  _stats.updates++;
+
+  uint16_t tests = 0, cell;
+  if (cellOf(lat, lon, cell)) {
+    for (uint16_t r = _cellStart[cell]; r < _cellStart[cell + 1]; r++) {
+      uint16_t i = _refs[r];
+      const GeofenceZone& z = _zones[i];
+      bool in = false;
+      if (lat >= z.minLat && lat <= z.maxLat && lon >= z.minLon && lon <= z.maxLon) {
+        tests++;
+        if (z.shape == GEOFENCE_POLYGON) _stats.edgeTests += z.count;
+        in = contains(i, lat, lon);
+      }
+      observe(i, in, events, maxEvents, n);
+    }
+  }
+
+  // zones held as inside whose box no longer reaches the fix's cell
+  uint16_t held[kMaxInside];
+  uint8_t heldCount = _insideCount;
+  memcpy(held, _inside, heldCount * sizeof(held[0]));
+  for (uint8_t k = 0; k < heldCount; k++) {
+    if (_state[held[k]].seen != _updateSeq) observe(held[k], false, events, maxEvents, n);
+  }
+
+  _stats.zoneTests += tests;
+  if (tests > _stats.maxTests) _stats.maxTests = tests;
+  return n;
+}
+
+void Geofence::save(State& out) const {
+  out.count = _insideCount;
+  memcpy(out.zones, _inside, sizeof(out.zones));
+}
+
+void Geofence::restore(const State& in) {
+  for (uint8_t i = 0; i < _insideCount; i++) _state[_inside[i]].in = false;
+  _insideCount = 0;
+  for (uint8_t i = 0; i < in.count && i < kMaxInside; i++) {
+    uint16_t z = in.zones[i];
+    if (z >= _zoneCount || _state[z].in) continue;
+    _state[z].in = true;
+    _inside[_insideCount++] = z;
+  }
+}
+
+// --- GeofenceWriter ---
+
+GeofenceWriter::GeofenceWriter(void* buffer, size_t capacity, uint16_t maxZones)
+  : _buf((uint8_t*)buffer), _cap(capacity), _maxZones(maxZones) {
+  _overflow = !buffer || ((uintptr_t)buffer & 3) || blobSize(maxZones, 0) > capacity;
+}
+
+GeofenceZone* GeofenceWriter::add(uint16_t id, uint8_t shape, const char* name, uint8_t flags) {
+  if (_overflow || _zones == _maxZones) {
+    _overflow = true;
+    return nullptr;
+  }
+  GeofenceZone* z = (GeofenceZone*)(_buf + sizeof(GeofenceHeader)) + _zones++;
+  memset(z, 0, sizeof(*z));
+  z->id = id;
+  z->shape = shape;
+  z->flags = flags;
+  for (size_t i = 0; name && i < sizeof(z->name) && name[i]; i++) z->name[i] = name[i];
+  return z;
+}
+
+bool GeofenceWriter::addCircle(uint16_t id, int32_t lat, int32_t lon, uint32_t radiusMm,
+                               const char* name, uint8_t flags) {
+  if (!radiusMm || radiusMm > 200000000) return false;   // 200 km
+  GeofenceZone* z = add(id, GEOFENCE_CIRCLE, name, flags);
+  if (!z) return false;
+  LocalFrame frame;
+  frame.setOrigin(lat, lon);
+  frame.toGlobal(-(int32_t)radiusMm, -(int32_t)radiusMm, z->minLat, z->minLon);
+  frame.toGlobal((int32_t)radiusMm, (int32_t)radiusMm, z->maxLat, z->maxLon);
+  z->lat = lat;
+  z->lon = lon;
+  z->radiusMm = radiusMm;
+  return true;
+}
+
+bool GeofenceWriter::addPolygon(uint16_t id, const GeofenceVertex* vertices, uint16_t count,
+                                const char* name, uint8_t flags) {
+  if (count < 3 || count > Geofence::kMaxVertices) return false;
+  if (blobSize(_maxZones, _vertices + count) > _cap) {
+    _overflow = true;
+    return false;
+  }
+  GeofenceZone* z = add(id, GEOFENCE_POLYGON, name, flags);
+  if (!z) return false;
+
+  GeofenceVertex* out = (GeofenceVertex*)(_buf + blobSize(_maxZones, 0)) + _vertices;
+  memcpy(out, vertices, count * sizeof(GeofenceVertex));
+  z->minLat = z->maxLat = vertices[0].lat;
+  z->minLon = z->maxLon = vertices[0].lon;
+  for (uint16_t i = 1; i < count; i++) {
+    if (vertices[i].lat < z->minLat) z->minLat = vertices[i].lat;
+    if (vertices[i].lat > z->maxLat) z->maxLat = vertices[i].lat;
+    if (vertices[i].lon < z->minLon) z->minLon = vertices[i].lon;
+    if (vertices[i].lon > z->maxLon) z->maxLon = vertices[i].lon;
+  }
+  z->first = _vertices;
+  z->count = count;
+  _vertices += count;
+  return true;
+}
+
+size_t GeofenceWriter::finish() {
+  if (_overflow || !_zones) return 0;
+  // vertices move down behind the last zone record actually used
+  uint8_t* from = _buf + blobSize(_maxZones, 0);
+  uint8_t* to = _buf + blobSize(_zones, 0);
+  memmove(to, from, _vertices * sizeof(GeofenceVertex));
+
+  GeofenceHeader* h = (GeofenceHeader*)_buf;
+  h->magic = GEOFENCE_MAGIC;
+  h->zones = _zones;
+  h->reserved = 0;
+  h->vertices = _vertices;
+  size_t size = blobSize(_zones, _vertices);
+  h->crc = blobCrc32(_buf + sizeof(GeofenceHeader), size - sizeof(GeofenceHeader));
+  return size;
+}
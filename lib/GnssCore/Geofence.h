@@ -0,0 +1,213 @@
+/**
+ * Geofence zones with a grid index, evaluated once per fix
+ *
+ * Raises enter / exit transitions for hundreds of circles and polygons so
+ * a tracker can alert locally and uplink on a transition instead of on
+ * every fix. The zones come as one read-only blob, typically the
+ * memory-mapped "geofence" flash partition (PartitionGeofence) or a const
+ * array; load() only builds the index in RAM, zone records and vertices
+ * stay where they are.
+ *
+ * Blob (little endian, 4-byte aligned, built by GeofenceWriter):
+ *
+ *   GeofenceHeader   magic "GFZ1", zone and vertex counts, CRC-32 of the rest
+ *   GeofenceZone[]   id, shape, flags, bounding box, circle centre + radius
+ *                    or polygon vertex range, name
+ *   GeofenceVertex[] polygon corners, lat/lon in 1e-7 deg
+ *
+ * Index: a kGrid x kGrid grid over the bounding box of all zones, each
+ * cell listing the zones whose bounding box touches it (kMaxRefs entries
+ * in all). A fix costs one cell lookup, then a box test and a shape test
+ * for each zone of that cell, plus a recheck of the zones the receiver is
+ * inside (at most kMaxInside). The worst case is known after load():
+ * maxCellZones() zones of at most kMaxVertices edges each.
+ *
+ * Shapes: circles are tested in mm on a LocalFrame at the centre,
+ * polygons by ray crossing on the integer coordinates (int64 products
+ * relative to the fix, no floating point). Zones must not cross the
+ * 180 deg meridian.
+ *
+ * Debounce: a zone only changes state after Config::confirmFixes
+ * consecutive fixes agree, so a noisy fix on the boundary does not send
+ * enter / exit pairs. Use 1 when fixes are minutes apart (deep sleep).
+ *
+ * Usage:
+ *   static Geofence fence;
+ *   fence.load(blob, blobSize);
+ *   Geofence::Event ev[4];
+ *   uint8_t n = fence.update(record.lat, record.lon, ev, 4);
+ *   for (uint8_t i = 0; i < n; i++) ... fence.zone(ev[i].zone).name ...
+ */
+
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GEOFENCE_MAGIC 0x315A4647u   // "GFZ1"
+
+enum GeofenceShape : uint8_t {
+  GEOFENCE_CIRCLE = 1,
+  GEOFENCE_POLYGON
+};
+
+// per-zone reaction to a transition (the application decides what they mean)
+enum GeofenceFlags : uint8_t {
+  GEOFENCE_ALERT = 0x01,    // local alert (screen, buzzer)
+  GEOFENCE_UPLINK = 0x02    // send the transition
+};
+
+struct GeofenceHeader {
+  uint32_t magic;
+  uint16_t zones;
+  uint16_t reserved;
+  uint32_t vertices;
+  uint32_t crc;             // CRC-32 of zones and vertices
+};
+
+struct GeofenceZone {
+  uint16_t id;
+  uint8_t shape;            // GeofenceShape
+  uint8_t flags;            // GeofenceFlags
+  int32_t minLat, minLon;   // bounding box, 1e-7 deg
+  int32_t maxLat, maxLon;
+  int32_t lat, lon;         // circle centre
+  uint32_t radiusMm;        // circle
+  uint32_t first;           // polygon: first vertex
+  uint16_t count;           // polygon: vertices (3..kMaxVertices)
+  uint16_t reserved;
+  char name[12];            // NUL-terminated unless 12 characters long
+};
+
+struct GeofenceVertex {
+  int32_t lat, lon;
+};
+
+static_assert(sizeof(GeofenceHeader) == 16, "GeofenceHeader layout");
+static_assert(sizeof(GeofenceZone) == 52, "GeofenceZone layout");
+
+class Geofence {
+public:
+  static const uint16_t kMaxZones = 512;
+  static const uint8_t kGrid = 32;          // cells per side
+  static const uint16_t kMaxRefs = 4096;    // zone entries over all cells
+  static const uint8_t kMaxInside = 16;     // zones the receiver may be inside at once
+  static const uint16_t kMaxVertices = 64;
+
+  struct Config {
+    uint8_t confirmFixes = 2;   // consecutive fixes before a zone changes state
+  };
+
+  struct Event {
+    uint16_t zone;              // index for zone()
+    bool entered;               // false = left
+  };
+
+  struct Stats {
+    uint32_t updates;
+    uint32_t zoneTests;         // shape tests (after the box test)
+    uint32_t edgeTests;         // polygon edges visited
+    uint16_t maxTests;          // zones tested by one update()
+    uint32_t transitions;
+    uint32_t eventsDropped;     // more transitions than the caller's array
+    uint32_t insideFull;        // entries refused, kMaxInside zones already
+  };
+
+  // zones currently inside, to carry across deep sleep (RTC memory)
+  struct State {
+    uint8_t count;
+    uint16_t zones[kMaxInside];
+  };
+
+  // checks the blob and builds the grid; false (nothing loaded) if the
+  // blob is damaged, misaligned or exceeds a limit. It must stay mapped.
+  bool load(const void* blob, size_t len);
+  bool load(const void* blob, size_t len, const Config& config);
+  void unload();
+  bool loaded() const { return _zones != nullptr; }
+
+  uint16_t zoneCount() const { return _zoneCount; }
+  const GeofenceZone& zone(uint16_t index) const { return _zones[index]; }
+  // index of the zone with that id, -1 if none
+  int16_t find(uint16_t id) const;
+
+  // evaluates one fix; writes up to maxEvents transitions, returns their
+  // number (further ones still take effect and are counted as dropped)
+  uint8_t update(int32_t lat, int32_t lon, Event* events, uint8_t maxEvents);
+
+  // shape test only, no index and no state
+  bool contains(uint16_t index, int32_t lat, int32_t lon) const;
+
+  uint8_t insideCount() const { return _insideCount; }
+  uint16_t inside(uint8_t i) const { return _inside[i]; }
+
+  void save(State& out) const;
+  void restore(const State& in);
+
+  // worst-case zone tests per fix: largest cell list (+ insideCount())
+  uint16_t maxCellZones() const { return _maxCellZones; }
+
+  const Stats& stats() const { return _stats; }
+  void resetStats() { _stats = Stats(); }
+
+private:
+  struct ZoneState {
+    uint16_t seen;       // update() that last tested the zone
+    uint8_t pending;     // consecutive fixes disagreeing with `in`
+    bool in;
+  };
+
+  bool polygonContains(const GeofenceZone& z, int32_t lat, int32_t lon) const;
+  void observe(uint16_t index, bool in, Event* events, uint8_t maxEvents, uint8_t& n);
+  bool cellOf(int32_t lat, int32_t lon, uint16_t& cell) const;
+  void cellRange(const GeofenceZone& z, uint32_t& y0, uint32_t& y1, uint32_t& x0, uint32_t& x1) const;
+
+  const GeofenceZone* _zones = nullptr;
+  const GeofenceVertex* _vertices = nullptr;
+  uint16_t _zoneCount = 0;
+  uint32_t _vertexCount = 0;
+  Config _cfg;
+
+  // grid: cell c lists _refs[_cellStart[c] .. _cellStart[c + 1])
+  int32_t _minLat = 0, _minLon = 0;
+  uint32_t _cellLat = 1, _cellLon = 1;   // cell size, 1e-7 deg
+  uint16_t _cellStart[kGrid * kGrid + 1] = {};
+  uint16_t _refs[kMaxRefs] = {};
+  uint16_t _maxCellZones = 0;
+
+  ZoneState _state[kMaxZones] = {};
+  uint16_t _inside[kMaxInside] = {};
+  uint8_t _insideCount = 0;
+  uint16_t _updateSeq = 0;
+  Stats _stats = {};
+};
+
+// builds a zone blob in a caller buffer (host tools, downlinked zone lists)
+class GeofenceWriter {
+public:
+  // room for up to maxZones zone records, vertices after them
+  GeofenceWriter(void* buffer, size_t capacity, uint16_t maxZones);
+
+  bool addCircle(uint16_t id, int32_t lat, int32_t lon, uint32_t radiusMm,
+                 const char* name, uint8_t flags = GEOFENCE_ALERT | GEOFENCE_UPLINK);
+  // vertices in order (either direction), the closing edge is implied
+  bool addPolygon(uint16_t id, const GeofenceVertex* vertices, uint16_t count,
+                  const char* name, uint8_t flags = GEOFENCE_ALERT | GEOFENCE_UPLINK);
+
+  // closes the zone table and seals the blob; its size, 0 if anything
+  // did not fit
+  size_t finish();
+
+private:
+  GeofenceZone* add(uint16_t id, uint8_t shape, const char* name, uint8_t flags);
+
+  uint8_t* _buf;
+  size_t _cap;
+  uint16_t _maxZones;
+  uint16_t _zones = 0;
+  uint32_t _vertices = 0;
+  bool _overflow = false;
+};
+
+#endif // GEOFENCE_H
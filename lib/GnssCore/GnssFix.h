@@ -0,0 +1,75 @@
+/**
+ * Snapshot of the GNSS fix state handed from the parser to consumers
+ *
+ * Plain data only (no pointers into the parser), so it can be copied
+ * between tasks, e.g. through a FixBus. Coordinates keep the receiver's
+ * degrees + billionths split, so formatting never needs floating point.
+ */
+
+#ifndef GNSS_FIX_H
+#define GNSS_FIX_H
+
+#include <stdint.h>
+
+struct GnssCoord {
+  uint16_t deg;
+  uint32_t billionths;
+  bool negative;
+};
+
+enum GnssAntenna : uint8_t {
+  ANTENNA_UNKNOWN = 0,   // no recent antenna TXT message
+  ANTENNA_OK,
+  ANTENNA_OPEN
+};
+
+// solution type; 0-5 are the UBX-NAV-PVT fixType values
+enum FixType : uint8_t {
+  FIX_TYPE_NONE = 0,
+  FIX_TYPE_DEAD_RECKONING,
+  FIX_TYPE_2D,
+  FIX_TYPE_3D,
+  FIX_TYPE_GNSS_DR,
+  FIX_TYPE_TIME_ONLY,
+  FIX_TYPE_POSITION      // position of unknown type (NMEA)
+};
+
+struct GnssFix {
+  bool timeValid;
+  bool locationValid;
+  bool dateValid;
+
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint8_t centisecond;
+
+  GnssCoord lat;
+  GnssCoord lon;
+
+  GnssAntenna antenna;
+
+  // solution quality, 0 where the receiver does not report it
+  FixType fixType;
+  uint8_t satellites;
+  uint16_t hdop;         // 0.01
+};
+
+// seconds since 1970-01-01 00:00:00 UTC of the fix's date and time
+// (days-from-civil, proleptic Gregorian calendar)
+inline int64_t gnssUnixSeconds(const GnssFix& f) {
+  int32_t y = (int32_t)f.year - (f.month <= 2);
+  int32_t era = (y >= 0 ? y : y - 399) / 400;
+  uint32_t yoe = (uint32_t)(y - era * 400);
+  uint32_t mp = (f.month + 9) % 12;                    // March = 0
+  uint32_t doy = (153 * mp + 2) / 5 + f.day - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int64_t days = (int64_t)era * 146097 + doe - 719468;
+  return days * 86400 + (f.hour * 60 + f.minute) * 60 + f.second;
+}
+
+#endif // GNSS_FIX_H
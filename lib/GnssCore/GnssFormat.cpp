@@ -0,0 +1,65 @@
+#include "GnssFormat.h"
+
+// writes v (< 100) as two digits, like %02d
+static inline char* put2(char* p, uint8_t v) {
+  p[0] = (char)('0' + v / 10);
+  p[1] = (char)('0' + v % 10);
+  return p + 2;
+}
+
+// writes v without leading zeros, like %lu
+static char* putU32(char* p, uint32_t v) {
+  char tmp[10];
+  uint8_t n = 0;
+  do {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  while (n) *p++ = tmp[--n];
+  return p;
+}
+
+size_t formatCoordinate(char* out, const char* prefix, const GnssCoord& c) {
+  char* p = out;
+  while (*prefix) *p++ = *prefix++;
+
+  // round billionths to millionths, carry into the degrees
+  uint32_t deg = c.deg;
+  uint32_t micro = (c.billionths + 500) / 1000;
+  if (micro >= 1000000) {
+    deg += micro / 1000000;
+    micro %= 1000000;
+  }
+
+  // TinyGPS++ negates even a zero value, which printf shows as "-0.000000"
+  if (c.negative) *p++ = '-';
+  p = putU32(p, deg);
+  *p++ = '.';
+  for (int i = 5; i >= 0; i--) {
+    p[i] = (char)('0' + micro % 10);
+    micro /= 10;
+  }
+  p += 6;
+  *p = 0;
+  return (size_t)(p - out);
+}
+
+size_t formatTime(char* out, uint8_t hour, uint8_t minute, uint8_t second, uint8_t centisecond) {
+  char* p = out;
+  p = put2(p, hour);
+  *p++ = ':';
+  p = put2(p, minute);
+  *p++ = ':';
+  p = put2(p, second);
+  *p++ = '.';
+  p = put2(p, centisecond);
+  *p = 0;
+  return (size_t)(p - out);
+}
+
+size_t formatUptime(char* out, uint32_t seconds) {
+  char* p = putU32(out, seconds);
+  *p++ = 's';
+  *p = 0;
+  return (size_t)(p - out);
+}
@@ -0,0 +1,37 @@
+/**
+ * Allocation-free, float-free formatting for the GNSS status screen
+ *
+ * Drop-in replacements for the snprintf() calls in the UI path. Every
+ * function writes into a caller-provided buffer, NUL-terminates it and
+ * returns the string length. Output matches the printf formats noted on
+ * each function.
+ *
+ * Coordinates are rounded from the receiver's billionths of a degree with
+ * integer math. The only possible difference to "%.6f" of the double is an
+ * exact half-microdegree tie (billionths ending in 500): printf then rounds
+ * the binary double, which may land either side, while formatCoordinate()
+ * always rounds away from zero.
+ */
+
+#ifndef GNSS_FORMAT_H
+#define GNSS_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GnssFix.h"
+
+// minimum buffer sizes
+#define GNSS_FMT_COORD_LEN  24   // prefix (<= 8) + "-180.000000"
+#define GNSS_FMT_TIME_LEN   12   // "HH:MM:SS.cs"
+#define GNSS_FMT_UPTIME_LEN 12   // "4294967295s"
+
+// prefix + "%.6f" of the coordinate, e.g. "LAT: 48.137154"
+size_t formatCoordinate(char* out, const char* prefix, const GnssCoord& c);
+
+// "%02d:%02d:%02d.%02d"
+size_t formatTime(char* out, uint8_t hour, uint8_t minute, uint8_t second, uint8_t centisecond);
+
+// "%lus"
+size_t formatUptime(char* out, uint32_t seconds);
+
+#endif // GNSS_FORMAT_H
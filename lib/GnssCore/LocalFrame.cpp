@@ -0,0 +1,59 @@
+#include "LocalFrame.h"
+
+// mm per 1e-7 deg, Q16: mean meridian degree (111132.95 m) for latitude,
+// equatorial degree (111319.49 m) times cos(lat) for longitude; off by
+// less than 0.5 % against the ellipsoid, which only scales distances
+static const int64_t kLatScale = 728321;
+static const int64_t kLonScaleEquator = 729543;
+static const int64_t kLon360 = 3600000000LL;
+
+// cos of a latitude in 1e-7 deg, Q16; Taylor series to x^8, error below
+// 2e-5 up to 90 deg, integers only
+static int32_t cosQ16(int32_t lat) {
+  const int64_t one = 1LL << 30;
+  int64_t a = lat < 0 ? -(int64_t)lat : lat;
+  if (a > 900000000) a = 900000000;
+  int64_t x = a * 187403301 / 100000000;   // Q30 radians
+  int64_t x2 = x * x >> 30;
+  int64_t t = one - x2 / 56;
+  t = one - (x2 * t >> 30) / 30;
+  t = one - (x2 * t >> 30) / 12;
+  t = one - (x2 * t >> 30) / 2;
+  return (int32_t)(t >> 14);
+}
+
+static int32_t wrapLon(int64_t lon) {
+  if (lon > kLon360 / 2) lon -= kLon360;
+  if (lon < -kLon360 / 2) lon += kLon360;
+  return (int32_t)lon;
+}
+
+static int32_t saturate(int64_t v) {
+  return v > INT32_MAX ? INT32_MAX : v < -INT32_MAX ? -INT32_MAX : (int32_t)v;
+}
+
+void LocalFrame::setOrigin(int32_t lat, int32_t lon) {
+  _lat = lat;
+  _lon = lon;
+  _lonScale = (int32_t)(kLonScaleEquator * cosQ16(lat) >> 16);
+  if (_lonScale < 1) _lonScale = 1;   // at the pole
+}
+
+void LocalFrame::toLocal(int32_t lat, int32_t lon, int32_t& eastMm, int32_t& northMm) const {
+  northMm = saturate(((int64_t)lat - _lat) * kLatScale / 65536);
+  eastMm = saturate((int64_t)wrapLon((int64_t)lon - _lon) * _lonScale / 65536);
+}
+
+void LocalFrame::toGlobal(int32_t eastMm, int32_t northMm, int32_t& lat, int32_t& lon) const {
+  int64_t la = _lat + (int64_t)northMm * 65536 / kLatScale;
+  lat = (int32_t)(la > 900000000 ? 900000000 : la < -900000000 ? -900000000 : la);
+  lon = wrapLon(_lon + (int64_t)eastMm * 65536 / _lonScale);
+}
+
+void LocalFrame::recenter(int32_t& eastMm, int32_t& northMm) {
+  int32_t dLat = (int32_t)((int64_t)northMm * 65536 / kLatScale);
+  int32_t dLon = (int32_t)((int64_t)eastMm * 65536 / _lonScale);
+  northMm -= (int32_t)(dLat * kLatScale / 65536);
+  eastMm -= (int32_t)(dLon * (int64_t)_lonScale / 65536);
+  setOrigin(_lat + dLat, wrapLon((int64_t)_lon + dLon));
+}
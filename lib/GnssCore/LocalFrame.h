@@ -0,0 +1,39 @@
+/**
+ * Local east/north plane around a reference point
+ *
+ * Converts 1e-7 deg coordinates to mm offsets from an origin and back,
+ * with integer arithmetic only: a fixed mm-per-unit scale for latitude
+ * and that scale times cos(origin latitude) for longitude. Both
+ * directions use the same scales, so a round trip is good to 1e-7 deg,
+ * and longitude differences wrap at +-180 deg.
+ *
+ * Good to well under 1 % of the distance within a few hundred km of the
+ * origin - plenty for a Kalman filter's state (PositionFilter) or a
+ * radius test (Geofence), not for surveying.
+ */
+
+#ifndef LOCAL_FRAME_H
+#define LOCAL_FRAME_H
+
+#include <stdint.h>
+
+class LocalFrame {
+public:
+  void setOrigin(int32_t lat, int32_t lon);
+  int32_t originLat() const { return _lat; }
+  int32_t originLon() const { return _lon; }
+
+  // offsets from the origin; callers keep them within a few hundred km
+  void toLocal(int32_t lat, int32_t lon, int32_t& eastMm, int32_t& northMm) const;
+  void toGlobal(int32_t eastMm, int32_t northMm, int32_t& lat, int32_t& lon) const;
+
+  // moves the origin by (about) the given offsets and subtracts the exact
+  // shift from them, so origin + offsets still name the same point
+  void recenter(int32_t& eastMm, int32_t& northMm);
+
+private:
+  int32_t _lat = 0, _lon = 0;
+  int32_t _lonScale = 0;   // mm per 1e-7 deg of longitude, Q16
+};
+
+#endif // LOCAL_FRAME_H
@@ -0,0 +1,119 @@
+#include "LoraAirtime.h"
+
+uint32_t loraTimeOnAirUs(const LoraModulation& m, size_t payloadLen) {
+  // symbol time in ns: 2^SF / BW
+  uint64_t symbolNs = ((uint64_t)1000000000ULL << m.sf) / m.bandwidthHz;
+  bool ldro = m.sf >= 11 && m.bandwidthHz == 125000;
+
+  // payload symbols: 8 + max(ceil((8PL - 4SF + 28 + 16 - 20H) / (4(SF - 2DE))) * (CR + 4), 0)
+  int32_t num = 8 * (int32_t)payloadLen - 4 * m.sf + 28 + 16;
+  int32_t den = 4 * (m.sf - (ldro ? 2 : 0));
+  int32_t blocks = num > 0 ? (num + den - 1) / den : 0;
+  uint32_t payloadSymbols = 8 + (uint32_t)blocks * (m.codingRate + 4);
+
+  // preamble + 4.25 symbols sync word, in quarter symbols
+  uint64_t quarters = ((uint64_t)m.preamble + payloadSymbols) * 4 + 17;
+  return (uint32_t)((quarters * symbolNs / 4 + 500) / 1000);
+}
+
+size_t loraMaxPayloadEu868(uint8_t sf) {
+  if (sf >= 10) return 51;   // DR0..DR2
+  if (sf == 9) return 115;   // DR3
+  return 222;                // DR4, DR5
+}
+
+AirtimeBucket::AirtimeBucket(uint16_t permille, uint32_t windowS)
+  : _permille(permille), _capUs(windowS * permille * 250u) {
+  _tokensUs = (int32_t)_capUs;
+}
+
+void AirtimeBucket::refill(uint32_t nowMs) {
+  if (!_started) {
+    _started = true;
+    _atMs = nowMs;
+    return;
+  }
+  // earned: elapsed ms * 3/4 permille us; fits 64 bits for any elapsed
+  uint32_t elapsed = nowMs - _atMs;
+  uint64_t quarters = (uint64_t)elapsed * _permille * 3 + _quarters;
+  _quarters = (uint8_t)(quarters & 3);
+  int64_t tokens = (int64_t)_tokensUs + (int64_t)(quarters >> 2);
+  if (tokens >= (int64_t)_capUs) {
+    tokens = _capUs;
+    _quarters = 0;
+  }
+  _tokensUs = (int32_t)tokens;
+  _atMs = nowMs;
+}
+
+uint32_t AirtimeBucket::availableUs(uint32_t nowMs) {
+  refill(nowMs);
+  return _tokensUs > 0 ? (uint32_t)_tokensUs : 0;
+}
+
+uint32_t AirtimeBucket::waitMs(uint32_t nowMs, uint32_t airtimeUs) {
+  refill(nowMs);
+  int64_t missing = (int64_t)airtimeUs - _tokensUs;
+  if (missing <= 0) return 0;
+  if (airtimeUs > _capUs || !_permille) return UINT32_MAX;   // never fits
+  uint32_t rate = _permille * 3u;   // 1/4 us per ms
+  return (uint32_t)((missing * 4 + rate - 1) / rate);
+}
+
+void AirtimeBucket::sent(uint32_t nowMs, uint32_t airtimeUs) {
+  refill(nowMs);
+  int64_t tokens = (int64_t)_tokensUs - airtimeUs;
+  _tokensUs = tokens < INT32_MIN ? INT32_MIN : (int32_t)tokens;
+  _spentUs += airtimeUs;
+}
+
+void AirtimeBucket::save(State& out) const {
+  out.tokensUs = _tokensUs;
+  out.atMs = _atMs;
+  out.spentUs = _spentUs;
+}
+
+void AirtimeBucket::restore(const State& in) {
+  _tokensUs = in.tokensUs;
+  _atMs = in.atMs;
+  _spentUs = in.spentUs;
+  _quarters = 0;
+  _started = true;
+}
+
+struct Eu868Subband {
+  uint32_t lowHz, highHz;
+  uint16_t permille;
+};
+
+static const Eu868Subband kEu868[Eu868Budget::kSubbands] = {
+  { 863000000, 868000000, 10 },    // h1.3
+  { 868000000, 868600000, 10 },    // h1.4, LoRaWAN default channels
+  { 868700000, 869200000, 1 },     // h1.5
+  { 869400000, 869650000, 100 },   // h1.6, 500 mW
+  { 869700000, 870000000, 10 },    // h1.7
+};
+
+Eu868Budget::Eu868Budget() {
+  for (uint8_t i = 0; i < kSubbands; i++) _buckets[i] = AirtimeBucket(kEu868[i].permille);
+}
+
+int8_t Eu868Budget::subband(uint32_t frequencyHz, uint32_t bandwidthHz) {
+  uint32_t half = bandwidthHz / 2;
+  for (uint8_t i = 0; i < kSubbands; i++) {
+    if (frequencyHz >= kEu868[i].lowHz + half && frequencyHz + half <= kEu868[i].highHz) return (int8_t)i;
+  }
+  return -1;
+}
+
+uint16_t Eu868Budget::subbandPermille(uint8_t subband) {
+  return subband < kSubbands ? kEu868[subband].permille : 0;
+}
+
+void Eu868Budget::save(State& out) const {
+  for (uint8_t i = 0; i < kSubbands; i++) _buckets[i].save(out.buckets[i]);
+}
+
+void Eu868Budget::restore(const State& in) {
+  for (uint8_t i = 0; i < kSubbands; i++) _buckets[i].restore(in.buckets[i]);
+}
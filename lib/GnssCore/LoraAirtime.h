@@ -0,0 +1,99 @@
+/**
+ * LoRa time-on-air and EU868 duty-cycle bookkeeping
+ *
+ * loraTimeOnAirUs() is the Semtech SX126x datasheet formula (explicit
+ * header, CRC on); low data rate optimisation is switched on for SF11/SF12
+ * at 125 kHz, as the radio requires.
+ *
+ * AirtimeBucket enforces "transmit at most `permille` of the time" as a
+ * token bucket over an observation window (ETSI EN 300 220: one hour): it
+ * holds up to a quarter of the window's share (9 s at 1 %) and refills at
+ * three quarters of `permille`, so a full bucket plus a window of refill
+ * never exceeds the duty cycle. A frame may start while the bucket holds
+ * its airtime; quiet periods can then be spent on a burst. At 1 % a 400 ms
+ * SF10 frame takes 53 s to earn back, which is why batching several fixes
+ * into one frame matters. Eu868Budget keeps one bucket per EU868 sub-band,
+ * so channels in different sub-bands are limited independently.
+ */
+
+#ifndef LORA_AIRTIME_H
+#define LORA_AIRTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct LoraModulation {
+  uint8_t sf;           // 7..12
+  uint32_t bandwidthHz; // 125000, 250000, 500000
+  uint8_t codingRate;   // 1..4 = 4/5..4/8
+  uint16_t preamble;    // symbols
+};
+
+uint32_t loraTimeOnAirUs(const LoraModulation& m, size_t payloadLen);
+
+// EU868 maximum application payload per spreading factor at 125 kHz
+size_t loraMaxPayloadEu868(uint8_t sf);
+
+class AirtimeBucket {
+public:
+  // starts full
+  explicit AirtimeBucket(uint16_t permille = 10, uint32_t windowS = 3600);
+
+  // airtime that may be spent now, us
+  uint32_t availableUs(uint32_t nowMs);
+  uint32_t capacityUs() const { return _capUs; }
+  uint16_t permille() const { return _permille; }
+
+  bool canSend(uint32_t nowMs, uint32_t airtimeUs) { return availableUs(nowMs) >= airtimeUs; }
+  // ms until a frame of airtimeUs may start
+  uint32_t waitMs(uint32_t nowMs, uint32_t airtimeUs);
+
+  // charges a transmission (a timed-out one too); may leave a debt
+  void sent(uint32_t nowMs, uint32_t airtimeUs);
+  uint32_t totalAirtimeMs() const { return (uint32_t)(_spentUs / 1000); }
+
+  // state across deep sleep (RTC memory), in the caller's clock
+  struct State {
+    int32_t tokensUs;
+    uint32_t atMs;
+    uint64_t spentUs;
+  };
+  void save(State& out) const;
+  void restore(const State& in);
+
+private:
+  void refill(uint32_t nowMs);
+
+  uint16_t _permille;
+  uint32_t _capUs;
+  int32_t _tokensUs;
+  uint8_t _quarters = 0;   // refill remainder, 1/4 us
+  uint32_t _atMs = 0;
+  bool _started = false;   // _atMs set
+  uint64_t _spentUs = 0;
+};
+
+// EU868 sub-bands for short-range devices (ERC Rec 70-03 annex 1, h1.3 - h1.7)
+class Eu868Budget {
+public:
+  static const uint8_t kSubbands = 5;
+
+  Eu868Budget();
+
+  // sub-band of a channel (the whole 125 kHz channel inside), -1 if none
+  static int8_t subband(uint32_t frequencyHz, uint32_t bandwidthHz = 125000);
+  static uint16_t subbandPermille(uint8_t subband);
+
+  AirtimeBucket& bucket(uint8_t subband) { return _buckets[subband]; }
+
+  struct State {
+    AirtimeBucket::State buckets[kSubbands];
+  };
+  void save(State& out) const;
+  void restore(const State& in);
+
+private:
+  AirtimeBucket _buckets[kSubbands];
+};
+
+#endif // LORA_AIRTIME_H
@@ -0,0 +1,205 @@
+#include "NmeaFramer.h"
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+bool NmeaSentence::contains(const char* needle) const {
+  size_t len = 0;
+  while (needle[len]) len++;
+  size_t n = payloadLength();
+  if (len == 0) return true;
+  if (len > n) return false;
+
+  for (size_t i = 0; i + len <= n; i++) {
+    size_t k = 0;
+    while (k < len && payloadAt(i + k) == needle[k]) k++;
+    if (k == len) return true;
+  }
+  return false;
+}
+
+int NmeaSentence::fieldStart(uint8_t index) const {
+  size_t n = payloadLength();
+  size_t i = 0;
+  while (index && i < n) {
+    if (payloadAt(i++) == ',') index--;
+  }
+  return index ? -1 : (int)i;
+}
+
+bool NmeaFramer::on(uint32_t id, Handler h, void* ctx, uint32_t mask) {
+  if (_handlerCount >= kMaxHandlers) return false;
+  Entry& e = _handlers[_handlerCount++];
+  e.id = id & mask;
+  e.mask = mask;
+  e.fn = h;
+  e.ctx = ctx;
+  return true;
+}
+
+void NmeaFramer::restart() {
+  _inFrame = false;
+  _scan = 0;
+  _starPos = 0;
+  _sum = 0;
+  _id = 0;
+  _idLen = 0;
+}
+
+void NmeaFramer::setEpochEnd(uint32_t id, uint32_t mask) {
+  _epochLearning = id == 0;
+  _epochEndMask = _epochLearning ? NMEA_MATCH_ADDRESS : mask;
+  _epochEndId = id & _epochEndMask;
+  _candidateId = 0;
+  _candidateGaps = 0;
+  _epochEnded = false;
+}
+
+void NmeaFramer::lineIdle() {
+  if (!_epochLearning || !_lastId) return;
+  if (_lastId != _candidateId) {
+    // the burst ended on a different sentence (lost bytes, changed output);
+    // a learned end stays in place until the new one is confirmed as well
+    _candidateId = _lastId;
+    _candidateGaps = 0;
+  }
+  if (_candidateGaps < kEpochLearnGaps && ++_candidateGaps == kEpochLearnGaps) _epochEndId = _candidateId;
+  _lastId = 0;
+}
+
+bool NmeaFramer::takeEpochEnd() {
+  bool ended = _epochEnded;
+  _epochEnded = false;
+  return ended;
+}
+
+void NmeaFramer::dispatch(const NmeaSentence& s) {
+  _counters.sentences++;
+  _lastId = s.id;
+  _epochEnded = _epochEndId && (s.id & _epochEndMask) == _epochEndId;
+  if (_epochEnded) _counters.epochs++;
+  if (_sink) _sink(s, _sinkCtx);
+  for (uint8_t i = 0; i < _handlerCount; i++) {
+    const Entry& e = _handlers[i];
+    if ((s.id & e.mask) == e.id) e.fn(s, e.ctx);
+  }
+}
+
+size_t NmeaFramer::poll(ByteRing& ring) {
+  size_t dispatched = 0;
+
+  for (;;) {
+    const uint8_t *p1, *p2;
+    size_t n1, n2;
+    size_t avail = ring.peek(&p1, &n1, &p2, &n2);
+    auto at = [&](size_t i) -> uint8_t { return i < n1 ? p1[i] : p2[i - n1]; };
+
+    if (!_inFrame) {
+      size_t skip = 0;
+      while (skip < avail && at(skip) != '$' && at(skip) != UBX_SYNC1) skip++;
+      if (skip) {
+        ring.consume(skip);
+        _counters.skippedBytes += skip;
+        continue;
+      }
+      if (avail == 0) return dispatched;
+
+      if (at(0) == UBX_SYNC1) {
+        // binary UBX frame: skip it by its length so '$' bytes in the payload
+        // are never mistaken for a sentence start
+        if (avail < 6) return dispatched;
+        size_t total = ((size_t)at(4) | (size_t)at(5) << 8) + UBX_FRAME_OVERHEAD;
+        if (at(1) != UBX_SYNC2 || total > kMaxBinaryFrame || total > ring.capacity()) {
+          ring.consume(1);
+          _counters.skippedBytes++;
+          continue;
+        }
+        if (avail < total) return dispatched;
+        if (_binarySink) {
+          size_t first = total < n1 ? total : n1;
+          _binarySink(p1, first, p2, total - first, _binaryCtx);
+        }
+        ring.consume(total);
+        _counters.binaryFrames++;
+        continue;
+      }
+
+      restart();
+      _inFrame = true;
+      _scan = 1;
+      continue;
+    }
+
+    // scan forward until '\n'; checksum and address are accumulated on the way
+    bool resync = false;
+    bool complete = false;
+    while (_scan < avail) {
+      uint8_t c = at(_scan);
+      if (c == '\n') {
+        complete = true;
+        break;
+      }
+      if (c == '$' || _scan >= kMaxSentence) {
+        resync = true;
+        break;
+      }
+      if (!_starPos) {
+        if (c == '*') {
+          _starPos = _scan;
+        } else {
+          _sum ^= c;
+          if (_idLen < 5) {
+            if (c == ',') {
+              _id <<= 6 * (5 - _idLen);   // short address, keep the type bits aligned
+              _idLen = 5;
+            } else {
+              _id = _id << 6 | nmeaChar((char)c);
+              _idLen++;
+            }
+          }
+        }
+      }
+      _scan++;
+    }
+
+    if (resync) {
+      // unterminated or runaway frame: drop it and restart at the current byte
+      ring.consume(_scan);
+      _counters.malformed++;
+      restart();
+      continue;
+    }
+    if (!complete) return dispatched;
+
+    size_t len = _scan + 1;
+    size_t trailer = _scan - _starPos;   // "*hh\n" = 3, "*hh\r\n" = 4
+    bool shaped = _starPos && (trailer == 3 || (trailer == 4 && at(_scan - 1) == '\r'));
+
+    if (!shaped) {
+      _counters.malformed++;
+    } else {
+      int hi = hexValue((char)at(_starPos + 1));
+      int lo = hexValue((char)at(_starPos + 2));
+      if (hi < 0 || lo < 0 || (uint8_t)(hi << 4 | lo) != _sum) {
+        _counters.checksumErrors++;
+      } else {
+        NmeaSentence s;
+        s.p1 = p1;
+        s.n1 = len < n1 ? len : n1;
+        s.p2 = p2;
+        s.n2 = len - s.n1;
+        s.id = _id;
+        s.starPos = _starPos;
+        dispatch(s);
+        dispatched++;
+      }
+    }
+
+    ring.consume(len);
+    restart();
+  }
+}
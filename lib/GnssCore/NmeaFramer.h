@@ -0,0 +1,174 @@
+/**
+ * Zero-copy NMEA 0183 sentence framer
+ *
+ * Finds "$<address>,<fields>*hh\r\n" frames directly in a ByteRing, verifies
+ * the XOR checksum and dispatches each valid sentence to the handlers that
+ * registered for its address. Sentences are never copied: a handler gets an
+ * NmeaSentence view into the ring (at most two spans when the frame wraps)
+ * and the bytes are consumed only after every handler returned.
+ *
+ * Addresses are packed into 30 bits (6 bits per character, talker in the top
+ * 12 bits) so they compare as integers and can be used as switch labels:
+ *
+ *   switch (s.id) {
+ *     case nmeaId("GPRMC"): ...
+ *     case nmeaId("GNGGA"): ...
+ *   }
+ *
+ * Handlers can match a full address ("GPTXT") or only the sentence type
+ * ("TXT" from any talker):
+ *
+ *   framer.on(nmeaType("TXT"), onTxt, nullptr, NMEA_MATCH_TYPE);
+ *   framer.setFrameSink(feedTinyGps, nullptr);   // every valid frame
+ *   ...
+ *   framer.poll(ring);
+ *
+ * Binary u-blox UBX frames interleaved with the sentences are recognised by
+ * their 0xB5 0x62 sync and skipped by length, so a '$' inside a UBX payload
+ * cannot start a bogus sentence. With setBinarySink() the raw frame bytes
+ * are passed on (e.g. to a UbxParser) instead of being dropped.
+ *
+ * Epoch end: a receiver sends the same sentence sequence every epoch, so the
+ * last sentence of a burst identifies the end of the epoch. It is either set
+ * (setEpochEnd(nmeaId("GNGLL"))) or learned: the caller reports quiet periods
+ * on the line with lineIdle(), and once the same sentence preceded the gap
+ * kEpochLearnGaps times in a row it becomes the epoch end. epochEnded() then
+ * turns true right after that sentence is dispatched, without waiting for
+ * the gap.
+ */
+
+#ifndef NMEA_FRAMER_H
+#define NMEA_FRAMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ByteRing.h"
+#include "Ubx.h"
+
+// --- packed addresses ---
+
+#define NMEA_MATCH_ADDRESS 0x3FFFFFFFUL   // talker + type
+#define NMEA_MATCH_TYPE    0x0003FFFFUL   // type only, any talker
+
+constexpr uint32_t nmeaChar(char c) { return (uint32_t)(c - 0x20) & 0x3F; }
+
+// "TXT" -> type bits
+constexpr uint32_t nmeaType(const char* t) {
+  return nmeaChar(t[0]) << 12 | nmeaChar(t[1]) << 6 | nmeaChar(t[2]);
+}
+
+// "GPTXT" -> talker + type bits
+constexpr uint32_t nmeaId(const char* a) {
+  return (nmeaChar(a[0]) << 6 | nmeaChar(a[1])) << 18 | nmeaType(a + 2);
+}
+
+// --- sentence view ---
+
+struct NmeaSentence {
+  // raw frame from '$' through '\n', split where the ring wraps
+  const uint8_t* p1;
+  size_t n1;
+  const uint8_t* p2;
+  size_t n2;
+
+  uint32_t id;        // packed address, see nmeaId()
+  size_t starPos;     // index of '*' within the frame
+
+  size_t size() const { return n1 + n2; }
+  char at(size_t i) const { return (char)(i < n1 ? p1[i] : p2[i - n1]); }
+
+  // payload = characters between '$' and '*'
+  size_t payloadLength() const { return starPos - 1; }
+  char payloadAt(size_t i) const { return at(i + 1); }
+
+  // substring search over the payload
+  bool contains(const char* needle) const;
+
+  // position of field `index` (0 = address) within the payload, or -1
+  int fieldStart(uint8_t index) const;
+};
+
+class NmeaFramer {
+public:
+  typedef void (*Handler)(const NmeaSentence& s, void* ctx);
+  // raw UBX frame (sync through checksum), split where the ring wraps
+  typedef void (*BinarySink)(const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, void* ctx);
+
+  static const uint8_t kMaxHandlers = 8;
+  static const size_t  kMaxSentence = 96;   // NMEA limit is 82, leave room for vendor extensions
+  static const size_t  kMaxBinaryFrame = 1024;
+  static const uint8_t kEpochLearnGaps = 3;
+
+  struct Counters {
+    uint32_t sentences;       // checksum-valid frames
+    uint32_t checksumErrors;
+    uint32_t malformed;       // no '*hh' trailer, truncated or overlong
+    uint32_t skippedBytes;    // bytes outside any frame
+    uint32_t binaryFrames;    // UBX frames passed to the binary sink (or skipped)
+    uint32_t epochs;          // epoch ends seen
+  };
+
+  // registers a handler for (id & mask); returns false when the table is full
+  bool on(uint32_t id, Handler h, void* ctx = nullptr, uint32_t mask = NMEA_MATCH_ADDRESS);
+
+  // called for every checksum-valid frame before the matching handlers
+  void setFrameSink(Handler h, void* ctx = nullptr) { _sink = h; _sinkCtx = ctx; }
+
+  // receives every UBX frame found between sentences (checksum not verified)
+  void setBinarySink(BinarySink h, void* ctx = nullptr) { _binarySink = h; _binaryCtx = ctx; }
+
+  // frames and dispatches everything complete in `ring`; returns sentences dispatched
+  size_t poll(ByteRing& ring);
+
+  // fixes the epoch's final sentence (id & mask); id 0 = learn it from lineIdle()
+  void setEpochEnd(uint32_t id, uint32_t mask = NMEA_MATCH_ADDRESS);
+  // the line has been quiet long enough to separate two bursts
+  void lineIdle();
+  // true after the final sentence of an epoch, until the next sentence
+  bool epochEnded() const { return _epochEnded; }
+  // consumes the flag, returns whether it was set
+  bool takeEpochEnd();
+  // known or learned final sentence (0 = not known yet)
+  uint32_t epochEndId() const { return _epochEndId; }
+
+  const Counters& counters() const { return _counters; }
+
+private:
+  struct Entry {
+    uint32_t id;
+    uint32_t mask;
+    Handler fn;
+    void* ctx;
+  };
+
+  void dispatch(const NmeaSentence& s);
+  void restart();
+
+  Entry _handlers[kMaxHandlers];
+  uint8_t _handlerCount = 0;
+  Handler _sink = nullptr;
+  void* _sinkCtx = nullptr;
+  BinarySink _binarySink = nullptr;
+  void* _binaryCtx = nullptr;
+
+  // scan state, persists across poll() calls while a frame is incomplete
+  bool _inFrame = false;
+  size_t _scan = 0;        // next offset to inspect, relative to ring tail
+  size_t _starPos = 0;     // 0 = '*' not seen yet
+  uint8_t _sum = 0;
+  uint32_t _id = 0;
+  uint8_t _idLen = 0;
+
+  // epoch end detection
+  uint32_t _epochEndId = 0;
+  uint32_t _epochEndMask = NMEA_MATCH_ADDRESS;
+  bool _epochLearning = true;
+  bool _epochEnded = false;
+  uint32_t _lastId = 0;         // latest sentence dispatched
+  uint32_t _candidateId = 0;    // sentence seen before the latest gaps
+  uint8_t _candidateGaps = 0;
+
+  Counters _counters = {};
+};
+
+#endif // NMEA_FRAMER_H
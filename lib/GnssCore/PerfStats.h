@@ -0,0 +1,159 @@
+/**
+ * Lightweight runtime counters and cycle timers
+ *
+ * PerfTimer keeps count, min, max, sum and a log2 histogram of durations
+ * in CPU cycles (esp_cpu_get_cycle_count() on the ESP32, nanoseconds on
+ * the host); PerfCounter is a named uint32_t. Both link themselves into a
+ * global list at construction, so a stats page or a Serial dump can walk
+ * every instrument without knowing where it lives.
+ *
+ * Instrument through the macros; they compile to nothing unless GNSS_PERF
+ * is 1. Set it as a build flag (-DGNSS_PERF=1) so the libraries (e.g. the
+ * GnssUart ingest task) are instrumented along with the sketch:
+ *
+ *   PERF_TIMER(perfParse, "parse");       // file scope
+ *   ...
+ *   PERF_BEGIN(perfParse);
+ *   framer.poll(ring);
+ *   PERF_END(perfParse);
+ *   PERF_COUNT(perfChecksum, 1);
+ *
+ * An enabled timer costs two cycle-counter reads and ~20 instructions per
+ * sample. Each instrument must be updated from a single task; readers on
+ * other tasks may see a sample half applied, which is fine for statistics.
+ */
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef GNSS_PERF
+#define GNSS_PERF 0
+#endif
+
+#if defined(ESP_PLATFORM)
+#include <esp_cpu.h>
+inline uint32_t perfCycles() { return (uint32_t)esp_cpu_get_cycle_count(); }
+#else
+#include <chrono>
+inline uint32_t perfCycles() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+class PerfTimer {
+public:
+  // bucket i holds durations in [2^(i + kFirstBit), 2^(i + kFirstBit + 1)),
+  // the first and last bucket are open-ended (256 cycles ~ 1 us at 240 MHz)
+  static const uint8_t kBuckets = 16;
+  static const uint8_t kFirstBit = 8;
+
+  explicit PerfTimer(const char* name) : _name(name), _next(head()) {
+    head() = this;
+    reset();
+  }
+
+  void add(uint32_t cycles) {
+    _count++;
+    _sum += cycles;
+    if (cycles < _min) _min = cycles;
+    if (cycles > _max) _max = cycles;
+    int bit = cycles ? 31 - __builtin_clz(cycles) : 0;
+    int b = bit - kFirstBit;
+    _buckets[b < 0 ? 0 : b >= kBuckets ? kBuckets - 1 : b]++;
+  }
+
+  void reset() {
+    _count = 0;
+    _sum = 0;
+    _min = UINT32_MAX;
+    _max = 0;
+    for (uint8_t i = 0; i < kBuckets; i++) _buckets[i] = 0;
+  }
+
+  const char* name() const { return _name; }
+  uint32_t count() const { return _count; }
+  uint32_t min() const { return _count ? _min : 0; }
+  uint32_t max() const { return _max; }
+  uint32_t avg() const { return _count ? (uint32_t)(_sum / _count) : 0; }
+  uint32_t bucket(uint8_t i) const { return _buckets[i]; }
+
+  // upper bound of the bucket holding the p-th percentile (p = 0..100),
+  // never above the maximum seen
+  uint32_t percentile(uint8_t p) const {
+    uint64_t want = ((uint64_t)_count * p + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t i = 0; i + 1 < kBuckets; i++) {
+      seen += _buckets[i];
+      uint32_t upper = (2u << (i + kFirstBit)) - 1;
+      if (seen >= want && seen) return upper < _max ? upper : _max;
+    }
+    return _max;
+  }
+
+  PerfTimer* next() const { return _next; }
+  static PerfTimer* first() { return head(); }
+  static void resetAll() {
+    for (PerfTimer* t = first(); t; t = t->next()) t->reset();
+  }
+
+private:
+  static PerfTimer*& head() {
+    static PerfTimer* list = nullptr;
+    return list;
+  }
+
+  const char* _name;
+  PerfTimer* _next;
+  uint32_t _count;
+  uint32_t _min;
+  uint32_t _max;
+  uint64_t _sum;
+  uint32_t _buckets[kBuckets];
+};
+
+class PerfCounter {
+public:
+  explicit PerfCounter(const char* name) : _name(name), _next(head()) { head() = this; }
+
+  void add(uint32_t n) { _value += n; }
+  void reset() { _value = 0; }
+
+  const char* name() const { return _name; }
+  uint32_t value() const { return _value; }
+
+  PerfCounter* next() const { return _next; }
+  static PerfCounter* first() { return head(); }
+  static void resetAll() {
+    for (PerfCounter* c = first(); c; c = c->next()) c->reset();
+  }
+
+private:
+  static PerfCounter*& head() {
+    static PerfCounter* list = nullptr;
+    return list;
+  }
+
+  const char* _name;
+  PerfCounter* _next;
+  volatile uint32_t _value = 0;
+};
+
+#if GNSS_PERF
+#define PERF_TIMER(var, label)   static PerfTimer var(label)
+#define PERF_COUNTER(var, label) static PerfCounter var(label)
+#define PERF_BEGIN(var)          uint32_t var##Start = perfCycles()
+#define PERF_END(var)            var.add(perfCycles() - var##Start)
+#define PERF_COUNT(var, n)       var.add(n)
+#else
+#define PERF_TIMER(var, label)
+#define PERF_COUNTER(var, label)
+#define PERF_BEGIN(var)          do {} while (0)
+#define PERF_END(var)            do {} while (0)
+#define PERF_COUNT(var, n)       do {} while (0)
+#endif
+
+#endif // PERF_STATS_H
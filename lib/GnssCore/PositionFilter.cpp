@@ -0,0 +1,16 @@
+#include "PositionFilter.h"
+
+uint32_t filterSqrt(uint64_t x) {
+  uint64_t r = 0, bit = 1ULL << 62;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= r + bit) {
+      x -= r + bit;
+      r = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+    bit >>= 2;
+  }
+  return r > UINT32_MAX ? UINT32_MAX : (uint32_t)r;
+}
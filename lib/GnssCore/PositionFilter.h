@@ -0,0 +1,341 @@
+/**
+ * Constant-velocity Kalman smoother: position at any instant between fixes
+ *
+ * At 1 Hz a consumer sees a new coordinate once per second, and every one
+ * carries the receiver's noise. PositionFilter runs a constant-velocity
+ * Kalman filter over the fixes and answers "where is the receiver at UTC
+ * t" for any t. Between epochs it extrapolates along the estimated
+ * velocity, so the display can draw at 10 Hz and the uplink scheduler can
+ * ask for the position at its TX slot without waiting for the receiver.
+ *
+ * Model: east and north offsets in mm from a reference point, two
+ * independent axes with state [position, velocity] and white-noise
+ * acceleration (Config::accelMms2). A fix is a position measurement with
+ * sigma = HDOP * Config::uereMm; a receiver velocity (UBX-NAV-PVT velN /
+ * velE) can be added with updateVelocity(). The reference point follows
+ * the track once it is more than kAnchorMm away, so the offsets stay in
+ * range: 32-bit mm never overflow, and float resolves about 1 mm at the
+ * re-anchor radius (sub-mm only within ~4 km), well below the fix noise.
+ *
+ * Time: every call takes UTC microseconds - the epoch time of the fix for
+ * update() (fixUnixMs() of the record), PpsTimebase::utcMicros() for
+ * predict() on the ESP32. Predictions are then aligned to the PPS second,
+ * not to the moment a sentence happened to be parsed.
+ *
+ * Outliers: a fix more than Config::gateSigma standard deviations off the
+ * prediction is rejected. Config::maxRejects in a row (the receiver
+ * really moved), or a gap longer than Config::maxGapUs, restart the
+ * filter on the latest fix.
+ *
+ * Arithmetic: the same filter on two axis implementations.
+ *   PositionFilterF   single precision float (ESP32-S3 FPU), mm and s
+ *   PositionFilterQ   integers only: state in mm and mm/s, covariances in
+ *                     int64, gains in Q16 - for cores without FPU and for
+ *                     ISRs, where the FPU must not be used
+ * Both agree to about a centimetre; GnssCoreBench ("filter float" /
+ * "filter fixed") measures their cost per update + predict.
+ *
+ * Single context: update and predict from the same task, or guard it.
+ *
+ * Usage:
+ *   static PositionFilterF smooth;
+ *   smooth.update(record);                  // every new epoch
+ *   int32_t lat, lon;                       // any time, e.g. at 10 Hz
+ *   if (smooth.predict(gnssTime.utcMicros(), lat, lon)) ...
+ */
+
+#ifndef POSITION_FILTER_H
+#define POSITION_FILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FixRecord.h"
+#include "LocalFrame.h"
+
+// one axis, float: position mm, velocity mm/s, covariance in those units
+struct KalmanAxisF {
+  float p, v;
+  float pp, pv, vv;
+
+  void init(int32_t pos, uint32_t sigma, uint32_t velSigma) {
+    p = (float)pos;
+    v = 0;
+    pp = (float)sigma * sigma;
+    pv = 0;
+    vv = (float)velSigma * velSigma;
+  }
+
+  void predict(uint32_t dtUs, uint32_t accel) {
+    float dt = dtUs * 1e-6f;
+    float q = (float)accel * accel * dt;   // white acceleration, integrated over dt
+    p += v * dt;
+    pp += dt * (2 * pv + dt * vv) + q * dt * dt * (1.0f / 3);
+    pv += dt * vv + q * dt * 0.5f;
+    vv += q;
+  }
+
+  // innovation within gate standard deviations
+  bool accepts(int32_t z, uint32_t sigma, uint8_t gate) const {
+    float y = z - p;
+    return y * y <= (float)gate * gate * (pp + (float)sigma * sigma);
+  }
+
+  void update(int32_t z, uint32_t sigma) {
+    float s = pp + (float)sigma * sigma;
+    float k0 = pp / s, k1 = pv / s;   // H = [1 0]
+    float y = z - p;
+    p += k0 * y;
+    v += k1 * y;
+    vv -= k1 * pv;
+    pv -= k0 * pv;
+    pp -= k0 * pp;
+  }
+
+  void updateVelocity(int32_t z, uint32_t sigma) {
+    float s = vv + (float)sigma * sigma;
+    float k0 = pv / s, k1 = vv / s;   // H = [0 1]
+    float y = z - v;
+    p += k0 * y;
+    v += k1 * y;
+    pp -= k0 * pv;
+    pv -= k0 * vv;
+    vv -= k1 * vv;
+  }
+
+  int32_t at(int64_t dtUs) const { return (int32_t)(p + v * (dtUs * 1e-6f)); }
+  int32_t position() const { return (int32_t)p; }
+  int32_t velocity() const { return (int32_t)v; }
+  uint64_t variance() const { return (uint64_t)pp; }
+  void shift(int32_t mm) { p -= mm; }
+};
+
+// one axis, integers: position mm, velocity mm/s, covariance int64 in
+// mm^2, mm^2/s, mm^2/s^2. Clamped to kVarMax, with the sigmas limited by
+// PositionFilter, no intermediate product leaves int64.
+struct KalmanAxisQ {
+  static const int64_t kVarMax = 1LL << 31;   // (46 m)^2, (46 m/s)^2
+  static const uint32_t kDtMaxMs = 60000;
+
+  int32_t p, v;
+  int64_t pp, pv, vv;
+
+  void init(int32_t pos, uint32_t sigma, uint32_t velSigma) {
+    p = pos;
+    v = 0;
+    pp = clamp((int64_t)sigma * sigma);
+    pv = 0;
+    vv = clamp((int64_t)velSigma * velSigma);
+  }
+
+  void predict(uint32_t dtUs, uint32_t accel) {
+    int64_t dt = dtUs / 1000;   // ms
+    if (dt > kDtMaxMs) dt = kDtMaxMs;
+    int64_t q = (int64_t)accel * accel * dt / 1000;   // <= 2^32 * 60
+    p += (int32_t)((int64_t)v * dtUs / 1000000);
+    pp = clamp(pp + (2 * pv * dt + vv * dt / 1000 * dt) / 1000 + q * dt / 1000 * dt / 3000);
+    pv = clampCov(pv + vv * dt / 1000 + q * dt / 2000);
+    vv = clamp(vv + q);
+  }
+
+  bool accepts(int32_t z, uint32_t sigma, uint8_t gate) const {
+    int64_t y = (int64_t)z - p;
+    if (y > INT32_MAX || y < -INT32_MAX) return false;
+    int64_t s = pp + (int64_t)sigma * sigma;
+    return y * y / ((int64_t)gate * gate) <= s;
+  }
+
+  void update(int32_t z, uint32_t sigma) {
+    int64_t s = pp + (int64_t)sigma * sigma;
+    int64_t k0 = (pp << 16) / s, k1 = (pv << 16) / s;   // Q16
+    int64_t y = (int64_t)z - p;
+    p += (int32_t)(k0 * y >> 16);
+    v += (int32_t)(k1 * y >> 16);
+    vv = clamp(vv - (k1 * pv >> 16));
+    pv = clampCov(pv - (k0 * pv >> 16));
+    pp = clamp(pp - (k0 * pp >> 16));
+  }
+
+  void updateVelocity(int32_t z, uint32_t sigma) {
+    int64_t s = vv + (int64_t)sigma * sigma;
+    int64_t k0 = (pv << 16) / s, k1 = (vv << 16) / s;
+    int64_t y = (int64_t)z - v;
+    p += (int32_t)(k0 * y >> 16);
+    v += (int32_t)(k1 * y >> 16);
+    pp = clamp(pp - (k0 * pv >> 16));
+    pv = clampCov(pv - (k0 * vv >> 16));
+    vv = clamp(vv - (k1 * vv >> 16));
+  }
+
+  int32_t at(int64_t dtUs) const { return p + (int32_t)((int64_t)v * dtUs / 1000000); }
+  int32_t position() const { return p; }
+  int32_t velocity() const { return v; }
+  uint64_t variance() const { return (uint64_t)pp; }
+  void shift(int32_t mm) { p -= mm; }
+
+private:
+  // variances stay positive, the covariance within +-kVarMax
+  static int64_t clamp(int64_t x) {
+    if (x < 1) return 1;
+    return x < kVarMax ? x : (int64_t)kVarMax;
+  }
+  static int64_t clampCov(int64_t x) {
+    if (x < -kVarMax) return -kVarMax;
+    return x < kVarMax ? x : (int64_t)kVarMax;
+  }
+};
+
+// integer square root, for sigmas from variances
+uint32_t filterSqrt(uint64_t x);
+
+template <typename Axis>
+class PositionFilter {
+public:
+  static const int32_t kAnchorMm = 10000000;   // 10 km: move the reference point
+  static const uint32_t kSigmaMinMm = 1000;    // fix sigma range
+  static const uint32_t kSigmaMaxMm = 46000;
+  static const uint32_t kVelSigmaMinMms = 250;
+
+  struct Config {
+    uint16_t accelMms2 = 1500;       // expected acceleration sigma (walking 500, car 3000)
+    uint16_t uereMm = 2500;          // fix sigma per unit of HDOP
+    uint16_t defaultSigmaMm = 5000;  // fixes without HDOP
+    uint16_t initSpeedMms = 20000;   // velocity sigma of a (re)started filter (<= 46000)
+    uint8_t gateSigma = 5;           // reject fixes further off than this
+    uint8_t maxRejects = 3;          // that many in a row restart the filter
+    uint32_t maxGapUs = 10000000;    // longer without a fix: restart, stop predicting
+  };
+
+  struct Stats {
+    uint32_t updates;
+    uint32_t rejected;   // outside the gate
+    uint32_t stale;      // not newer than the previous fix (repeats)
+    uint32_t restarts;   // first fix included
+  };
+
+  explicit PositionFilter(const Config& config = Config()) : _cfg(config) {}
+
+  void reset() { _valid = false; _rejectRun = 0; }
+  bool valid() const { return _valid; }
+  int64_t lastUtcUs() const { return _utcUs; }
+
+  // adds the fix of epoch utcUs; false if it was rejected or not newer
+  bool update(int64_t utcUs, int32_t lat, int32_t lon, uint32_t sigmaMm) {
+    if (sigmaMm < kSigmaMinMm) sigmaMm = kSigmaMinMm;
+    if (sigmaMm > kSigmaMaxMm) sigmaMm = kSigmaMaxMm;
+    if (_valid && utcUs <= _utcUs) {
+      _stats.stale++;
+      return false;
+    }
+    if (_valid && utcUs - _utcUs > (int64_t)_cfg.maxGapUs) _valid = false;
+    if (!_valid) {
+      restart(utcUs, lat, lon, sigmaMm);
+      return true;
+    }
+
+    uint32_t dtUs = (uint32_t)(utcUs - _utcUs);
+    _east.predict(dtUs, _cfg.accelMms2);
+    _north.predict(dtUs, _cfg.accelMms2);
+    _utcUs = utcUs;
+
+    int32_t e, n;
+    _frame.toLocal(lat, lon, e, n);
+    if (!_east.accepts(e, sigmaMm, _cfg.gateSigma) || !_north.accepts(n, sigmaMm, _cfg.gateSigma)) {
+      _stats.rejected++;
+      if (++_rejectRun >= _cfg.maxRejects) restart(utcUs, lat, lon, sigmaMm);
+      return false;
+    }
+    _rejectRun = 0;
+    _east.update(e, sigmaMm);
+    _north.update(n, sigmaMm);
+    _stats.updates++;
+    recenter();
+    return true;
+  }
+
+  // a record with date and position; the sigma comes from its HDOP class
+  bool update(const FixRecord& r) {
+    if (!fixIsComplete(r)) return false;
+    uint16_t hdop = fixHdopMax(r);
+    uint32_t sigma = hdop ? (uint32_t)hdop * _cfg.uereMm / 100 : _cfg.defaultSigmaMm;
+    _last = r;
+    return update((int64_t)fixUnixMs(r) * 1000, r.lat, r.lon, sigma);
+  }
+
+  // receiver velocity of the epoch last passed to update()
+  void updateVelocity(int32_t northMms, int32_t eastMms, uint32_t sigmaMms) {
+    if (!_valid) return;
+    if (sigmaMms < kVelSigmaMinMms) sigmaMms = kVelSigmaMinMms;
+    if (sigmaMms > kSigmaMaxMm) sigmaMms = kSigmaMaxMm;
+    _east.updateVelocity(eastMms, sigmaMms);
+    _north.updateVelocity(northMms, sigmaMms);
+  }
+
+  // position at utcUs, up to maxGapUs after the last fix (state unchanged)
+  bool predict(int64_t utcUs, int32_t& lat, int32_t& lon) const {
+    int64_t dt = utcUs - _utcUs;
+    if (!_valid || dt > (int64_t)_cfg.maxGapUs || dt < -(int64_t)_cfg.maxGapUs) return false;
+    _frame.toGlobal(_east.at(dt), _north.at(dt), lat, lon);
+    return true;
+  }
+
+  // the last record passed to update(r), moved to utcUs (unsealed)
+  bool predict(int64_t utcUs, FixRecord& out) const {
+    int32_t lat, lon;
+    if (!predict(utcUs, lat, lon)) return false;
+    out = _last;
+    out.lat = lat;
+    out.lon = lon;
+    if (fixHasDate(_last)) fixRecordSetTime(out, (uint64_t)(utcUs / 1000));
+    return true;
+  }
+
+  void velocity(int32_t& northMms, int32_t& eastMms) const {
+    northMms = _valid ? _north.velocity() : 0;
+    eastMms = _valid ? _east.velocity() : 0;
+  }
+  uint32_t speedMms() const {
+    int64_t n = _north.velocity(), e = _east.velocity();
+    return _valid ? filterSqrt((uint64_t)(n * n + e * e)) : 0;
+  }
+  // 1-sigma horizontal position uncertainty
+  uint32_t sigmaMm() const {
+    return _valid ? filterSqrt(_east.variance() + _north.variance()) : 0;
+  }
+
+  const Stats& stats() const { return _stats; }
+  void resetStats() { _stats = Stats(); }
+
+private:
+  void restart(int64_t utcUs, int32_t lat, int32_t lon, uint32_t sigmaMm) {
+    _frame.setOrigin(lat, lon);
+    _east.init(0, sigmaMm, _cfg.initSpeedMms);
+    _north.init(0, sigmaMm, _cfg.initSpeedMms);
+    _utcUs = utcUs;
+    _valid = true;
+    _rejectRun = 0;
+    _stats.restarts++;
+  }
+
+  void recenter() {
+    int32_t e = _east.position(), n = _north.position();
+    if (e < kAnchorMm && e > -kAnchorMm && n < kAnchorMm && n > -kAnchorMm) return;
+    int32_t e0 = e, n0 = n;
+    _frame.recenter(e, n);
+    _east.shift(e0 - e);
+    _north.shift(n0 - n);
+  }
+
+  Config _cfg;
+  LocalFrame _frame;
+  Axis _east = {}, _north = {};
+  FixRecord _last = {};
+  int64_t _utcUs = 0;
+  bool _valid = false;
+  uint8_t _rejectRun = 0;
+  Stats _stats = {};
+};
+
+typedef PositionFilter<KalmanAxisF> PositionFilterF;
+typedef PositionFilter<KalmanAxisQ> PositionFilterQ;
+
+#endif // POSITION_FILTER_H
@@ -0,0 +1,181 @@
+#include "PowerGovernor.h"
+#include "LocalFrame.h"
+
+static const int32_t kNearSpan = 1000000;   // 0.1 deg, beyond that never near the anchor
+
+PowerGovernor::PowerGovernor() : PowerGovernor(Config()) {}
+
+PowerGovernor::PowerGovernor(const Config& config) : _cfg(config) {}
+
+bool PowerGovernor::good(const FixRecord& fix) const {
+  FixType t = fixType(fix);
+  if (t != FIX_TYPE_3D && t != FIX_TYPE_GNSS_DR && t != FIX_TYPE_POSITION) return false;
+  uint8_t hdop = fixHdopClass(fix);
+  return fixSatellites(fix) >= _cfg.minSatellites && hdop != 0 && hdop <= _cfg.maxHdopClass;
+}
+
+bool PowerGovernor::nearAnchor(const FixRecord& fix) const {
+  int64_t dLat = (int64_t)fix.lat - _anchor.lat, dLon = (int64_t)fix.lon - _anchor.lon;
+  if (dLat < -kNearSpan || dLat > kNearSpan || dLon < -kNearSpan || dLon > kNearSpan) return false;
+  LocalFrame frame;
+  frame.setOrigin(_anchor.lat, _anchor.lon);
+  int32_t e, n;
+  frame.toLocal(fix.lat, fix.lon, e, n);
+  int64_t r = _cfg.stableRadiusMm;
+  return (int64_t)e * e + (int64_t)n * n <= r * r;
+}
+
+uint32_t PowerGovernor::currentUa(Display d, Gnss g) const {
+  uint32_t ua = g == GNSS_TRACKING ? _cfg.trackingUa : _cfg.backupUa;
+  if (d != DISPLAY_OFF || g != GNSS_BACKUP) {
+    const uint32_t panel[3] = { _cfg.panelOnUa, _cfg.panelDimUa, _cfg.panelSleepUa };
+    ua += panel[d] + _cfg.antennaUa;
+  }
+  return ua;
+}
+
+// charges the time since the last call to the states before any change
+void PowerGovernor::account(uint32_t nowMs) {
+  if (!_started) {
+    _started = true;
+    _lastMs = _activityMs = _gnssSinceMs = _anchorMs = nowMs;
+    return;
+  }
+  uint32_t dt = nowMs - _lastMs;
+  if ((int32_t)dt <= 0) return;   // nothing new, or an input stamped before the last update()
+  _lastMs = nowMs;
+
+  _stats.elapsedMs += dt;
+  _stats.displayMs[_display] += dt;
+  if (!railOn()) _stats.railOffMs += dt;
+
+  uint32_t all = _cfg.panelOnUa + _cfg.antennaUa + _cfg.trackingUa;
+  uint32_t now = currentUa(_display, _gnss);
+  if (all > now) _stats.savedUaMs += (uint64_t)(all - now) * dt;
+
+  // what backup added, taken back if the receiver never went
+  if (_gnss == GNSS_BACKUP) {
+    _stats.backupMs += dt;
+    _backup.ms += dt;
+    if (!railOn()) _backup.railOffMs += dt;
+    uint32_t tracking = currentUa(_display, GNSS_TRACKING);
+    if (tracking > now) _backup.savedUaMs += (uint64_t)(tracking - now) * dt;
+  }
+}
+
+void PowerGovernor::setDisplay(Display d) {
+  if (d == _display) return;
+  if (d == DISPLAY_ON) _stats.displayWakes++;
+  _display = d;
+  _changed = true;
+}
+
+void PowerGovernor::setGnss(uint32_t nowMs, Gnss g) {
+  _gnssSinceMs = nowMs;
+  if (g == _gnss) return;
+  if (g == GNSS_BACKUP) {
+    _stats.backups++;
+    _backup = Credit();
+  }
+  _gnss = g;
+  _changed = true;
+}
+
+void PowerGovernor::backupFailed(uint32_t nowMs) {
+  account(nowMs);
+  if (_gnss != GNSS_BACKUP) return;
+  _stats.backupFailed++;
+  if (_stats.backups) _stats.backups--;
+  _stats.backupMs -= _backup.ms;
+  _stats.railOffMs -= _backup.railOffMs;
+  _stats.savedUaMs -= _backup.savedUaMs;
+  _backup = Credit();
+
+  // another stableS before the next request, none after kMaxBackupFailures in a row
+  if (_failures < kMaxBackupFailures) _failures++;
+  _checking = false;
+  _stable = false;
+  _anchorMs = nowMs;
+  setGnss(nowMs, GNSS_TRACKING);
+}
+
+void PowerGovernor::activity(uint32_t nowMs) {
+  account(nowMs);
+  _activityMs = nowMs;
+  setDisplay(DISPLAY_ON);
+  if (_gnss == GNSS_BACKUP) {
+    // stable again only after another stableS of good fixes
+    _checking = false;
+    _stable = false;
+    _anchorMs = nowMs;
+    setGnss(nowMs, GNSS_TRACKING);
+  }
+}
+
+void PowerGovernor::fix(uint32_t nowMs, const FixRecord& fix, uint32_t speedMms) {
+  account(nowMs);
+  if (_gnss == GNSS_BACKUP) {
+    // an epoch already underway may still arrive; later ones mean the
+    // receiver ignored the request (not a u-blox, or not listening)
+    if (nowMs - _gnssSinceMs < _cfg.backupGraceMs) return;
+    backupFailed(nowMs);
+  }
+
+  bool moving = speedMms >= _cfg.movingMms;
+  if (moving) {
+    _activityMs = nowMs;
+    setDisplay(DISPLAY_ON);
+  }
+  // a bad fix neither confirms nor breaks the anchor
+  if (!good(fix)) return;
+
+  if (moving || !fixHasPosition(_anchor) || !nearAnchor(fix)) {
+    if (_checking) _stats.moved++;
+    _checking = false;
+    _stable = false;
+    _anchor = fix;
+    _anchorMs = nowMs;
+    return;
+  }
+
+  if (_checking) {
+    // hot start confirmed the anchor: straight back
+    _checking = false;
+    setGnss(nowMs, GNSS_BACKUP);
+  } else if (_cfg.stableS && _failures < kMaxBackupFailures && nowMs - _anchorMs >= _cfg.stableS * 1000UL) {
+    _stable = true;
+    setGnss(nowMs, GNSS_BACKUP);
+  }
+}
+
+bool PowerGovernor::update(uint32_t nowMs) {
+  account(nowMs);
+
+  uint32_t idle = nowMs - _activityMs;
+  Display d = DISPLAY_ON;
+  if (_cfg.dimS && idle >= _cfg.dimS * 1000UL) d = DISPLAY_DIM;
+  if (_cfg.offS && idle >= _cfg.offS * 1000UL) d = DISPLAY_OFF;
+  setDisplay(d);
+
+  uint32_t inState = nowMs - _gnssSinceMs;
+  if (_gnss == GNSS_BACKUP) {
+    if (_cfg.backupS && inState >= _cfg.backupS * 1000UL) {
+      _failures = 0;   // no epochs for a whole backupS: the request worked
+      _stats.checks++;
+      _checking = true;
+      setGnss(nowMs, GNSS_TRACKING);
+    }
+  } else if (_checking && inState >= _cfg.checkS * 1000UL) {
+    _stats.checkFailed++;
+    _checking = false;
+    setGnss(nowMs, GNSS_BACKUP);
+  }
+
+  bool changed = _changed;
+  _changed = false;
+  return changed;
+}
+
+uint32_t PowerGovernor::savedUa() const {
+  return _stats.elapsedMs ? (uint32_t)(_stats.savedUaMs / _stats.elapsedMs) : 0;
+}
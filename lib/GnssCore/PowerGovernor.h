@@ -0,0 +1,167 @@
+/**
+ * Display and GNSS power gating from activity, motion and fix quality
+ *
+ * A handheld showing its position draws ~10 mA in the SSD1306 and ~25 mA
+ * in the tracking receiver whether or not anyone looks at it and whether
+ * or not the position changes. PowerGovernor decides from three inputs -
+ * activity, fixes with their speed, and the time - what may be switched
+ * off, and estimates what that saves.
+ *
+ * Display: ON until Config::dimS without activity (button, Serial input,
+ * moving faster than Config::movingMms), then DIM (lowest contrast), OFF
+ * after Config::offS (panel sleep command). Activity turns it back ON.
+ *
+ * GNSS: a fix is good with a 3D (or NMEA, type unknown) solution, at least
+ * Config::minSatellites and an HDOP class up to Config::maxHdopClass. When
+ * good fixes stay within Config::stableRadiusMm of an anchor for
+ * Config::stableS and the receiver is slower than movingMms, it goes to
+ * BACKUP (u-blox RXM-PMREQ, ~30 uA). Ephemeris, almanac and RTC stay in
+ * its backup RAM as long as its supply does, so it resumes with a hot start
+ * in about a second instead of a cold start of 30 s or more. After
+ * Config::backupS it is woken for a check: the first good fix within the
+ * anchor radius sends it back at once, one outside resumes tracking (moved
+ * while asleep), none within Config::checkS (no sky) sends it back too.
+ * Activity resumes tracking, so a button press shows a fresh position.
+ *
+ * Failed backup: the caller reports a request that could not be sent with
+ * backupFailed(); fixes still arriving Config::backupGraceMs after the
+ * request (a receiver that ignores RXM-PMREQ, which has no ACK) count the
+ * same. Either way the receiver is tracking again, the time since the
+ * request is not counted as saved, and the next attempt needs another
+ * stableS. A check wake (a backup that held for backupS) clears the count;
+ * after kMaxBackupFailures in a row no more requests are made.
+ *
+ * Rail: on the Heltec V4 the switched Vext rail feeds the panel and the
+ * active antenna; railOn() is false only while the display is OFF and the
+ * receiver in BACKUP, then the panel needs a fresh init on the next ON.
+ *
+ * Estimate: time in each state is weighed with the Config current figures
+ * (typical values, measure your board) against everything on all the time.
+ *
+ * Clock: any millisecond clock; update() drives the timers, the inputs
+ * may come at any rate.
+ *
+ * Usage:
+ *   static PowerGovernor governor;
+ *   button / Serial:        governor.activity(millis());
+ *   each navigation epoch:  governor.fix(millis(), record, speedMms);
+ *   if (governor.update(millis())) ... apply display() / gnss() / railOn()
+ *   governor.savedUa()      average current saved since resetStats()
+ */
+
+#ifndef POWER_GOVERNOR_H
+#define POWER_GOVERNOR_H
+
+#include <stdint.h>
+#include "FixRecord.h"
+
+class PowerGovernor {
+public:
+  static const uint8_t kMaxBackupFailures = 3;
+
+  enum Display : uint8_t {
+    DISPLAY_ON,
+    DISPLAY_DIM,
+    DISPLAY_OFF
+  };
+
+  enum Gnss : uint8_t {
+    GNSS_TRACKING,
+    GNSS_BACKUP
+  };
+
+  struct Config {
+    uint16_t dimS = 30;                   // no activity: lowest contrast
+    uint16_t offS = 120;                  // no activity: panel off (0 = dim only)
+    uint16_t movingMms = 1000;            // faster = moving: activity, never stable
+    uint8_t minSatellites = 6;
+    uint8_t maxHdopClass = 2;             // FixRecord class, 2 = HDOP <= 2
+    uint32_t stableRadiusMm = 15000;      // good fixes stay this close to the anchor ...
+    uint16_t stableS = 60;                // ... this long: receiver to backup (0 = never)
+    uint16_t backupS = 300;               // backup this long, then a check fix (0 = until activity)
+    uint16_t checkS = 60;                 // no good fix this long after waking: back to backup
+    uint16_t backupGraceMs = 1500;        // fixes this long after the request may be late ones
+
+    // current figures for the estimate, uA
+    uint32_t panelOnUa = 10000;           // SSD1306, a screen of text at default contrast
+    uint32_t panelDimUa = 3000;
+    uint32_t panelSleepUa = 10;           // display off command, rail still on
+    uint32_t antennaUa = 5000;            // active antenna on the same rail
+    uint32_t trackingUa = 25000;          // receiver tracking / reacquiring
+    uint32_t backupUa = 30;
+  };
+
+  struct Stats {
+    uint32_t elapsedMs;
+    uint32_t displayMs[3];    // per Display state
+    uint32_t backupMs;
+    uint32_t railOffMs;
+    uint32_t backups;         // entered backup (failed ones not counted)
+    uint32_t backupFailed;    // request not sent, or fixes kept coming
+    uint32_t checks;          // woken by backupS for a check fix
+    uint32_t checkFailed;     // ... and no good fix within checkS
+    uint32_t moved;           // a check fix outside the anchor radius
+    uint32_t displayWakes;    // DIM / OFF -> ON
+    uint64_t savedUaMs;       // against everything on all the time
+  };
+
+  PowerGovernor();
+  explicit PowerGovernor(const Config& config);
+
+  // the user did something: display ON, receiver tracking
+  void activity(uint32_t nowMs);
+  // one navigation solution with the receiver's ground speed
+  void fix(uint32_t nowMs, const FixRecord& fix, uint32_t speedMms);
+  // the backup request could not be sent: tracking again
+  void backupFailed(uint32_t nowMs);
+  // timers; true if display(), gnss() or railOn() changed since the last call
+  bool update(uint32_t nowMs);
+
+  Display display() const { return _display; }
+  Gnss gnss() const { return _gnss; }
+  bool railOn() const { return _display != DISPLAY_OFF || _gnss != GNSS_BACKUP; }
+  // anchor held long enough (or the receiver in backup)
+  bool stable() const { return _gnss == GNSS_BACKUP || _stable; }
+
+  const Stats& stats() const { return _stats; }
+  void resetStats() { _stats = Stats(); _backup = Credit(); }
+  // average current saved since resetStats(), uA
+  uint32_t savedUa() const;
+  // total charge saved since resetStats(), mAh
+  uint32_t savedMah() const { return (uint32_t)(_stats.savedUaMs / 3600000000ULL); }
+
+private:
+  // what the current backup added to the stats
+  struct Credit {
+    uint32_t ms;
+    uint32_t railOffMs;
+    uint64_t savedUaMs;
+  };
+
+  bool good(const FixRecord& fix) const;
+  bool nearAnchor(const FixRecord& fix) const;
+  void account(uint32_t nowMs);
+  uint32_t currentUa(Display d, Gnss g) const;
+  void setDisplay(Display d);
+  void setGnss(uint32_t nowMs, Gnss g);
+
+  Config _cfg;
+  Display _display = DISPLAY_ON;
+  Gnss _gnss = GNSS_TRACKING;
+  bool _changed = false;
+  bool _started = false;
+
+  uint32_t _lastMs = 0;          // accounted up to here
+  uint32_t _activityMs = 0;
+  uint32_t _gnssSinceMs = 0;     // entered the current Gnss state / started the check
+  bool _checking = false;        // woken by the timer, awaiting a good fix
+  uint8_t _failures = 0;         // failed backups in a row
+  Credit _backup = {};
+
+  FixRecord _anchor = {};        // no position = none
+  uint32_t _anchorMs = 0;
+  bool _stable = false;
+  Stats _stats = {};
+};
+
+#endif // POWER_GOVERNOR_H
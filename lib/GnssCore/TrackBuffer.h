@@ -0,0 +1,179 @@
+/**
+ * Two-tier FIFO of track points: SRAM hot window, bulk arena behind it
+ *
+ * A FIFO of FixRecords (push / at / peek / drop) for store-and-forward
+ * through long uplink outages. New points go into a
+ * small ring in internal SRAM. When it fills up, its oldest Batch points
+ * are moved out in one bulk copy into an arena, typically PSRAM. Readers
+ * see one FIFO: the arena holds the older points and the hot ring the newer
+ * ones, and at(0) is always the oldest point.
+ *
+ * The split keeps the per-fix path in SRAM. push() is a 16-byte store;
+ * only every Batch-th push pays for one Batch * 16-byte copy. The arena is
+ * only touched in whole batches (spill) or in sequential runs (peek), which
+ * is the access pattern PSRAM behind the cache handles best. Batches start
+ * at multiples of Batch in the arena, so a spill never wraps and is always
+ * one contiguous copy.
+ *
+ * Points stay queued until drop(n) confirms they went out. When the arena
+ * is full, a spill overwrites its oldest batch and counts those points as
+ * dropped. Without an arena the buffer is just the Hot-sized SRAM ring.
+ *
+ * The arena memory belongs to the caller and must outlive the buffer
+ * (heap_caps_malloc(MALLOC_CAP_SPIRAM) on the ESP32-S3). The copy function
+ * can be replaced, e.g. by a DMA copy that blocks until it is done. Single
+ * context only; Hot must be a power of two, and Batch at most Hot.
+ *
+ * Usage:
+ *   static TrackBuffer<256, 64> track;
+ *   void* arena = heap_caps_malloc(1 << 20, MALLOC_CAP_SPIRAM);
+ *   if (arena) track.attachArena((FixRecord*)arena, (1 << 20) / sizeof(FixRecord));
+ *   track.push(record);
+ *   size_t n = track.peek(batch, 64);
+ *   ... send ...
+ *   track.drop(sent);
+ */
+
+#ifndef TRACK_BUFFER_H
+#define TRACK_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "FixRecord.h"
+
+template <size_t Hot, size_t Batch = Hot / 4>
+class TrackBuffer {
+  static_assert(Hot && (Hot & (Hot - 1)) == 0, "TrackBuffer hot ring size must be a power of two");
+  static_assert(Batch && Batch <= Hot, "TrackBuffer batch must be 1..Hot points");
+
+public:
+  // bulk copy between the tiers (memcpy by default)
+  typedef void (*Mover)(void* dst, const void* src, size_t bytes, void* arg);
+
+  struct Stats {
+    uint32_t spills;       // batches moved into the arena
+    uint32_t spilledBytes;
+    uint32_t arenaReads;   // contiguous runs copied back by peek()
+  };
+
+  // records is rounded down to whole batches; nullptr / 0 detaches
+  void attachArena(FixRecord* arena, size_t records) {
+    _arena = arena;
+    _arenaCap = arena ? (uint32_t)(records / Batch * Batch) : 0;
+    _arenaPos = _arenaCount = 0;
+  }
+
+  void setMover(Mover fn, void* arg) {
+    _mover = fn ? fn : copy;
+    _moverArg = arg;
+  }
+
+  void push(const FixRecord& p) {
+    if (hotSize() == Hot) {
+      if (_arenaCap) spill();
+      else {
+        _hotTail++;
+        _dropped++;
+      }
+    }
+    _hot[_hotHead++ & (Hot - 1)] = p;
+  }
+
+  size_t size() const { return arenaSize() + hotSize(); }
+  bool empty() const { return size() == 0; }
+  size_t capacity() const { return Hot + _arenaCap; }
+
+  size_t hotSize() const { return (size_t)(_hotHead - _hotTail); }
+  size_t arenaSize() const { return _arenaCount; }
+
+  // i = 0 is the oldest point
+  const FixRecord& at(size_t i) const {
+    size_t a = arenaSize();
+    if (i < a) return _arena[(_arenaPos + i) % _arenaCap];
+    return _hot[(_hotTail + (i - a)) & (Hot - 1)];
+  }
+
+  // copies up to max of the oldest points in order; returns the count
+  size_t peek(FixRecord* out, size_t max) {
+    size_t n = size() < max ? size() : max;
+    size_t done = 0;
+
+    // arena: at most two contiguous runs
+    while (done < n && done < arenaSize()) {
+      uint32_t pos = (uint32_t)((_arenaPos + done) % _arenaCap);
+      size_t run = _arenaCap - pos;
+      if (run > arenaSize() - done) run = arenaSize() - done;
+      if (run > n - done) run = n - done;
+      _mover(out + done, _arena + pos, run * sizeof(FixRecord), _moverArg);
+      _stats.arenaReads++;
+      done += run;
+    }
+    for (; done < n; done++) out[done] = at(done);
+    return n;
+  }
+
+  void drop(size_t n) {
+    size_t a = arenaSize();
+    if (n <= a) {
+      arenaDrop((uint32_t)n);
+      return;
+    }
+    arenaDrop((uint32_t)a);
+    n -= a;
+    _hotTail += n < hotSize() ? (uint32_t)n : (uint32_t)hotSize();
+  }
+
+  void clear() {
+    arenaDrop(_arenaCount);
+    _hotTail = _hotHead;
+  }
+
+  uint32_t dropped() const { return _dropped; }
+  const Stats& stats() const { return _stats; }
+
+private:
+  static void copy(void* dst, const void* src, size_t bytes, void*) { memcpy(dst, src, bytes); }
+
+  // the write position pos + count stays put, so it remains batch aligned
+  void arenaDrop(uint32_t n) {
+    if (!n) return;
+    _arenaPos = (_arenaPos + n) % _arenaCap;
+    _arenaCount -= n;
+  }
+
+  // moves the oldest Batch hot points to the arena head
+  void spill() {
+    if (_arenaCount + Batch > _arenaCap) {
+      uint32_t lost = (uint32_t)(_arenaCount + Batch - _arenaCap);
+      arenaDrop(lost);
+      _dropped += lost;
+    }
+
+    FixRecord* dst = _arena + (_arenaPos + _arenaCount) % _arenaCap;
+    size_t first = (size_t)(_hotTail & (Hot - 1));
+    size_t run = Hot - first < Batch ? Hot - first : Batch;
+    _mover(dst, _hot + first, run * sizeof(FixRecord), _moverArg);
+    if (run < Batch) _mover(dst + run, _hot, (Batch - run) * sizeof(FixRecord), _moverArg);
+
+    _arenaCount += (uint32_t)Batch;
+    _hotTail += (uint32_t)Batch;
+    _stats.spills++;
+    _stats.spilledBytes += (uint32_t)(Batch * sizeof(FixRecord));
+  }
+
+  alignas(32) FixRecord _hot[Hot];   // cache-line aligned, batches qualify for DMA
+  uint32_t _hotHead = 0, _hotTail = 0;
+
+  FixRecord* _arena = nullptr;
+  uint32_t _arenaCap = 0;                 // records, a multiple of Batch
+  uint32_t _arenaPos = 0;                 // oldest point
+  uint32_t _arenaCount = 0;
+
+  Mover _mover = copy;
+  void* _moverArg = nullptr;
+  uint32_t _dropped = 0;
+  Stats _stats = {};
+};
+
+#endif // TRACK_BUFFER_H
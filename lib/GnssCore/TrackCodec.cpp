@@ -0,0 +1,104 @@
+#include "TrackCodec.h"
+
+static const int32_t kQuantum[] = { 1, 10, 100, 1000 };
+
+size_t varintPut(uint8_t* out, size_t cap, uint32_t v) {
+  size_t n = 0;
+  do {
+    if (n == cap) return 0;
+    uint8_t b = v & 0x7F;
+    v >>= 7;
+    out[n++] = v ? (uint8_t)(b | 0x80) : b;
+  } while (v);
+  return n;
+}
+
+size_t varintGet(const uint8_t* in, size_t len, uint32_t& v) {
+  v = 0;
+  for (size_t i = 0; i < len && i < 5; i++) {
+    v |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+    if (!(in[i] & 0x80)) return i + 1;
+  }
+  return 0;
+}
+
+// round half away from zero to a multiple of q
+static int32_t quantize(int32_t v, int32_t q) {
+  return v >= 0 ? (v + q / 2) / q : -((-v + q / 2) / q);
+}
+
+size_t trackEncode(const FixRecord* points, size_t n, uint8_t quantum,
+                   uint8_t* out, size_t cap, size_t& encoded) {
+  encoded = 0;
+  if (n == 0 || cap < 2 || quantum > 3) return 0;
+  if (n > TRACK_MAX_BATCH) n = TRACK_MAX_BATCH;
+
+  int32_t q = kQuantum[quantum];
+  out[0] = (uint8_t)((TRACK_CODEC_VERSION << 6) | (quantum << 4));
+  size_t pos = 2;
+
+  uint32_t prevTime = 0;
+  int32_t prevLat = 0, prevLon = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    int32_t lat = quantize(points[i].lat, q);
+    int32_t lon = quantize(points[i].lon, q);
+    uint32_t time = fixUnixSeconds(points[i]);
+
+    if (!fixIsComplete(points[i])) break;
+    if (i && time < prevTime) break;   // not in time order
+    // the first point is a delta against zero
+    uint32_t dt = time - prevTime;
+
+    uint8_t tmp[15];
+    size_t len = varintPut(tmp, sizeof(tmp), dt);
+    // differences wrap modulo 2^32 (first longitude can be 1.8e9 from zero)
+    len += varintPut(tmp + len, sizeof(tmp) - len, zigzag((int32_t)((uint32_t)lat - (uint32_t)prevLat)));
+    len += varintPut(tmp + len, sizeof(tmp) - len, zigzag((int32_t)((uint32_t)lon - (uint32_t)prevLon)));
+    if (pos + len > cap) break;
+
+    for (size_t k = 0; k < len; k++) out[pos + k] = tmp[k];
+    pos += len;
+    prevTime = time;
+    prevLat = lat;
+    prevLon = lon;
+    encoded++;
+  }
+
+  if (!encoded) return 0;
+  out[1] = (uint8_t)encoded;
+  return pos;
+}
+
+size_t trackDecode(const uint8_t* in, size_t len, FixRecord* points, size_t maxPoints) {
+  if (len < 2 || (in[0] >> 6) != TRACK_CODEC_VERSION) return 0;
+  int32_t q = kQuantum[(in[0] >> 4) & 0x03];
+  size_t count = in[1];
+  if (count > maxPoints) count = maxPoints;
+
+  size_t pos = 2;
+  uint32_t time = 0;
+  uint32_t lat = 0, lon = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t dt, zlat, zlon;
+    size_t n;
+    if (!(n = varintGet(in + pos, len - pos, dt))) return 0;
+    pos += n;
+    if (!(n = varintGet(in + pos, len - pos, zlat))) return 0;
+    pos += n;
+    if (!(n = varintGet(in + pos, len - pos, zlon))) return 0;
+    pos += n;
+
+    time += dt;
+    lat += (uint32_t)unzigzag(zlat);
+    lon += (uint32_t)unzigzag(zlon);
+    FixRecord& r = points[i];
+    r = FixRecord();
+    fixRecordSetTime(r, (uint64_t)time * 1000);
+    fixRecordSetQuality(r, FIX_TYPE_POSITION, 0, 0);
+    r.lat = (int32_t)lat * q;
+    r.lon = (int32_t)lon * q;
+  }
+  return count;
+}
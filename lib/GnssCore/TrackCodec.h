@@ -0,0 +1,55 @@
+/**
+ * Batched, delta-compressed track points for LoRa uplinks
+ *
+ * A batch carries one absolute point followed by the differences of every
+ * further point to its predecessor, all as LEB128 varints (zigzag for the
+ * signed values). Consecutive vehicle fixes differ by a few hundred units
+ * at most, so a point costs 3-5 bytes instead of 12.
+ *
+ * Wire format (little endian, all varints unsigned LEB128):
+ *
+ *   byte 0    bits 7-6 version (1), bits 5-4 quantum q, bits 3-0 reserved
+ *   byte 1    number of points
+ *   varint    time of the first point, Unix seconds
+ *   zvarint   latitude of the first point, units of 1e-7 deg * 10^q
+ *   zvarint   longitude of the first point
+ *   per further point:
+ *     varint  seconds since the previous point
+ *     zvarint latitude delta
+ *     zvarint longitude delta
+ *
+ * Every point is quantized before the deltas are taken, so rounding never
+ * accumulates along the batch. q = 2 (1e-5 deg, ~1.1 m) is below GNSS
+ * noise and is what the tracker sends.
+ *
+ * Points are FixRecords with a date and a position (fixIsComplete()); only
+ * the Unix second and the coordinates go on air. Decoded records carry
+ * those, FIX_TYPE_POSITION and no quality or antenna bits.
+ */
+
+#ifndef TRACK_CODEC_H
+#define TRACK_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FixRecord.h"
+
+#define TRACK_CODEC_VERSION 1
+#define TRACK_MAX_BATCH     255
+
+// LEB128 helpers, return bytes written / read (0 = does not fit / truncated)
+size_t varintPut(uint8_t* out, size_t cap, uint32_t v);
+size_t varintGet(const uint8_t* in, size_t len, uint32_t& v);
+inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// encodes as many of points[0..n) as fit into cap bytes; returns the batch
+// size in bytes and the number of points taken in `encoded` (0 if none fit)
+size_t trackEncode(const FixRecord* points, size_t n, uint8_t quantum,
+                   uint8_t* out, size_t cap, size_t& encoded);
+
+// decodes up to maxPoints points (coordinates back in 1e-7 deg);
+// returns the number of points, 0 on a malformed batch
+size_t trackDecode(const uint8_t* in, size_t len, FixRecord* points, size_t maxPoints);
+
+#endif // TRACK_CODEC_H
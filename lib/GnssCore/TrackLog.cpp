@@ -0,0 +1,211 @@
+#include "TrackLog.h"
+
+static const uint32_t kSectorMagic = 0x32474C54;   // "TLG2", FixRecord slots
+static const uint32_t kEraseBlockSectors = 16;     // 64 KB, one block erase command
+
+bool TrackLog::readHeader(uint32_t sector, SectorHeader& h) {
+  if (!_storage->read(sector * kSectorSize, &h, sizeof(h))) return false;
+  return h.magic == kSectorMagic && h.check == ~(h.magic ^ h.sequence ^ h.eraseCount);
+}
+
+uint32_t TrackLog::eraseCount(uint32_t sector) {
+  SectorHeader h;
+  return readHeader(sector, h) ? h.eraseCount : 0;
+}
+
+bool TrackLog::writeHeader(uint32_t sector, uint32_t sequence, uint32_t eraseCount) {
+  SectorHeader h;
+  h.magic = kSectorMagic;
+  h.sequence = sequence;
+  h.eraseCount = eraseCount;
+  h.check = ~(h.magic ^ h.sequence ^ h.eraseCount);
+  if (!_storage->write(sector * kSectorSize, &h, sizeof(h))) {
+    _stats.writeErrors++;
+    return false;
+  }
+  if (eraseCount > _stats.maxEraseCount) _stats.maxEraseCount = eraseCount;
+  return true;
+}
+
+bool TrackLog::openSector(uint32_t sector, uint32_t sequence) {
+  uint32_t erases = eraseCount(sector);
+  if (!_storage->erase(sector * kSectorSize, kSectorSize)) {
+    _stats.writeErrors++;
+    return false;
+  }
+  _stats.erases++;
+  if (!writeHeader(sector, sequence, erases + 1)) return false;
+
+  _head = sector;
+  _sequence = sequence;
+  _fill = 0;
+  return true;
+}
+
+bool TrackLog::slotErased(uint32_t sector, size_t slot) {
+  uint8_t b[kRecordSize];
+  if (!_storage->read(slotOffset(sector, slot), b, sizeof(b))) return false;
+  for (size_t i = 0; i < sizeof(b); i++) {
+    if (b[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+bool TrackLog::begin(TrackLogStorage& storage) {
+  _storage = &storage;
+  _sectors = storage.size() / kSectorSize;
+  _staged = 0;
+  _stats = {};
+  if (_sectors < 2) return false;
+
+  // head = highest sequence number
+  bool found = false;
+  uint32_t head = 0, sequence = 0;
+  for (uint32_t s = 0; s < _sectors; s++) {
+    SectorHeader h;
+    if (!readHeader(s, h)) continue;
+    if (h.eraseCount > _stats.maxEraseCount) _stats.maxEraseCount = h.eraseCount;
+    if (!h.sequence) continue;   // erased by erase(), holds no records
+    if (!found || h.sequence > sequence) {
+      found = true;
+      head = s;
+      sequence = h.sequence;
+    }
+  }
+
+  if (!found) {
+    _tail = 0;
+    _used = 1;
+    return openSector(0, 1);
+  }
+
+  // walk back over the contiguous run of sequence numbers
+  _head = head;
+  _sequence = sequence;
+  _tail = head;
+  _used = 1;
+  while (_used < _sectors) {
+    uint32_t prev = (_tail + _sectors - 1) % _sectors;
+    SectorHeader h;
+    if (!readHeader(prev, h) || !h.sequence || h.sequence != sequence - _used) break;
+    _tail = prev;
+    _used++;
+  }
+
+  // records are programmed in order, so the written slots form a prefix
+  size_t lo = 0, hi = kRecordsPerSector;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (slotErased(_head, mid)) hi = mid;
+    else lo = mid + 1;
+  }
+  _fill = lo;
+
+  if (_fill == kRecordsPerSector) return flush();   // full head: open the next one
+  return true;
+}
+
+bool TrackLog::append(const FixRecord& r) {
+  if (!_storage) return false;
+  _stage[_staged] = r;
+  fixRecordSeal(_stage[_staged++]);
+  _stats.appended++;
+
+  // the header takes slot 0, so page boundaries fall at fill + 1 = 16, 32, ...
+  if ((_fill + _staged + 1) % kStageRecords == 0) return flush();
+  return true;
+}
+
+bool TrackLog::flush() {
+  if (!_storage) return false;
+
+  if (_staged) {
+    bool ok = _storage->write(slotOffset(_head, _fill), _stage, _staged * kRecordSize);
+    // a failed program leaves the slots undefined: skip them either way
+    _fill += _staged;
+    _staged = 0;
+    _stats.programs++;
+    if (!ok) {
+      _stats.writeErrors++;
+      if (_fill < kRecordsPerSector) return false;
+    }
+  }
+  if (_fill < kRecordsPerSector) return true;
+
+  // head full: recycle the next sector, dropping the oldest if the log wrapped
+  uint32_t next = (_head + 1) % _sectors;
+  if (_used == _sectors) {
+    _tail = (_tail + 1) % _sectors;
+    _used--;
+    _stats.recycled += kRecordsPerSector;
+  }
+  if (!openSector(next, _sequence + 1)) return false;
+  _used++;
+  return true;
+}
+
+size_t TrackLog::count() const {
+  return _used ? (size_t)(_used - 1) * kRecordsPerSector + _fill : 0;
+}
+
+size_t TrackLog::read(size_t index, FixRecord* out, size_t max) {
+  size_t total = count();
+  if (!_storage || index >= total) return 0;
+
+  uint32_t sector = (_tail + (uint32_t)(index / kRecordsPerSector)) % _sectors;
+  size_t slot = index % kRecordsPerSector;
+  size_t n = kRecordsPerSector - slot;
+  if (n > total - index) n = total - index;
+  if (n > max) n = max;
+
+  return _storage->read(slotOffset(sector, slot), out, n * kRecordSize) ? n : 0;
+}
+
+bool TrackLog::read(size_t index, FixRecord& out) {
+  return read(index, &out, 1) == 1 && fixRecordValid(out);
+}
+
+uint32_t TrackLog::timeFrom(size_t index) {
+  FixRecord r;
+  for (size_t total = count(); index < total; index++) {
+    if (read(index, r)) return fixUnixSeconds(r);
+  }
+  return UINT32_MAX;
+}
+
+size_t TrackLog::seek(uint32_t unixTime) {
+  size_t lo = 0, hi = count();
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (timeFrom(mid) < unixTime) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+bool TrackLog::erase() {
+  if (!_storage) return false;
+  _staged = 0;
+  _stats.maxEraseCount = 0;
+
+  // a block at a time: its headers' erase counts are kept in RAM across
+  // the erase and written back, sector 0 opening the new log
+  for (uint32_t first = 0; first < _sectors; first += kEraseBlockSectors) {
+    uint32_t n = _sectors - first < kEraseBlockSectors ? _sectors - first : kEraseBlockSectors;
+    uint32_t erases[kEraseBlockSectors];
+    for (uint32_t i = 0; i < n; i++) erases[i] = eraseCount(first + i);
+    if (!_storage->erase(first * kSectorSize, n * kSectorSize)) {
+      _stats.writeErrors++;
+      return false;
+    }
+    _stats.erases += n;
+    for (uint32_t i = 0; i < n; i++) {
+      if (!writeHeader(first + i, first + i ? 0 : 1, erases[i] + 1)) return false;
+    }
+  }
+  _head = _tail = 0;
+  _used = 1;
+  _sequence = 1;
+  _fill = 0;
+  return true;
+}
@@ -0,0 +1,142 @@
+/**
+ * Append-only track log on raw flash
+ *
+ * 16-byte FixRecords in a circular sequence of 4 KB flash sectors,
+ * written without a filesystem. Every sector starts with a 16-byte header
+ * (magic, sequence number, erase count) and holds 255 records; records
+ * never straddle a sector.
+ *
+ * Writes: append() only stages the record in RAM. The stage is programmed
+ * as soon as it reaches the end of a 256-byte flash page, so every program
+ * operation covers whole page slices and no byte is written twice. When
+ * the head sector is full the next one is erased and opened; if that was
+ * the oldest sector, its records are dropped. Sectors are thus recycled
+ * strictly round-robin and all of them wear at the same rate: at 10 Hz a
+ * 8 MB partition turns over every ~14 h, i.e. 100k erase cycles last
+ * longer than the flash retention.
+ *
+ * Recovery: begin() reads the sector headers, picks the highest sequence
+ * as head and finds its fill level with a binary search for the first
+ * erased slot. Records lost in a power cut are at most the staged ones
+ * (< 16); a torn record fails its CRC and is skipped by readers.
+ * append() seals every record (fixRecordSeal()), callers need not.
+ *
+ * Reading: records are addressed by index, 0 = oldest. Record times only
+ * grow, so seek() finds the first record at or after a Unix time with a
+ * binary search, ~20 record reads over the whole log.
+ *
+ * Storage is abstract (TrackLogStorage) so the log runs on the ESP32 flash
+ * partition driver (PartitionTrackStorage in lib/HeltecV4) or on a RAM
+ * image on the host.
+ *
+ * Usage:
+ *   static PartitionTrackStorage flash;
+ *   static TrackLog trackLog;
+ *   flash.begin("tracklog");
+ *   trackLog.begin(flash);
+ *   ...
+ *   FixRecord r;
+ *   fixRecordFromFix(fix, r);
+ *   if (fixIsComplete(r)) trackLog.append(r);
+ */
+
+#ifndef TRACK_LOG_H
+#define TRACK_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FixRecord.h"
+
+class TrackLogStorage {
+public:
+  virtual ~TrackLogStorage() {}
+
+  // usable bytes, a multiple of the erase sector
+  virtual uint32_t size() const = 0;
+  virtual bool read(uint32_t offset, void* out, size_t len) = 0;
+  // programs erased bytes only (NOR flash: 1 -> 0)
+  virtual bool write(uint32_t offset, const void* data, size_t len) = 0;
+  // offset and len are sector aligned
+  virtual bool erase(uint32_t offset, size_t len) = 0;
+};
+
+class TrackLog {
+public:
+  static const uint32_t kSectorSize = 4096;
+  static const uint32_t kPageSize = 256;
+  static const size_t kRecordSize = sizeof(FixRecord);
+  static const size_t kRecordsPerSector = kSectorSize / kRecordSize - 1;   // slot 0 = header
+  static const size_t kStageRecords = kPageSize / kRecordSize;
+
+  struct Stats {
+    uint32_t appended;
+    uint32_t programs;      // page writes
+    uint32_t erases;        // sectors erased by this session
+    uint32_t recycled;      // records dropped when the oldest sector was reused
+    uint32_t writeErrors;
+    uint32_t maxEraseCount; // most worn sector seen (header counters)
+  };
+
+  // recovers the log from storage (or formats the first sector of an empty one)
+  bool begin(TrackLogStorage& storage);
+
+  // seals and stages a record; programs the stage once it reaches a page boundary
+  bool append(const FixRecord& r);
+  // programs whatever is staged now (before sleep / power off / export)
+  bool flush();
+
+  // records in flash, staged ones not included
+  size_t count() const;
+  size_t capacity() const { return (size_t)_sectors * kRecordsPerSector; }
+  size_t staged() const { return _staged; }
+
+  // record `index` (0 = oldest); false if out of range or torn
+  bool read(size_t index, FixRecord& out);
+  // up to max consecutive records from `index` in one storage read (stops at
+  // the sector end); torn records are included, check fixRecordValid()
+  size_t read(size_t index, FixRecord* out, size_t max);
+
+  // index of the first record with time >= unixTime (count() if none)
+  size_t seek(uint32_t unixTime);
+
+  // erases every sector and starts over (~20 s for 8 MB, blocks); each
+  // sector's erase count is carried over, so the wear figure survives
+  bool erase();
+
+  const Stats& stats() const { return _stats; }
+
+private:
+  struct SectorHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t eraseCount;
+    uint32_t check;
+  };
+
+  bool readHeader(uint32_t sector, SectorHeader& h);
+  uint32_t eraseCount(uint32_t sector);
+  // sequence 0: erased, no records (erase())
+  bool writeHeader(uint32_t sector, uint32_t sequence, uint32_t eraseCount);
+  bool openSector(uint32_t sector, uint32_t sequence);
+  uint32_t slotOffset(uint32_t sector, size_t slot) const {
+    return sector * kSectorSize + (uint32_t)(slot + 1) * kRecordSize;
+  }
+  bool slotErased(uint32_t sector, size_t slot);
+  // time of the first intact record at or after index (UINT32_MAX if none)
+  uint32_t timeFrom(size_t index);
+
+  TrackLogStorage* _storage = nullptr;
+  uint32_t _sectors = 0;
+  uint32_t _tail = 0;        // oldest sector
+  uint32_t _head = 0;        // sector being filled
+  uint32_t _used = 0;        // sectors tail..head
+  uint32_t _sequence = 0;    // head sector's sequence
+  size_t _fill = 0;          // records programmed into the head sector
+
+  FixRecord _stage[kStageRecords];
+  size_t _staged = 0;
+
+  Stats _stats = {};
+};
+
+#endif // TRACK_LOG_H
@@ -0,0 +1,200 @@
+#include "Ubx.h"
+#include <string.h>
+#include "FixRecord.h"
+
+void ubxChecksum(const uint8_t* data, size_t len, uint8_t& ckA, uint8_t& ckB) {
+  uint8_t a = ckA, b = ckB;
+  for (size_t i = 0; i < len; i++) {
+    a += data[i];
+    b += a;
+  }
+  ckA = a;
+  ckB = b;
+}
+
+size_t ubxBuild(uint8_t* out, uint8_t cls, uint8_t id, const uint8_t* payload, uint16_t len) {
+  out[0] = UBX_SYNC1;
+  out[1] = UBX_SYNC2;
+  out[2] = cls;
+  out[3] = id;
+  out[4] = (uint8_t)(len & 0xFF);
+  out[5] = (uint8_t)(len >> 8);
+  if (len) memcpy(out + 6, payload, len);
+
+  uint8_t a = 0, b = 0;
+  ubxChecksum(out + 2, 4 + (size_t)len, a, b);
+  out[6 + len] = a;
+  out[7 + len] = b;
+  return (size_t)len + UBX_FRAME_OVERHEAD;
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+size_t ubxCfgPrt(uint8_t* out, uint32_t baud, uint16_t inProto, uint16_t outProto) {
+  uint8_t p[20] = {};
+  p[0] = 1;                 // portID: UART1
+  put32(p + 4, 0x000008D0); // mode: 8 data bits, no parity, 1 stop bit
+  put32(p + 8, baud);
+  put16(p + 12, inProto);
+  put16(p + 14, outProto);
+  return ubxBuild(out, UBX_CFG, UBX_CFG_PRT, p, sizeof(p));
+}
+
+size_t ubxCfgMsg(uint8_t* out, uint8_t cls, uint8_t id, uint8_t rate) {
+  uint8_t p[3] = { cls, id, rate };
+  return ubxBuild(out, UBX_CFG, UBX_CFG_MSG, p, sizeof(p));
+}
+
+size_t ubxCfgRate(uint8_t* out, uint16_t measRateMs) {
+  uint8_t p[6];
+  put16(p, measRateMs);
+  put16(p + 2, 1);          // navRate: one solution per measurement
+  put16(p + 4, 1);          // timeRef: GPS time
+  return ubxBuild(out, UBX_CFG, UBX_CFG_RATE, p, sizeof(p));
+}
+
+size_t ubxCfgSaveBbr(uint8_t* out) {
+  uint8_t p[13] = {};
+  put32(p + 4, 0x00001F1F); // saveMask: every section (ports, messages, navigation, ...)
+  p[12] = 0x01;             // deviceMask: BBR, flash stays untouched
+  return ubxBuild(out, UBX_CFG, UBX_CFG_CFG, p, sizeof(p));
+}
+
+size_t ubxRxmPmreqBackup(uint8_t* out, uint32_t durationMs) {
+  uint8_t p[16] = {};       // version 0
+  put32(p + 4, durationMs);
+  put32(p + 8, 0x00000006); // flags: backup, force
+  put32(p + 12, 0x00000008);// wakeupSources: UART RX
+  return ubxBuild(out, UBX_RXM, UBX_RXM_PMREQ, p, sizeof(p));
+}
+
+bool ubxDecodeNavPvt(const UbxFrame& f, UbxNavPvt& out) {
+  if (f.cls != UBX_NAV || f.id != UBX_NAV_PVT || f.length < sizeof(UbxNavPvt)) return false;
+  memcpy(&out, f.payload, sizeof(UbxNavPvt));   // both sides little endian
+  return true;
+}
+
+void ubxNavPvtToFix(const UbxNavPvt& pvt, GnssFix& fix) {
+  fix.timeValid = (pvt.valid & 0x02) != 0;
+  fix.locationValid = (pvt.flags & 0x01) && (pvt.fixType >= 2 && pvt.fixType <= 4);
+
+  // hh:mm:ss is rounded, nano carries the signed remainder
+  int32_t ms = (((int32_t)pvt.hour * 60 + pvt.min) * 60 + pvt.sec) * 1000 + pvt.nano / 1000000;
+  if (pvt.nano < 0 && pvt.nano % 1000000) ms--;
+  // the date belongs to the rounded time; drop it when the rounding crosses midnight
+  fix.dateValid = (pvt.valid & 0x01) != 0;
+  fix.year = pvt.year;
+  fix.month = pvt.month;
+  fix.day = pvt.day;
+  if (ms < 0) { ms += 86400000; fix.dateValid = false; }
+  if (ms >= 86400000) { ms -= 86400000; fix.dateValid = false; }
+
+  fix.hour = (uint8_t)(ms / 3600000);
+  fix.minute = (uint8_t)(ms / 60000 % 60);
+  fix.second = (uint8_t)(ms / 1000 % 60);
+  fix.centisecond = (uint8_t)(ms % 1000 / 10);
+
+  fix.lat = fixCoordFrom1e7(pvt.lat);
+  fix.lon = fixCoordFrom1e7(pvt.lon);
+
+  // NAV-PVT has no HDOP; pDOP (>= HDOP) is the closest figure
+  fix.fixType = fix.locationValid ? (FixType)pvt.fixType
+                                  : fix.timeValid ? FIX_TYPE_TIME_ONLY : FIX_TYPE_NONE;
+  fix.satellites = pvt.numSV;
+  fix.hdop = pvt.pDOP;
+}
+
+bool ubxDecodeAntenna(const UbxFrame& f, GnssAntenna& out) {
+  if (f.cls != UBX_MON || f.id != UBX_MON_HW || f.length < 21) return false;
+  switch (f.payload[20]) {
+    case 2:  out = ANTENNA_OK; break;
+    case 3:
+    case 4:  out = ANTENNA_OPEN; break;   // the screen only knows OK / OPEN
+    default: out = ANTENNA_UNKNOWN; break;
+  }
+  return true;
+}
+
+bool UbxParser::feed(uint8_t c) {
+  switch (_state) {
+    case SYNC1:
+      if (c == UBX_SYNC1) _state = SYNC2;
+      return false;
+
+    case SYNC2:
+      _state = c == UBX_SYNC2 ? CLASS : (c == UBX_SYNC1 ? SYNC2 : SYNC1);
+      return false;
+
+    case CLASS:
+      _cls = c;
+      _ckA = c;
+      _ckB = c;
+      _state = ID;
+      return false;
+
+    case ID:
+      _id = c;
+      _ckA += c; _ckB += _ckA;
+      _state = LEN1;
+      return false;
+
+    case LEN1:
+      _len = c;
+      _ckA += c; _ckB += _ckA;
+      _state = LEN2;
+      return false;
+
+    case LEN2:
+      _len |= (uint16_t)c << 8;
+      _ckA += c; _ckB += _ckA;
+      _pos = 0;
+      _state = _len ? PAYLOAD : CK_A;
+      return false;
+
+    case PAYLOAD:
+      if (_pos < kMaxPayload) _payload[_pos] = c;
+      _pos++;
+      _ckA += c; _ckB += _ckA;
+      if (_pos == _len) _state = CK_A;
+      return false;
+
+    case CK_A:
+      _rxCkA = c;
+      _state = CK_B;
+      return false;
+
+    case CK_B:
+      _state = SYNC1;
+      if (_rxCkA != _ckA || c != _ckB) {
+        _counters.checksumErrors++;
+        return false;
+      }
+      if (_len > kMaxPayload) {
+        _counters.oversize++;
+        return false;
+      }
+      _counters.frames++;
+      if (_handler) {
+        UbxFrame f = { _cls, _id, _len, _payload };
+        _handler(f, _ctx);
+      }
+      return true;
+  }
+  return false;
+}
+
+size_t UbxParser::feed(const uint8_t* data, size_t n) {
+  size_t frames = 0;
+  for (size_t i = 0; i < n; i++) frames += feed(data[i]);
+  return frames;
+}
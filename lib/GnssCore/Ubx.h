@@ -0,0 +1,157 @@
+/**
+ * u-blox UBX binary protocol framing
+ *
+ * Frame layout: 0xB5 0x62 <class> <id> <len lo> <len hi> <payload> <ck_a> <ck_b>
+ * The 8-bit Fletcher checksum covers class, id, length and payload.
+ *
+ * UbxParser is a byte-wise state machine that reassembles frames from a
+ * stream and calls a handler for every checksum-valid frame. Payloads larger
+ * than kMaxPayload are skipped (counted, not delivered).
+ *
+ * The ubxCfg*() builders produce the configuration frames used to switch a
+ * u-blox receiver from its default NMEA output to binary NAV-PVT only, and
+ * UbxNavPvt is the packed little-endian NAV-PVT payload: decoding is a
+ * length check and a memcpy, no ASCII number parsing.
+ */
+
+#ifndef UBX_H
+#define UBX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "GnssFix.h"
+
+#define UBX_SYNC1 0xB5
+#define UBX_SYNC2 0x62
+
+// classes / ids
+#define UBX_NAV      0x01
+#define UBX_NAV_PVT  0x07
+#define UBX_ACK      0x05
+#define UBX_ACK_NAK  0x00
+#define UBX_ACK_ACK  0x01
+#define UBX_CFG      0x06
+#define UBX_CFG_PRT  0x00
+#define UBX_CFG_MSG  0x01
+#define UBX_CFG_RATE 0x08
+#define UBX_CFG_CFG  0x09
+#define UBX_RXM      0x02
+#define UBX_RXM_PMREQ 0x41
+#define UBX_MON      0x0A
+#define UBX_MON_HW   0x09
+#define UBX_NMEA     0xF0   // standard NMEA messages, ids 0x00 (GGA) .. 0x05 (VTG)
+
+#define UBX_PROTO_UBX  0x0001
+#define UBX_PROTO_NMEA 0x0002
+
+// header + checksum around the payload
+#define UBX_FRAME_OVERHEAD 8
+
+// UART bytes per navigation epoch, used to size the baud rate
+#define UBX_EPOCH_BYTES_NAV_PVT  100   // NAV-PVT only
+#define UBX_EPOCH_BYTES_NMEA     500   // default GGA/GLL/GSA/GSV/RMC/VTG set, ~12 SVs
+
+struct UbxFrame {
+  uint8_t cls;
+  uint8_t id;
+  uint16_t length;
+  const uint8_t* payload;
+};
+
+// Fletcher-8 over `len` bytes, continuing from ck_a/ck_b
+void ubxChecksum(const uint8_t* data, size_t len, uint8_t& ckA, uint8_t& ckB);
+
+// writes a complete frame to out (len + 8 bytes), returns its size
+size_t ubxBuild(uint8_t* out, uint8_t cls, uint8_t id, const uint8_t* payload, uint16_t len);
+
+// CFG-PRT for UART1: 8N1 at `baud` with the given in/out protocol masks (28 bytes)
+size_t ubxCfgPrt(uint8_t* out, uint32_t baud, uint16_t inProto, uint16_t outProto);
+// CFG-MSG: output `rate` per navigation epoch on the current port (11 bytes)
+size_t ubxCfgMsg(uint8_t* out, uint8_t cls, uint8_t id, uint8_t rate);
+// CFG-RATE: one measurement every `measRateMs`, aligned to GPS time (14 bytes)
+size_t ubxCfgRate(uint8_t* out, uint16_t measRateMs);
+// CFG-CFG: save the running configuration to battery-backed RAM only (21 bytes)
+size_t ubxCfgSaveBbr(uint8_t* out);
+// RXM-PMREQ: backup mode until UART RX activity (durationMs 0 = indefinitely) (24 bytes)
+size_t ubxRxmPmreqBackup(uint8_t* out, uint32_t durationMs);
+
+// UBX-NAV-PVT payload (u-blox 8 / M8 layout)
+struct __attribute__((packed)) UbxNavPvt {
+  uint32_t iTOW;       // GPS time of week, ms
+  uint16_t year;
+  uint8_t month, day, hour, min, sec;
+  uint8_t valid;       // bit0 validDate, bit1 validTime, bit2 fullyResolved
+  uint32_t tAcc;       // ns
+  int32_t nano;        // fraction of second, -1e9..1e9 ns
+  uint8_t fixType;     // 0 none, 1 DR, 2 2D, 3 3D, 4 GNSS+DR, 5 time only
+  uint8_t flags;       // bit0 gnssFixOK
+  uint8_t flags2;
+  uint8_t numSV;
+  int32_t lon;         // 1e-7 deg
+  int32_t lat;         // 1e-7 deg
+  int32_t height;      // mm
+  int32_t hMSL;        // mm
+  uint32_t hAcc;       // mm
+  uint32_t vAcc;       // mm
+  int32_t velN, velE, velD;   // mm/s
+  int32_t gSpeed;      // mm/s
+  int32_t headMot;     // 1e-5 deg
+  uint32_t sAcc;       // mm/s
+  uint32_t headAcc;    // 1e-5 deg
+  uint16_t pDOP;       // 0.01
+  uint8_t flags3;
+  uint8_t reserved1[5];
+  int32_t headVeh;
+  int16_t magDec;
+  uint16_t magAcc;
+};
+
+static_assert(sizeof(UbxNavPvt) == 92, "NAV-PVT payload is 92 bytes");
+
+// validates class/id/length and copies the payload
+bool ubxDecodeNavPvt(const UbxFrame& f, UbxNavPvt& out);
+
+// fills the date/time/position/quality fields of a snapshot (antenna is left untouched)
+void ubxNavPvtToFix(const UbxNavPvt& pvt, GnssFix& fix);
+
+// MON-HW antenna status (aStatus): 2 = OK, 3 = SHORT, 4 = OPEN
+bool ubxDecodeAntenna(const UbxFrame& f, GnssAntenna& out);
+
+class UbxParser {
+public:
+  typedef void (*Handler)(const UbxFrame& f, void* ctx);
+
+  static const uint16_t kMaxPayload = 256;
+
+  struct Counters {
+    uint32_t frames;
+    uint32_t checksumErrors;
+    uint32_t oversize;
+  };
+
+  void setHandler(Handler h, void* ctx = nullptr) { _handler = h; _ctx = ctx; }
+
+  // returns true when `b` completed a valid frame
+  bool feed(uint8_t b);
+  // returns the number of valid frames completed
+  size_t feed(const uint8_t* data, size_t n);
+
+  void reset() { _state = SYNC1; }
+
+  const Counters& counters() const { return _counters; }
+
+private:
+  enum State : uint8_t { SYNC1, SYNC2, CLASS, ID, LEN1, LEN2, PAYLOAD, CK_A, CK_B };
+
+  State _state = SYNC1;
+  uint8_t _cls = 0, _id = 0;
+  uint16_t _len = 0, _pos = 0;
+  uint8_t _ckA = 0, _ckB = 0, _rxCkA = 0;
+  uint8_t _payload[kMaxPayload];
+
+  Handler _handler = nullptr;
+  void* _ctx = nullptr;
+  Counters _counters = {};
+};
+
+#endif // UBX_H
@@ -0,0 +1,184 @@
+#include "UplinkScheduler.h"
+#include "LocalFrame.h"
+#include "TrackCodec.h"
+
+UplinkScheduler::UplinkScheduler() : UplinkScheduler(Config()) {}
+
+UplinkScheduler::UplinkScheduler(const Config& config) : _cfg(config) {
+  if (_cfg.minSf < kMinSf) _cfg.minSf = kMinSf;
+  if (_cfg.maxSf > kMaxSf) _cfg.maxSf = kMaxSf;
+  if (_cfg.maxSf < _cfg.minSf) _cfg.maxSf = _cfg.minSf;
+}
+
+bool UplinkScheduler::addChannel(uint32_t frequencyHz) {
+  if (_channelCount == kMaxChannels || Eu868Budget::subband(frequencyHz, _cfg.bandwidthHz) < 0) return false;
+  _channels[_channelCount++] = frequencyHz;
+  return true;
+}
+
+AirtimeBucket& UplinkScheduler::bucketOf(uint32_t frequencyHz) {
+  return _budget.bucket((uint8_t)Eu868Budget::subband(frequencyHz, _cfg.bandwidthHz));
+}
+
+uint32_t UplinkScheduler::airtimeUs(uint8_t sf, size_t length) const {
+  LoraModulation m = { sf, _cfg.bandwidthHz, _cfg.codingRate, _cfg.preamble };
+  return loraTimeOnAirUs(m, length);
+}
+
+// the channel whose sub-band holds the most airtime
+int8_t UplinkScheduler::bestChannel(uint32_t nowMs, uint32_t& availableUs) {
+  int8_t best = -1;
+  availableUs = 0;
+  for (uint8_t i = 0; i < _channelCount; i++) {
+    uint32_t a = bucketOf(_channels[i]).availableUs(nowMs);
+    if (best < 0 || a > availableUs) {
+      best = (int8_t)i;
+      availableUs = a;
+    }
+  }
+  return best;
+}
+
+size_t UplinkScheduler::frameLimit(uint8_t sf, size_t cap) const {
+  size_t limit = loraMaxPayloadEu868(sf);
+  return cap < limit ? cap : limit;
+}
+
+bool UplinkScheduler::offer(const FixRecord& fix, int32_t northMms, int32_t eastMms) {
+  if (!fixIsComplete(fix)) return false;
+  _counters.fixes++;
+  uint32_t t = fixUnixSeconds(fix);
+  if (fixHasDate(_last) && t <= _lastFixS) {   // repeat of an epoch already seen
+    _counters.merged++;
+    return false;
+  }
+  _lastFixS = t;
+
+  int64_t speed2 = (int64_t)northMms * northMms + (int64_t)eastMms * eastMms;
+  bool moving = speed2 >= (int64_t)_cfg.parkedMms * _cfg.parkedMms;
+  bool keep = !fixHasDate(_last);
+  if (!keep) {
+    uint32_t dt = t - fixUnixSeconds(_last);
+    keep = dt >= (moving ? _cfg.maxGapS : _cfg.heartbeatS);
+
+    // deviation from the last point's straight line (velocity 0 if it was
+    // parked); beyond ~200 km the frame is imprecise, but keeps anyway
+    LocalFrame frame;
+    frame.setOrigin(_last.lat, _last.lon);
+    int32_t e, n;
+    frame.toLocal(fix.lat, fix.lon, e, n);
+    int64_t de = e - (int64_t)_lastEastMms * dt;
+    int64_t dn = n - (int64_t)_lastNorthMms * dt;
+    int64_t tol = (int64_t)_cfg.toleranceMm * _pressure;
+    if (de < -INT32_MAX || de > INT32_MAX || dn < -INT32_MAX || dn > INT32_MAX) keep = true;
+    else if (de * de + dn * dn > tol * tol) keep = true;
+  }
+  if (!keep) {
+    _counters.merged++;
+    return false;
+  }
+
+  _last = fix;
+  _lastNorthMms = moving ? northMms : 0;
+  _lastEastMms = moving ? eastMms : 0;
+  _counters.kept++;
+  return true;
+}
+
+bool UplinkScheduler::plan(uint32_t nowMs, const FixRecord* pending, size_t n, uint8_t* out,
+                           size_t cap, Plan& p) {
+  if (!_channelCount) return false;
+  uint32_t available;
+  int8_t ch = bestChannel(nowMs, available);
+  uint32_t half = bucketOf(_channels[ch]).capacityUs() / 2;
+  uint32_t quarter = half / 2;
+  _pressure = available >= half ? 1 : available >= quarter ? 2 : available >= quarter / 2 ? 4 : 8;
+  if (!n) return false;
+
+  uint32_t oldest = fixUnixSeconds(pending[0]);
+  bool due = _expedite || (_lastFixS > oldest && _lastFixS - oldest >= _cfg.maxLatencyS);
+
+  // batch at the cheapest SF: how full a frame the queue makes
+  size_t points = 0;
+  size_t length = trackEncode(pending, n, _cfg.quantum, out, frameLimit(_cfg.minSf, cap), points);
+  if (!length) return false;
+  bool full = points < n || points == TRACK_MAX_BATCH;
+  if (!due && !full) return false;
+  if (airtimeUs(_cfg.minSf, length) > available) {
+    if (due) _counters.budgetWaits++;
+    return false;
+  }
+
+  // the SF with the least airtime per point, or with rangeFromSurplus the
+  // highest one that leaves 3/4 of the bucket; else minSf
+  uint8_t sf = _cfg.minSf, encoded = sf;
+  uint32_t airtime = airtimeUs(sf, length);
+  for (uint8_t s = _cfg.minSf + 1; s <= _cfg.maxSf; s++) {
+    size_t k = 0;
+    size_t len = trackEncode(pending, n, _cfg.quantum, out, frameLimit(s, cap), k);
+    encoded = s;
+    uint32_t a = len ? airtimeUs(s, len) : UINT32_MAX;
+    if (a > available) continue;
+    bool better = _cfg.rangeFromSurplus ? available - a >= half + quarter
+                                        : (uint64_t)a * points < (uint64_t)airtime * k;
+    if (better) {
+      sf = s;
+      airtime = a;
+      length = len;
+      points = k;
+    }
+  }
+  if (encoded != sf) length = trackEncode(pending, n, _cfg.quantum, out, frameLimit(sf, cap), points);
+
+  p.frequencyHz = _channels[ch];
+  p.sf = sf;
+  p.length = length;
+  p.points = points;
+  p.airtimeUs = airtime;
+  return true;
+}
+
+void UplinkScheduler::sent(uint32_t nowMs, const Plan& p, uint32_t airtimeUs) {
+  if (airtimeUs < p.airtimeUs) airtimeUs = p.airtimeUs;
+  bucketOf(p.frequencyHz).sent(nowMs, airtimeUs);
+  _expedite = false;
+  _counters.frames++;
+  _counters.pointsSent += (uint32_t)p.points;
+  _counters.bytesSent += (uint32_t)p.length;
+  _counters.airtimeUs += airtimeUs;
+  if (p.sf >= kMinSf && p.sf <= kMaxSf) _counters.framesBySf[p.sf - kMinSf]++;
+}
+
+void UplinkScheduler::timedOut(uint32_t nowMs, const Plan& p) {
+  bucketOf(p.frequencyHz).sent(nowMs, p.airtimeUs);
+  _counters.timeouts++;
+  _counters.airtimeUs += p.airtimeUs;
+}
+
+uint32_t UplinkScheduler::waitMs(uint32_t nowMs) {
+  uint32_t frame = airtimeUs(_cfg.minSf, loraMaxPayloadEu868(_cfg.minSf));
+  uint32_t wait = UINT32_MAX;
+  for (uint8_t i = 0; i < _channelCount; i++) {
+    uint32_t w = bucketOf(_channels[i]).waitMs(nowMs, frame);
+    if (w < wait) wait = w;
+  }
+  return wait;
+}
+
+void UplinkScheduler::save(State& out) const {
+  out.last = _last;
+  out.lastNorthMms = _lastNorthMms;
+  out.lastEastMms = _lastEastMms;
+  out.lastFixS = _lastFixS;
+  _budget.save(out.budget);
+  out.counters = _counters;
+}
+
+void UplinkScheduler::restore(const State& in) {
+  _last = in.last;
+  _lastNorthMms = in.lastNorthMms;
+  _lastEastMms = in.lastEastMms;
+  _lastFixS = in.lastFixS;
+  _budget.restore(in.budget);
+  _counters = in.counters;
+}
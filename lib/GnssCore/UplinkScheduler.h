@@ -0,0 +1,169 @@
+/**
+ * Adaptive LoRa uplink scheduling: which fixes, how many per frame, which SF
+ *
+ * A fixed "one point every N s" wastes airtime while parked and samples a
+ * moving vehicle too coarsely. UplinkScheduler decides three things from
+ * the receiver's motion and the EU868 airtime budget:
+ *
+ * Which fixes (offer): the server draws straight lines between the points
+ * it receives. A fix is only queued when the line from the last queued
+ * point, extrapolated with that point's velocity (PositionFilter), misses
+ * it by more than Config::toleranceMm - at a constant speed and heading
+ * almost nothing is sent, every corner is. Parked (slower than
+ * Config::parkedMms) one point per Config::heartbeatS shows the tracker
+ * is alive; moving, Config::maxGapS bounds the time between points. The
+ * other fixes are counted as merged.
+ *
+ * When and how many (plan): points wait until they fill a frame at
+ * Config::minSf (preamble and header cost as much as ~10 points), or
+ * until the oldest is Config::maxLatencyS old. A frame takes as many
+ * queued points as fit the EU868 payload limit of its SF.
+ *
+ * Which SF and channel: from Config::minSf (the lowest SF that still
+ * reaches the gateway) to Config::maxSf, the one with the least airtime
+ * per point the chosen channel's sub-band bucket (Eu868Budget) can pay
+ * for; as the payload limit shrinks with the SF, that is almost always
+ * minSf. With Config::rangeFromSurplus a bucket that stays at least 3/4
+ * full after the frame buys range instead: the highest SF that keeps it
+ * there. As the bucket runs low the tolerance scales up (x2 below 1/2, x4
+ * below 1/4, x8 below 1/8), so fewer points carry the track at lower
+ * resolution instead of the queue overflowing. Of several channels the
+ * one whose bucket holds the most airtime is used.
+ *
+ * A receiver for more than one SF needs a gateway-class demodulator
+ * (SX1302/SX1303); with a single SX126x on the other end set minSf ==
+ * maxSf.
+ *
+ * Clock: nowMs is any millisecond clock that keeps running through deep
+ * sleep (the tracker's); fix times come from the records.
+ *
+ * Usage:
+ *   static UplinkScheduler uplink;
+ *   uplink.addChannel(868100000);
+ *   if (uplink.offer(record, velN, velE)) queue.push(record);
+ *   UplinkScheduler::Plan plan;
+ *   if (uplink.plan(nowMs, points, n, frame, sizeof(frame), plan)) {
+ *     radio.setChannel(plan.frequencyHz, plan.sf); radio.send(frame, plan.length);
+ *   }
+ *   ... TX done: uplink.sent(nowMs, plan, airtimeUs); queue.drop(plan.points);
+ */
+
+#ifndef UPLINK_SCHEDULER_H
+#define UPLINK_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FixRecord.h"
+#include "LoraAirtime.h"
+
+class UplinkScheduler {
+public:
+  static const uint8_t kMaxChannels = 8;
+  static const uint8_t kMinSf = 7;
+  static const uint8_t kMaxSf = 12;
+
+  struct Config {
+    uint8_t minSf = 7;               // lowest SF that reaches the gateway
+    uint8_t maxSf = 12;
+    bool rangeFromSurplus = false;   // a bucket over 3/4 full buys the highest SF
+    uint32_t bandwidthHz = 125000;
+    uint8_t codingRate = 1;          // 1..4 = 4/5..4/8
+    uint16_t preamble = 8;
+    uint8_t quantum = 2;             // TrackCodec resolution, 1e-5 deg
+    uint32_t toleranceMm = 10000;    // allowed deviation from the straight line
+    uint16_t parkedMms = 500;        // slower = parked
+    uint16_t heartbeatS = 900;       // parked: one point this often
+    uint16_t maxGapS = 60;           // moving: at least one point this often
+    uint16_t maxLatencyS = 120;      // the oldest queued point leaves within this
+  };
+
+  struct Counters {
+    uint32_t fixes;           // offered
+    uint32_t kept;            // returned true by offer()
+    uint32_t merged;          // on the line of the kept ones, not queued
+    uint32_t dropped;         // lost by the caller's queue (noteDropped)
+    uint32_t frames;          // sent()
+    uint32_t timeouts;        // timedOut()
+    uint32_t pointsSent;
+    uint32_t bytesSent;
+    uint32_t budgetWaits;     // plan() held a due frame for airtime
+    uint64_t airtimeUs;       // all frames, timed-out ones included
+    uint32_t framesBySf[kMaxSf - kMinSf + 1];
+  };
+
+  struct Plan {
+    uint32_t frequencyHz;
+    uint8_t sf;
+    size_t length;            // frame bytes written to the caller's buffer
+    size_t points;            // queued points it carries
+    uint32_t airtimeUs;       // computed time on air
+  };
+
+  // everything that has to survive deep sleep (RTC memory)
+  struct State {
+    FixRecord last;           // last kept point, no date = none
+    int32_t lastNorthMms, lastEastMms;
+    uint32_t lastFixS;        // newest offered fix, Unix seconds
+    Eu868Budget::State budget;
+    Counters counters;
+  };
+
+  UplinkScheduler();
+  explicit UplinkScheduler(const Config& config);
+
+  // false if the channel lies outside the EU868 sub-bands or the table is full
+  bool addChannel(uint32_t frequencyHz);
+  uint8_t channelCount() const { return _channelCount; }
+
+  // one fix with the receiver's velocity; true = queue it for uplink
+  bool offer(const FixRecord& fix, int32_t northMms, int32_t eastMms);
+
+  // for queued points pending[0..n) oldest first: true and a frame in out
+  // if one should go now
+  bool plan(uint32_t nowMs, const FixRecord* pending, size_t n, uint8_t* out, size_t cap, Plan& p);
+
+  // the queued points go with the next frame the budget allows, full or
+  // not (an alarm, a geofence transition)
+  void expedite() { _expedite = true; }
+
+  // a TX done (airtimeUs as measured, at least plan.airtimeUs is charged)
+  void sent(uint32_t nowMs, const Plan& p, uint32_t airtimeUs);
+  // a TX timeout: airtime charged, points stay queued
+  void timedOut(uint32_t nowMs, const Plan& p);
+  // the caller's queue discarded points
+  void noteDropped(uint32_t points) { _counters.dropped += points; }
+
+  // upper bound for the next plan() that can send (the best channel's
+  // bucket holding a full minSf frame), for sleeping until then
+  uint32_t waitMs(uint32_t nowMs);
+
+  // tolerance multiplier from the budget as of the last plan(): 1, 2, 4 or 8
+  uint8_t pressure() const { return _pressure; }
+
+  const Counters& counters() const { return _counters; }
+  void resetCounters() { _counters = Counters(); }
+  Eu868Budget& budget() { return _budget; }
+
+  void save(State& out) const;
+  void restore(const State& in);
+
+private:
+  uint32_t airtimeUs(uint8_t sf, size_t length) const;
+  size_t frameLimit(uint8_t sf, size_t cap) const;
+  int8_t bestChannel(uint32_t nowMs, uint32_t& availableUs);
+  AirtimeBucket& bucketOf(uint32_t frequencyHz);
+
+  Config _cfg;
+  Eu868Budget _budget;
+  uint32_t _channels[kMaxChannels] = {};
+  uint8_t _channelCount = 0;
+
+  FixRecord _last = {};
+  int32_t _lastNorthMms = 0, _lastEastMms = 0;
+  uint32_t _lastFixS = 0;
+  uint8_t _pressure = 1;
+  bool _expedite = false;
+  Counters _counters = {};
+};
+
+#endif // UPLINK_SCHEDULER_H
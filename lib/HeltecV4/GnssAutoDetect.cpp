@@ -0,0 +1,211 @@
+#include "GnssAutoDetect.h"
+#include <Preferences.h>
+#include <hal/uart_ll.h>
+#include "ByteRing.h"
+#include "NmeaFramer.h"
+#include "Ubx.h"
+
+static const uint32_t kStandardBauds[] = {
+  4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+};
+
+static const uint8_t kConfigVersion = 1;
+
+// nearest standard rate within +-8 %, else 0
+static uint32_t snapBaud(uint32_t measured) {
+  for (uint32_t b : kStandardBauds) {
+    uint32_t tol = b / 12;
+    if (measured + tol >= b && measured <= b + tol) return b;
+  }
+  return 0;
+}
+
+bool GnssAutoDetect::loadSaved(GnssPortConfig& cfg) {
+  Preferences prefs;
+  if (!prefs.begin("gnss", true)) return false;
+  bool ok = prefs.getUChar("ver", 0) == kConfigVersion &&
+            prefs.getBytes("port", &cfg, sizeof(cfg)) == sizeof(cfg);
+  prefs.end();
+  return ok && cfg.baud != 0;
+}
+
+bool GnssAutoDetect::save(const GnssPortConfig& cfg) {
+  Preferences prefs;
+  if (!prefs.begin("gnss", false)) return false;
+  bool ok = prefs.putBytes("port", &cfg, sizeof(cfg)) == sizeof(cfg) &&
+            prefs.putUChar("ver", kConfigVersion) == 1;
+  prefs.end();
+  return ok;
+}
+
+void GnssAutoDetect::forget() {
+  Preferences prefs;
+  if (!prefs.begin("gnss", false)) return;
+  prefs.clear();
+  prefs.end();
+}
+
+bool GnssAutoDetect::ensureDriver(uint32_t baud) {
+  if (_installed) return uart_set_baudrate(_port, baud) == ESP_OK;
+
+  uart_config_t uc = {};
+  uc.baud_rate = (int)baud;
+  uc.data_bits = UART_DATA_8_BITS;
+  uc.parity = UART_PARITY_DISABLE;
+  uc.stop_bits = UART_STOP_BITS_1;
+  uc.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  uc.source_clk = UART_SCLK_DEFAULT;
+
+  if (uart_driver_install(_port, 1024, 0, 0, nullptr, 0) != ESP_OK) return false;
+  if (uart_param_config(_port, &uc) != ESP_OK) {
+    uart_driver_delete(_port);
+    return false;
+  }
+  _installed = true;
+  return true;
+}
+
+void GnssAutoDetect::end() {
+  if (!_installed) return;
+  uart_driver_delete(_port);
+  _installed = false;
+}
+
+void GnssAutoDetect::applyPower(bool power, bool wake) {
+  pinMode(_ctrl, OUTPUT);
+  digitalWrite(_ctrl, power ? HIGH : LOW);
+  pinMode(_wake, OUTPUT);
+  digitalWrite(_wake, wake ? HIGH : LOW);
+}
+
+void GnssAutoDetect::pulseReset() {
+  pinMode(_rst, OUTPUT);
+  digitalWrite(_rst, LOW);
+  delay(50);
+  digitalWrite(_rst, HIGH);
+}
+
+uint32_t GnssAutoDetect::measureBaud(int rxPin, int txPin, uint32_t timeoutMs, uint16_t edges,
+                                     uint32_t* rawBaud) {
+  if (rawBaud) *rawBaud = 0;
+  if (!ensureDriver(9600)) return 0;
+  uart_set_pin(_port, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+
+  // toggling the enable bit clears the edge and pulse counters
+  uart_dev_t* hw = UART_LL_GET_HW(_port);
+  uart_ll_set_autobaud_en(hw, false);
+  uart_ll_set_autobaud_en(hw, true);
+
+  uint32_t start = millis();
+  while (uart_ll_get_rxd_edge_cnt(hw) < edges) {
+    if (millis() - start >= timeoutMs) {
+      uart_ll_set_autobaud_en(hw, false);
+      return 0;
+    }
+    delay(1);
+  }
+
+  // shortest low/high pulse = one bit time, counted in UART source clock cycles
+  uint32_t low = uart_ll_get_low_pulse_cnt(hw);
+  uint32_t high = uart_ll_get_high_pulse_cnt(hw);
+  uart_ll_set_autobaud_en(hw, false);
+  uart_flush_input(_port);
+
+  uint32_t sclk = 0;
+  if (uart_get_sclk_freq(UART_SCLK_DEFAULT, &sclk) != ESP_OK || sclk == 0) return 0;
+  uint32_t pulse = (low + high + 1) / 2;
+  if (pulse == 0) return 0;
+
+  uint32_t measured = sclk / pulse;
+  if (rawBaud) *rawBaud = measured;
+  return snapBaud(measured);
+}
+
+// used by waitForFrame() to stop at the first valid frame
+static void markNmea(const NmeaSentence&, void* ctx) { *(uint8_t*)ctx |= GNSS_PROTO_NMEA; }
+static void markUbx(const UbxFrame&, void* ctx) { *(uint8_t*)ctx |= GNSS_PROTO_UBX; }
+
+uint8_t GnssAutoDetect::waitForFrame(uint32_t timeoutMs) {
+  if (!_installed) return 0;
+
+  StaticByteRing<512> ring;
+  NmeaFramer framer;
+  UbxParser ubx;
+  uint8_t seen = 0;
+  framer.setFrameSink(markNmea, &seen);
+  ubx.setHandler(markUbx, &seen);
+
+  uint8_t buf[128];
+  uint32_t start = millis();
+  uart_flush_input(_port);
+
+  while (!seen && millis() - start < timeoutMs) {
+    int n = uart_read_bytes(_port, buf, sizeof(buf), pdMS_TO_TICKS(10));
+    if (n <= 0) continue;
+    ubx.feed(buf, (size_t)n);
+    ring.write(buf, (size_t)n);
+    framer.poll(ring);
+    if (ring.space() == 0) ring.clear();
+  }
+  return seen;
+}
+
+bool GnssAutoDetect::verify(GnssPortConfig& cfg, uint32_t timeoutMs) {
+  applyPower(cfg.powerLevel, cfg.wakeLevel);
+  if (!ensureDriver(cfg.baud)) return false;
+  uart_set_pin(_port, cfg.txPin, cfg.rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+
+  uint8_t proto = waitForFrame(timeoutMs);
+  if (proto) cfg.protocols = proto;
+  return proto != 0;
+}
+
+bool GnssAutoDetect::tryPins(GnssPortConfig& cfg, const PinPair& p, uint32_t activityMs,
+                             const Options& opt) {
+  uint32_t raw = 0;
+  uint32_t baud = measureBaud(p.rx, p.tx, activityMs, opt.edgesNeeded, &raw);
+  if (!raw) return false;   // line silent on this pin
+
+  cfg.rxPin = p.rx;
+  cfg.txPin = p.tx;
+
+  // measured rate first, then the standard rates if the measurement did not snap
+  if (baud) {
+    cfg.baud = baud;
+    uart_set_baudrate(_port, baud);
+    if ((cfg.protocols = waitForFrame(opt.confirmTimeoutMs)) != 0) return true;
+  }
+  for (uint32_t b : kStandardBauds) {
+    if (b == baud) continue;
+    uart_set_baudrate(_port, b);
+    cfg.baud = b;
+    if ((cfg.protocols = waitForFrame(opt.confirmTimeoutMs)) != 0) return true;
+  }
+  return false;
+}
+
+bool GnssAutoDetect::detect(GnssPortConfig& out, const Options& opt) {
+  // documented V4 wiring first (power active LOW, wake active HIGH)
+  static const bool kPower[] = { false, true };
+  static const bool kWake[] = { true, false };
+
+  for (bool power : kPower) {
+    for (bool wake : kWake) {
+      applyPower(power, wake);
+      pulseReset();
+
+      for (uint8_t i = 0; i < opt.pinCount; i++) {
+        GnssPortConfig cfg = {};
+        cfg.powerLevel = power;
+        cfg.wakeLevel = wake;
+        uint32_t activity = i == 0 ? opt.bootTimeoutMs : opt.activityTimeoutMs;
+        if (tryPins(cfg, opt.pins[i], activity, opt)) {
+          out = cfg;
+          save(out);
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
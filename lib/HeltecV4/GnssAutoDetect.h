@@ -0,0 +1,103 @@
+/**
+ * GNSS port / baud auto-detection with NVS persistence
+ *
+ * Finds the power/wake levels, RX/TX pin variant and baud rate of the GNSS
+ * module without a fixed-time brute-force sweep:
+ *
+ * - Baud rate: the ESP32-S3 UART autobaud unit measures the shortest low and
+ *   high pulses on the RX line in hardware; the result is snapped to the
+ *   nearest standard rate. A silent line ends the attempt after
+ *   activityTimeoutMs (NMEA arrives at least once per second).
+ * - Confirmation: the UART is opened at the measured rate and the attempt
+ *   stops at the first checksum-valid NMEA sentence or UBX frame.
+ * - Persistence: the winning configuration is stored in NVS (Preferences,
+ *   namespace "gnss"), so production boots call loadSaved() and skip
+ *   detection entirely; verify() re-checks a saved config in one frame time.
+ *
+ * The detector installs the ESP-IDF UART driver on `port`; call end() before
+ * using Serial1 (or GnssUart) on the same port.
+ */
+
+#ifndef GNSS_AUTO_DETECT_H
+#define GNSS_AUTO_DETECT_H
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include "HeltecV4Board.h"
+
+struct GnssPortConfig {
+  uint8_t rxPin;
+  uint8_t txPin;
+  uint32_t baud;
+  bool powerLevel;     // VGNSS_CTRL level that powers the module
+  bool wakeLevel;      // GNSS_WAKE level that keeps it awake
+  uint8_t protocols;   // GNSS_PROTO_* seen during confirmation
+};
+
+#define GNSS_PROTO_NMEA 0x01
+#define GNSS_PROTO_UBX  0x02
+
+class GnssAutoDetect {
+public:
+  struct PinPair {
+    uint8_t rx;
+    uint8_t tx;
+  };
+
+  struct Options {
+    const PinPair* pins = nullptr;
+    uint8_t pinCount = 0;
+    uint32_t bootTimeoutMs = 2000;       // first attempt after a reset pulse
+    uint32_t activityTimeoutMs = 1200;   // silent line -> next candidate
+    uint32_t confirmTimeoutMs = 1200;    // no valid frame -> next candidate
+    uint16_t edgesNeeded = 64;           // RX edges before the pulse counters are read
+  };
+
+  GnssAutoDetect(int ctrlPin, int wakePin, int rstPin, uart_port_t port = UART_NUM_1)
+    : _ctrl(ctrlPin), _wake(wakePin), _rst(rstPin), _port(port) {}
+
+  // control pins from a board trait: GnssAutoDetect::forBoard<HeltecV4::Gnss>()
+  template <class G>
+  static GnssAutoDetect forBoard(uart_port_t port = UART_NUM_1) {
+    static_assert(boardPinsValid(G::rx, G::tx, G::ctrl, G::wake, G::rst), "GNSS pin set");
+    return GnssAutoDetect(G::ctrl, G::wake, G::rst, port);
+  }
+  template <class G>
+  static PinPair pinsOf() { return { G::rx, G::tx }; }
+  // the trait's pins at its factory baud, NMEA, powered and awake
+  template <class G>
+  static GnssPortConfig defaultPort() {
+    return { G::rx, G::tx, G::baud, !G::ctrlActiveLow, true, GNSS_PROTO_NMEA };
+  }
+
+  static bool loadSaved(GnssPortConfig& cfg);
+  static bool save(const GnssPortConfig& cfg);
+  static void forget();
+
+  // powers the module as described by cfg and waits for one valid frame
+  bool verify(GnssPortConfig& cfg, uint32_t timeoutMs);
+
+  // searches all candidates, stores the result in NVS on success
+  bool detect(GnssPortConfig& out, const Options& opt);
+
+  // measured baud on rxPin snapped to a standard rate, 0 if silent or unknown
+  uint32_t measureBaud(int rxPin, int txPin, uint32_t timeoutMs, uint16_t edges, uint32_t* rawBaud = nullptr);
+
+  // reads at the current pins/baud until a valid frame; returns GNSS_PROTO_* or 0
+  uint8_t waitForFrame(uint32_t timeoutMs);
+
+  // uninstalls the UART driver
+  void end();
+
+private:
+  bool ensureDriver(uint32_t baud);
+  void applyPower(bool power, bool wake);
+  void pulseReset();
+  bool tryPins(GnssPortConfig& cfg, const PinPair& p, uint32_t activityMs, const Options& opt);
+
+  int _ctrl, _wake, _rst;
+  uart_port_t _port;
+  bool _installed = false;
+};
+
+#endif // GNSS_AUTO_DETECT_H
@@ -0,0 +1,51 @@
+#include "GnssLatency.h"
+
+bool GnssLatency::begin(const PpsTimebase& pps, uint16_t periodMs) {
+  if (periodMs == 0) return false;
+  _pps = &pps;
+  _periodMs = periodMs;
+  _lastEpochMs = -1;
+  resetStats();
+  return true;
+}
+
+void GnssLatency::resetStats() {
+  _stats = {};
+  _stats.minUs = UINT32_MAX;
+}
+
+int32_t GnssLatency::fixAvailable(const GnssFix& fix) {
+  int64_t now = esp_timer_get_time();
+  if (!_pps || !fix.timeValid) return -1;
+
+  int32_t subMs = fix.centisecond * 10;
+  int32_t epochMs = ((fix.hour * 60 + fix.minute) * 60 + fix.second) * 1000 + subMs;
+
+  // gaps between consecutive fix times: epochs lost anywhere on the way in
+  if (_lastEpochMs >= 0) {
+    int32_t gap = epochMs - _lastEpochMs;
+    if (gap < 0) gap += 86400000;      // midnight
+    if (gap * 2 > _periodMs * 3) _stats.missed += (gap + _periodMs / 2) / _periodMs - 1;
+  }
+  _lastEpochMs = epochMs;
+
+  int64_t edge[2];
+  _pps->edges(edge[0], edge[1]);
+
+  // the epoch lies after its PPS edge; an epoch in the future means the
+  // next second's edge already arrived
+  int64_t pps = edge[0] + (int64_t)subMs * 1000 > now ? edge[1] : edge[0];
+
+  int64_t latency = now - (pps + (int64_t)subMs * 1000);
+  if (pps == 0 || latency < 0 || latency >= 1000000) {
+    _stats.noPps++;
+    return -1;
+  }
+
+  uint32_t us = (uint32_t)latency;
+  _stats.epochs++;
+  _stats.sumUs += us;
+  if (us < _stats.minUs) _stats.minUs = us;
+  if (us > _stats.maxUs) _stats.maxUs = us;
+  return (int32_t)us;
+}
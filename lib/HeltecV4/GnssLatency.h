@@ -0,0 +1,58 @@
+/**
+ * Per-epoch GNSS latency: PPS edge -> fix available to the application
+ *
+ * The receiver's PPS output rises at the top of every UTC second; PpsTimebase
+ * timestamps each rising edge with esp_timer_get_time(). When the
+ * application has a decoded fix it calls fixAvailable(), which places the
+ * fix's epoch on the same clock as
+ *
+ *   epoch = PPS edge of that second + sub-second part of the fix time
+ *
+ * and records now - epoch. At 5-10 Hz only every 5th/10th epoch coincides
+ * with a PPS edge, the others are offset by their centiseconds. If the fix
+ * for x.9 arrives after the PPS edge of x+1, the previous edge is used, so
+ * any latency below one second is attributed correctly.
+ *
+ * Missed epochs (a gap larger than 1.5 periods between consecutive fix
+ * times) are counted as well, which shows whether UART, parser and
+ * application keep up with the configured rate.
+ */
+
+#ifndef GNSS_LATENCY_H
+#define GNSS_LATENCY_H
+
+#include <Arduino.h>
+#include "GnssFix.h"
+#include "PpsTimebase.h"
+
+class GnssLatency {
+public:
+  struct Stats {
+    uint32_t epochs;      // fixes with a matching PPS edge
+    uint32_t noPps;       // fixes without one (no PPS wired, no fix yet, > 1 s late)
+    uint32_t missed;      // epochs that never reached fixAvailable()
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+
+    uint32_t avgUs() const { return epochs ? (uint32_t)(sumUs / epochs) : 0; }
+  };
+
+  // edges come from `pps`; periodMs is the configured epoch length
+  bool begin(const PpsTimebase& pps, uint16_t periodMs);
+
+  // call once per new epoch; returns the latency in us, or -1 without PPS
+  int32_t fixAvailable(const GnssFix& fix);
+
+  const Stats& stats() const { return _stats; }
+  void resetStats();
+
+private:
+  const PpsTimebase* _pps = nullptr;
+  uint16_t _periodMs = 1000;
+
+  int32_t _lastEpochMs = -1;   // ms of day of the previous fix
+  Stats _stats = {};
+};
+
+#endif // GNSS_LATENCY_H
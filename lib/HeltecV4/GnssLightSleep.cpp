@@ -0,0 +1,69 @@
+#include "GnssLightSleep.h"
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+uint16_t GnssLightSleep::Stats::permilleAsleep() const {
+  int64_t span = esp_timer_get_time() - sinceUs;
+  return span > 0 ? (uint16_t)(asleepUs * 1000 / (uint64_t)span) : 0;
+}
+
+bool GnssLightSleep::begin(const Config& cfg) {
+  _cfg = cfg;
+  _ready = uart_set_wakeup_threshold(cfg.port, cfg.uartWakeEdges) == ESP_OK &&
+           esp_sleep_enable_uart_wakeup(cfg.port) == ESP_OK;
+  if (_ready && cfg.ppsPin >= 0) _ready = esp_sleep_enable_gpio_wakeup() == ESP_OK;
+  resetStats();
+  return _ready;
+}
+
+void GnssLightSleep::resetStats() {
+  _stats = {};
+  _stats.sinceUs = esp_timer_get_time();
+}
+
+GnssLightSleep::Wake GnssLightSleep::sleep(uint32_t maxMs, PpsTimebase* pps) {
+  if (!_ready) return WAKE_NONE;
+
+  gpio_num_t pin = (gpio_num_t)_cfg.ppsPin;
+  bool ppsArmed = _cfg.ppsPin >= 0 && gpio_get_level(pin) == 0;
+  if (_cfg.ppsPin >= 0 && !ppsArmed && (maxMs == 0 || maxMs > _cfg.ppsPulseMs)) {
+    maxMs = _cfg.ppsPulseMs;   // pulse still high, nap until it ends
+  }
+
+  if (ppsArmed) {
+    // a level interrupt with the edge ISR attached would fire continuously
+    gpio_intr_disable(pin);
+    gpio_wakeup_enable(pin, GPIO_INTR_HIGH_LEVEL);
+  }
+  if (maxMs) esp_sleep_enable_timer_wakeup((uint64_t)maxMs * 1000);
+
+  int64_t start = esp_timer_get_time();
+  esp_light_sleep_start();
+  int64_t woke = esp_timer_get_time();
+
+  if (maxMs) esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  if (ppsArmed) {
+    gpio_wakeup_disable(pin);
+    gpio_set_intr_type(pin, GPIO_INTR_POSEDGE);
+    gpio_intr_enable(pin);
+  }
+
+  _stats.sleeps++;
+  _stats.asleepUs += (uint64_t)(woke - start);
+
+  switch (esp_sleep_get_wakeup_cause()) {
+    case ESP_SLEEP_WAKEUP_GPIO:
+      _stats.wakePps++;
+      if (pps) pps->edgeAt(woke);
+      return WAKE_PPS;
+    case ESP_SLEEP_WAKEUP_UART:
+      _stats.wakeUart++;
+      return WAKE_UART;
+    case ESP_SLEEP_WAKEUP_TIMER:
+      _stats.wakeTimer++;
+      return WAKE_TIMER;
+    default:
+      return WAKE_OTHER;
+  }
+}
@@ -0,0 +1,80 @@
+/**
+ * Light sleep between GNSS bursts
+ *
+ * At 1 Hz the receiver sends its sentences in one burst right after the PPS
+ * edge, and the CPU has nothing to do for the rest of the second. sleep()
+ * puts the whole chip into light sleep (both cores halt, RAM and
+ * peripherals are retained) until one of
+ *
+ * - PPS: GPIO high level on the PPS pin, i.e. the next epoch starts
+ * - UART: RX activity on the GNSS port (receivers without PPS, NMEA sent
+ *   outside the burst); the characters that wake the chip are lost, so the
+ *   first sentence after such a wake usually fails its checksum
+ * - timer: the caller's deadline (next UI refresh, next epoch at > 1 Hz)
+ *
+ * PPS edges during sleep never reach PpsTimebase's edge interrupt: the pin
+ * is switched to level wakeup for the sleep and back to a rising-edge
+ * interrupt afterwards. A PPS wake therefore feeds the wake-up time to the
+ * timebase as the edge (edgeAt()), late by the wake-up latency (~0.3 ms).
+ *
+ * While PPS is still high (the pulse lasts ~100 ms) a level wakeup would
+ * fire at once, so the pin is not armed then and the nap ends at the end
+ * of the pulse instead.
+ *
+ * The caller decides when: after the epoch's final sentence is parsed and
+ * everything that must reach the outside (OLED flush, Serial) is done.
+ *
+ * Usage:
+ *   GnssLightSleep::Config cfg;
+ *   cfg.ppsPin = GNSS_PPS;
+ *   lightSleep.begin(cfg);
+ *   ...
+ *   if (epochDone) lightSleep.sleep(msToNextRefresh, &gnssTime);
+ */
+
+#ifndef GNSS_LIGHT_SLEEP_H
+#define GNSS_LIGHT_SLEEP_H
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include "PpsTimebase.h"
+
+class GnssLightSleep {
+public:
+  enum Wake : uint8_t { WAKE_NONE, WAKE_PPS, WAKE_UART, WAKE_TIMER, WAKE_OTHER };
+
+  struct Config {
+    int ppsPin = -1;                // -1 = no PPS wakeup
+    uart_port_t port = UART_NUM_1;  // GNSS UART, wakes on RX
+    int uartWakeEdges = 3;          // RX edges that end the sleep (3 .. 1023)
+    uint16_t ppsPulseMs = 100;      // PPS high time of the receiver
+  };
+
+  struct Stats {
+    uint32_t sleeps;
+    uint32_t wakePps;
+    uint32_t wakeUart;
+    uint32_t wakeTimer;
+    uint64_t asleepUs;
+    int64_t sinceUs;     // esp_timer time of the last reset
+
+    // share of the time since the last reset spent in light sleep, 0.1 %
+    uint16_t permilleAsleep() const;
+  };
+
+  bool begin(const Config& cfg);
+
+  // light sleep for at most maxMs (0 = no timer wakeup); feeds a PPS wake
+  // to `pps` as an edge; returns what ended the sleep
+  Wake sleep(uint32_t maxMs, PpsTimebase* pps = nullptr);
+
+  const Stats& stats() const { return _stats; }
+  void resetStats();
+
+private:
+  Config _cfg;
+  bool _ready = false;
+  Stats _stats = {};
+};
+
+#endif // GNSS_LIGHT_SLEEP_H
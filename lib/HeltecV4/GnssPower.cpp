@@ -0,0 +1,92 @@
+#include "GnssPower.h"
+
+bool GnssPowerSequencer::start(int ctrlPin, int wakePin, int rstPin) {
+  return start(ctrlPin, wakePin, rstPin, Timing());
+}
+
+bool GnssPowerSequencer::start(int ctrlPin, int wakePin, int rstPin, const Timing& timing) {
+  _ctrl = ctrlPin;
+  _wake = wakePin;
+  _rst = rstPin;
+  _timing = timing;
+  _dataAtUs = 0;
+
+  if (!_timer) {
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "gnss_pwr";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) return false;
+  } else {
+    esp_timer_stop(_timer);
+  }
+
+  pinMode(_ctrl, OUTPUT);
+  digitalWrite(_ctrl, LOW);       // ON
+
+  pinMode(_wake, OUTPUT);
+  digitalWrite(_wake, HIGH);      // WAKE
+
+  pinMode(_rst, OUTPUT);
+  digitalWrite(_rst, HIGH);
+
+  _startUs = esp_timer_get_time();
+  _state = POWERING;
+  arm(_timing.settleMs);
+  return true;
+}
+
+void GnssPowerSequencer::dataSeen() {
+  State s = _state;
+  if (s == STREAMING || s == OFF) return;
+  // bytes during POWERING/IN_RESET are left over from before the reset
+  if (s != BOOTING && s != NO_DATA) return;
+
+  esp_timer_stop(_timer);
+  _dataAtUs = esp_timer_get_time();
+  _state = STREAMING;
+}
+
+void GnssPowerSequencer::powerOff() {
+  if (_timer) esp_timer_stop(_timer);
+  if (_ctrl >= 0) digitalWrite(_ctrl, HIGH);
+  _state = OFF;
+}
+
+void GnssPowerSequencer::arm(uint32_t ms) {
+  esp_timer_start_once(_timer, (uint64_t)ms * 1000);
+}
+
+void GnssPowerSequencer::onTimer(void* arg) {
+  static_cast<GnssPowerSequencer*>(arg)->step();
+}
+
+void GnssPowerSequencer::step() {
+  switch (_state) {
+    case POWERING:
+      if (_timing.resetMs == 0) {
+        _state = BOOTING;
+        arm(_timing.bootTimeoutMs);
+        break;
+      }
+      // Reset pulse
+      digitalWrite(_rst, LOW);
+      _state = IN_RESET;
+      arm(_timing.resetMs);
+      break;
+
+    case IN_RESET:
+      digitalWrite(_rst, HIGH);
+      _state = BOOTING;
+      arm(_timing.bootTimeoutMs);
+      break;
+
+    case BOOTING:
+      _state = NO_DATA;
+      break;
+
+    default:
+      break;
+  }
+}
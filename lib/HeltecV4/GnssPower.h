@@ -0,0 +1,84 @@
+/**
+ * Non-blocking GNSS power-up sequencer
+ *
+ * Runs the V4 GNSS bring-up (VGNSS_CTRL on -> WAKE high -> RST pulse ->
+ * wait for data) from esp_timer callbacks instead of delay(), so setup()
+ * can initialise the OLED and everything else while the module powers up.
+ *
+ * Sequence:
+ *   start()        VGNSS_CTRL LOW (on), GNSS_WAKE HIGH, GNSS_RST HIGH
+ *   + settleMs     GNSS_RST LOW
+ *   + resetMs      GNSS_RST HIGH, module boots
+ *   dataSeen()     first valid sentence -> STREAMING (ends the sequence early)
+ *   + bootTimeout  no data yet -> NO_DATA (dataSeen() still moves on to STREAMING)
+ *
+ * With Timing::resetMs = 0 the RST pulse is skipped and BOOTING starts
+ * right after settleMs. Use that when the module comes out of backup mode:
+ * a hardware reset would discard the ephemeris kept for a hot start.
+ *
+ * The pins come from a board trait (start<HeltecV4::Gnss>()) or are passed
+ * at runtime; the state machine only touches them at power/reset steps.
+ *
+ * Start the UART before or right after start() so the first bytes after
+ * reset are not lost, and call dataSeen() from the sentence handler.
+ */
+
+#ifndef GNSS_POWER_H
+#define GNSS_POWER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "HeltecV4Board.h"
+
+class GnssPowerSequencer {
+public:
+  enum State : uint8_t {
+    OFF,
+    POWERING,     // supply on, waiting settleMs
+    IN_RESET,     // RST held low
+    BOOTING,      // RST released, waiting for the first sentence
+    STREAMING,    // module is talking
+    NO_DATA       // boot timeout expired without a sentence
+  };
+
+  struct Timing {
+    uint16_t settleMs = 200;
+    uint16_t resetMs = 50;       // 0 = no reset pulse (keeps backup RAM for a hot start)
+    uint16_t bootTimeoutMs = 2000;
+  };
+
+  bool start(int ctrlPin, int wakePin, int rstPin);
+  bool start(int ctrlPin, int wakePin, int rstPin, const Timing& timing);
+  // pins from a board trait: start<HeltecV4::Gnss>()
+  template <class G>
+  bool start(const Timing& timing = Timing()) {
+    static_assert(boardPinsValid(G::ctrl, G::wake, G::rst), "GNSS control pins");
+    return start(G::ctrl, G::wake, G::rst, timing);
+  }
+
+  // call whenever a valid sentence arrives; cheap after the first call
+  void dataSeen();
+
+  // cuts VGNSS_CTRL and stops a running sequence
+  void powerOff();
+
+  State state() const { return _state; }
+  bool streaming() const { return _state == STREAMING; }
+
+  // ms from start() to the first sentence (0 until STREAMING)
+  uint32_t timeToDataMs() const { return _dataAtUs ? (uint32_t)((_dataAtUs - _startUs) / 1000) : 0; }
+
+private:
+  static void onTimer(void* arg);
+  void step();
+  void arm(uint32_t ms);
+
+  int _ctrl = -1, _wake = -1, _rst = -1;
+  Timing _timing;
+  esp_timer_handle_t _timer = nullptr;
+  volatile State _state = OFF;
+  int64_t _startUs = 0;
+  volatile int64_t _dataAtUs = 0;
+};
+
+#endif // GNSS_POWER_H
@@ -0,0 +1,131 @@
+#include "GnssUart.h"
+#include "PerfStats.h"
+
+PERF_TIMER(perfIngest, "ingest");   // one RX event drained into the ring
+
+bool GnssUart::begin(uart_port_t port, int rxPin, int txPin, uint32_t baud, ByteRing& ring) {
+  return begin(port, rxPin, txPin, baud, ring, Config());
+}
+
+bool GnssUart::begin(uart_port_t port, int rxPin, int txPin, uint32_t baud, ByteRing& ring,
+                     const Config& cfg) {
+  if (_running) end();
+
+  _port = port;
+  _ring = &ring;
+  _baud = baud;
+  _consumer = xTaskGetCurrentTaskHandle();
+  _counters = {};
+
+  uart_config_t uc = {};
+  uc.baud_rate = (int)baud;
+  uc.data_bits = UART_DATA_8_BITS;
+  uc.parity = UART_PARITY_DISABLE;
+  uc.stop_bits = UART_STOP_BITS_1;
+  uc.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  uc.source_clk = UART_SCLK_DEFAULT;
+
+  if (uart_driver_install(port, cfg.driverRxBuffer, 0, 16, &_events, 0) != ESP_OK) return false;
+  if (uart_param_config(port, &uc) != ESP_OK ||
+      uart_set_pin(port, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+    uart_driver_delete(port);
+    return false;
+  }
+
+  // hand over sentence-sized chunks: FIFO threshold or idle line, whichever first
+  uart_set_rx_full_threshold(port, cfg.rxThreshold);
+  uart_set_rx_timeout(port, cfg.idleSymbols);
+
+  _running = true;
+  if (xTaskCreatePinnedToCore(taskEntry, "gnss_rx", cfg.taskStack, this,
+                              cfg.taskPriority, &_task, cfg.taskCore) != pdPASS) {
+    _running = false;
+    uart_driver_delete(port);
+    return false;
+  }
+  return true;
+}
+
+void GnssUart::end() {
+  if (!_running) return;
+  _running = false;
+  vTaskDelete(_task);
+  _task = nullptr;
+  uart_driver_delete(_port);
+  _events = nullptr;
+}
+
+bool GnssUart::waitForData(uint32_t timeoutMs) {
+  // only new chunks wake us: a partial sentence left in the ring must not spin the loop
+  return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs)) > 0;
+}
+
+size_t GnssUart::write(const uint8_t* data, size_t len) {
+  int n = uart_write_bytes(_port, data, len);
+  return n < 0 ? 0 : (size_t)n;
+}
+
+bool GnssUart::flush(uint32_t timeoutMs) {
+  return uart_wait_tx_done(_port, pdMS_TO_TICKS(timeoutMs)) == ESP_OK;
+}
+
+bool GnssUart::setBaud(uint32_t baud) {
+  uart_wait_tx_done(_port, pdMS_TO_TICKS(100));
+  if (uart_set_baudrate(_port, baud) != ESP_OK) return false;
+  _baud = baud;
+  return true;
+}
+
+void GnssUart::taskEntry(void* arg) {
+  static_cast<GnssUart*>(arg)->run();
+}
+
+void GnssUart::run() {
+  uint8_t chunk[128];
+  uart_event_t ev;
+
+  for (;;) {
+    if (xQueueReceive(_events, &ev, portMAX_DELAY) != pdTRUE) continue;
+
+    switch (ev.type) {
+      case UART_DATA: {
+        PERF_BEGIN(perfIngest);
+        size_t pending = ev.size;
+        while (pending) {
+          int n = uart_read_bytes(_port, chunk, pending < sizeof(chunk) ? pending : sizeof(chunk), 0);
+          if (n <= 0) break;
+          size_t stored = _ring->write(chunk, (size_t)n);
+          _counters.bytes += stored;
+          _counters.ringDropped += (uint32_t)n - stored;
+          pending -= (size_t)n;
+        }
+        _counters.chunks++;
+        if (ev.timeout_flag) _counters.idleChunks++;
+        if (_consumer) xTaskNotifyGive(_consumer);
+        PERF_END(perfIngest);
+        break;
+      }
+
+      case UART_FIFO_OVF:
+        _counters.fifoOverflows++;
+        uart_flush_input(_port);
+        xQueueReset(_events);
+        break;
+
+      case UART_BUFFER_FULL:
+        _counters.driverFull++;
+        uart_flush_input(_port);
+        xQueueReset(_events);
+        break;
+
+      case UART_FRAME_ERR:
+      case UART_PARITY_ERR:
+      case UART_BREAK:
+        _counters.lineErrors++;
+        break;
+
+      default:
+        break;
+    }
+  }
+}
@@ -0,0 +1,90 @@
+/**
+ * Event-driven GNSS UART ingest for the ESP32-S3
+ *
+ * Replaces the Serial1.available()/Serial1.read() polling loop with the
+ * ESP-IDF UART driver's event queue. The RX FIFO raises an event when it
+ * reaches `rxThreshold` bytes or when the line has been idle for
+ * `idleSymbols` character times, so the driver hands over whole NMEA
+ * sentences (or the tail of a burst) instead of single bytes.
+ *
+ * A small FreeRTOS task drains each event into a ByteRing and notifies the
+ * consumer task, which can sleep in waitForData() until a chunk arrives.
+ *
+ * Usage:
+ *   static StaticByteRing<2048> gnssRing;
+ *   static GnssUart gnssUart;
+ *   gnssUart.begin(UART_NUM_1, GNSS_RX, GNSS_TX, 9600, gnssRing);
+ *   ...
+ *   gnssUart.waitForData(100);            // in loop()
+ *   while ((n = gnssRing.read(buf, sizeof(buf))) > 0) { ... }
+ *
+ * Do not call Serial1.begin() on the same port; the driver owns UART1.
+ * Requires the Arduino-ESP32 3.x core (ESP-IDF 5.x).
+ */
+
+#ifndef GNSS_UART_H
+#define GNSS_UART_H
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include "ByteRing.h"
+
+class GnssUart {
+public:
+  struct Config {
+    uint16_t rxThreshold = 100;    // FIFO bytes before an RX event (FIFO is 128)
+    uint8_t  idleSymbols = 4;      // idle character times before an RX event
+    int      driverRxBuffer = 1024;
+    uint32_t taskStack = 3072;
+    UBaseType_t taskPriority = 5;  // above loopTask (1)
+    BaseType_t taskCore = 0;
+  };
+
+  struct Counters {
+    uint32_t bytes;        // bytes handed to the ring
+    uint32_t chunks;       // RX events drained
+    uint32_t idleChunks;   // RX events closed by the idle-line timeout
+    uint32_t fifoOverflows;
+    uint32_t driverFull;   // driver ring buffer full
+    uint32_t ringDropped;  // bytes lost because the consumer ring was full
+    uint32_t lineErrors;   // frame / parity / break
+  };
+
+  bool begin(uart_port_t port, int rxPin, int txPin, uint32_t baud, ByteRing& ring);
+  bool begin(uart_port_t port, int rxPin, int txPin, uint32_t baud, ByteRing& ring,
+             const Config& cfg);
+  void end();
+
+  // blocks the calling task until a new chunk arrived since the last call or
+  // timeoutMs elapsed; returns true if a chunk arrived
+  bool waitForData(uint32_t timeoutMs);
+
+  // routes the data notification to another task (default: the task that called begin)
+  void setConsumer(TaskHandle_t task) { _consumer = task; }
+
+  size_t write(const uint8_t* data, size_t len);
+  bool setBaud(uint32_t baud);
+  uint32_t baud() const { return _baud; }
+  // waits until everything written has left the TX FIFO
+  bool flush(uint32_t timeoutMs = 100);
+
+  uart_port_t port() const { return _port; }
+  // the ring passed to begin() (nullptr before)
+  ByteRing* ring() const { return _ring; }
+  const Counters& counters() const { return _counters; }
+
+private:
+  static void taskEntry(void* arg);
+  void run();
+
+  uart_port_t _port = UART_NUM_1;
+  ByteRing* _ring = nullptr;
+  uint32_t _baud = 0;
+  QueueHandle_t _events = nullptr;
+  TaskHandle_t _task = nullptr;
+  TaskHandle_t _consumer = nullptr;
+  volatile bool _running = false;
+  Counters _counters = {};
+};
+
+#endif // GNSS_UART_H
@@ -0,0 +1,186 @@
+/**
+ * Compile-time pin map of the Heltec WiFi LoRa 32 V4
+ *
+ * One constexpr trait per peripheral, so drivers and sketches take their
+ * pins as template parameters instead of #defines or pins_arduino.h
+ * globals:
+ *
+ *   HeltecV4::Gnss     UART, VGNSS_CTRL, WAKE, RST, PPS of the L76K/u-blox
+ *   HeltecV4::Oled     SSD1306 I2C bus, reset and address
+ *   HeltecV4::Lora     SX1262 SPI bus, RST, BUSY, DIO1
+ *   HeltecV4::vext     switched 3.3 V rail for the OLED and the GNSS antenna
+ *
+ * Every pin set is checked when this header compiles: each pin must exist
+ * on the ESP32-S3 (GPIO 0-21, 26-48), stay off the octal flash/PSRAM bus
+ * (GPIO 26-32) and no two pins of the board may collide. Where the core's
+ * pins_arduino.h is available its V4 constants are cross-checked too, so a
+ * mistyped pin is a build error instead of a silent Debug_GNSS failure.
+ *
+ * FastPin<Pin> writes the GPIO output registers directly: high() and low()
+ * compile to a single store to GPIO.out_w1ts / out_w1tc (out1_* for 32-48)
+ * with the mask folded at compile time, no pin table lookup, no call. Use
+ * it where a pin toggles often or in time-critical code; one-off
+ * configuration goes through the IDF gpio driver as before.
+ *
+ * Usage:
+ *   using Board = HeltecV4;
+ *   gnssPower.start<Board::Gnss>();
+ *   FastPin<Board::vext, true> vext;   // active low
+ *   vext.output();
+ *   vext.on();
+ */
+
+#ifndef HELTEC_V4_BOARD_H
+#define HELTEC_V4_BOARD_H
+
+#include <stdint.h>
+#if defined(ARDUINO)
+#include <Arduino.h>
+#endif
+#include <driver/gpio.h>
+#include <soc/gpio_struct.h>
+
+// ESP32-S3 GPIO matrix: 0-21 and 26-48; 26-32 carry the flash/PSRAM bus
+constexpr bool esp32s3GpioExists(int pin) {
+  return (pin >= 0 && pin <= 21) || (pin >= 26 && pin <= 48);
+}
+constexpr bool esp32s3GpioUsable(int pin) {
+  return esp32s3GpioExists(pin) && !(pin >= 26 && pin <= 32);
+}
+
+namespace board_detail {
+constexpr bool allUsable() { return true; }
+template <typename... Rest>
+constexpr bool allUsable(int pin, Rest... rest) {
+  return esp32s3GpioUsable(pin) && allUsable(rest...);
+}
+
+constexpr bool noneEqual(int) { return true; }
+template <typename... Rest>
+constexpr bool noneEqual(int pin, int other, Rest... rest) {
+  return pin != other && noneEqual(pin, rest...);
+}
+
+constexpr bool allDistinct() { return true; }
+template <typename... Rest>
+constexpr bool allDistinct(int pin, Rest... rest) {
+  return noneEqual(pin, rest...) && allDistinct(rest...);
+}
+} // namespace board_detail
+
+// true if every pin is a usable ESP32-S3 GPIO and no two are the same
+template <typename... Pins>
+constexpr bool boardPinsValid(Pins... pins) {
+  return board_detail::allUsable(pins...) && board_detail::allDistinct(pins...);
+}
+
+struct HeltecV4 {
+  struct Gnss {
+    static constexpr uint8_t rx = 39;        // ESP32 RX <- GNSS TX
+    static constexpr uint8_t tx = 38;        // ESP32 TX -> GNSS RX
+    static constexpr uint8_t ctrl = 34;      // VGNSS_CTRL, supply on while LOW
+    static constexpr uint8_t wake = 40;      // active HIGH
+    static constexpr uint8_t rst = 42;       // active LOW
+    static constexpr uint8_t pps = 41;       // rising edge at the top of each UTC second
+    static constexpr bool ctrlActiveLow = true;
+    static constexpr uint32_t baud = 9600;   // factory default
+  };
+
+  // RX/TX swapped, the second candidate of the Debug_GNSS sweep
+  struct GnssSwapped : Gnss {
+    static constexpr uint8_t rx = Gnss::tx;
+    static constexpr uint8_t tx = Gnss::rx;
+  };
+
+  struct Oled {
+    static constexpr uint8_t sda = 17;
+    static constexpr uint8_t scl = 18;
+    static constexpr uint8_t rst = 21;
+    static constexpr uint8_t address = 0x3c;
+    static constexpr uint16_t width = 128;
+    static constexpr uint16_t height = 64;
+  };
+
+  struct Lora {
+    static constexpr uint8_t nss = 8;
+    static constexpr uint8_t sck = 9;
+    static constexpr uint8_t mosi = 10;
+    static constexpr uint8_t miso = 11;
+    static constexpr uint8_t rst = 12;
+    static constexpr uint8_t busy = 13;
+    static constexpr uint8_t dio1 = 14;      // DIO0 in pins_arduino.h
+  };
+
+  static constexpr uint8_t vext = 36;        // Vext rail on while LOW
+  static constexpr bool vextActiveLow = true;
+  static constexpr uint8_t led = 35;
+  static constexpr uint8_t prgButton = 0;    // PRG/BOOT, LOW while pressed
+  static constexpr uint8_t consoleTx = 43;
+  static constexpr uint8_t consoleRx = 44;
+};
+
+static_assert(boardPinsValid(HeltecV4::Gnss::rx, HeltecV4::Gnss::tx, HeltecV4::Gnss::ctrl,
+                             HeltecV4::Gnss::wake, HeltecV4::Gnss::rst, HeltecV4::Gnss::pps,
+                             HeltecV4::Oled::sda, HeltecV4::Oled::scl, HeltecV4::Oled::rst,
+                             HeltecV4::Lora::nss, HeltecV4::Lora::sck, HeltecV4::Lora::mosi,
+                             HeltecV4::Lora::miso, HeltecV4::Lora::rst, HeltecV4::Lora::busy,
+                             HeltecV4::Lora::dio1, HeltecV4::vext, HeltecV4::led,
+                             HeltecV4::prgButton, HeltecV4::consoleTx, HeltecV4::consoleRx),
+              "HeltecV4: pin missing on the ESP32-S3, on the flash bus or used twice");
+
+#if defined(ARDUINO_heltec_wifi_lora_32_V4)
+// the variant's pins_arduino.h constants are static const, usable here
+static_assert(HeltecV4::Oled::sda == SDA_OLED && HeltecV4::Oled::scl == SCL_OLED &&
+              HeltecV4::Oled::rst == RST_OLED, "HeltecV4::Oled differs from pins_arduino.h");
+static_assert(HeltecV4::Lora::rst == RST_LoRa && HeltecV4::Lora::busy == BUSY_LoRa &&
+              HeltecV4::Lora::dio1 == DIO0 && HeltecV4::Lora::nss == SS &&
+              HeltecV4::Lora::sck == SCK && HeltecV4::Lora::mosi == MOSI &&
+              HeltecV4::Lora::miso == MISO, "HeltecV4::Lora differs from pins_arduino.h");
+static_assert(HeltecV4::vext == Vext && HeltecV4::led == LED_BUILTIN,
+              "HeltecV4::vext/led differ from pins_arduino.h");
+#endif
+
+template <uint8_t Pin, bool ActiveLow = false>
+struct FastPin {
+  static_assert(esp32s3GpioUsable(Pin), "FastPin: not a usable ESP32-S3 GPIO");
+
+  static constexpr uint8_t pin = Pin;
+  static constexpr uint32_t mask = 1u << (Pin & 31);
+
+  // input+output, so read() returns the driven level
+  static void output() { configure(GPIO_MODE_INPUT_OUTPUT, false, false); }
+  static void input(bool pullUp = false, bool pullDown = false) {
+    configure(GPIO_MODE_INPUT, pullUp, pullDown);
+  }
+
+  static inline void high() {
+    if (Pin < 32) GPIO.out_w1ts = mask;
+    else GPIO.out1_w1ts.val = mask;
+  }
+  static inline void low() {
+    if (Pin < 32) GPIO.out_w1tc = mask;
+    else GPIO.out1_w1tc.val = mask;
+  }
+  static inline void write(bool level) { level ? high() : low(); }
+  static inline bool read() {
+    return Pin < 32 ? (GPIO.in & mask) != 0 : (GPIO.in1.val & mask) != 0;
+  }
+
+  // logical level, ActiveLow folded in
+  static inline void on() { write(!ActiveLow); }
+  static inline void off() { write(ActiveLow); }
+  static inline bool isOn() { return read() != ActiveLow; }
+
+private:
+  static void configure(gpio_mode_t mode, bool pullUp, bool pullDown) {
+    gpio_config_t io = {};
+    io.pin_bit_mask = 1ULL << Pin;
+    io.mode = mode;
+    io.pull_up_en = pullUp ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
+    io.pull_down_en = pullDown ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE;
+    io.intr_type = GPIO_INTR_DISABLE;
+    gpio_config(&io);
+  }
+};
+
+#endif // HELTEC_V4_BOARD_H
@@ -0,0 +1,181 @@
+#include "I2cOledTransport.h"
+
+// SSD1306 128x64, horizontal addressing; the same setup SSD1306Wire::init() sends
+static const uint8_t kInitSequence[] = {
+  0xAE,         // display off
+  0xD5, 0xF0,   // clock divide / oscillator
+  0xA8, 0x3F,   // multiplex 64
+  0xD3, 0x00,   // display offset
+  0x40,         // start line 0
+  0x8D, 0x14,   // charge pump on
+  0x20, 0x00,   // horizontal addressing
+  0xA1,         // segment remap
+  0xC8,         // COM scan descending
+  0xDA, 0x12,   // COM pins
+  0x81, 0xCF,   // contrast
+  0xD9, 0xF1,   // precharge
+  0xDB, 0x40,   // VCOMH deselect
+  0xA4,         // resume to RAM content
+  0xA6,         // normal (not inverted)
+  0x2E,         // scroll off
+  0xAF          // display on
+};
+
+bool I2cOledTransport::begin(const Config& cfg) {
+  end();
+  _cfg = cfg;
+  _next = 0;
+  _inFlight = 0;
+  _failed = false;
+  _stats = {};
+
+  if (!_free) _free = xSemaphoreCreateCounting(kSlots, kSlots);
+  if (!_free) return false;
+
+  if (_cfg.rst >= 0) {
+    pinMode(_cfg.rst, OUTPUT);
+    digitalWrite(_cfg.rst, LOW);
+    delay(10);
+    digitalWrite(_cfg.rst, HIGH);
+    delay(10);
+  }
+
+  i2c_master_bus_config_t bus = {};
+  bus.i2c_port = _cfg.port;
+  bus.sda_io_num = (gpio_num_t)_cfg.sda;
+  bus.scl_io_num = (gpio_num_t)_cfg.scl;
+  bus.clk_source = I2C_CLK_SRC_DEFAULT;
+  bus.glitch_ignore_cnt = 7;
+  bus.trans_queue_depth = kSlots;      // > 0: i2c_master_transmit() only queues
+  bus.flags.enable_internal_pullup = _cfg.internalPullups;
+  if (i2c_new_master_bus(&bus, &_bus) != ESP_OK) {
+    _bus = nullptr;
+    return false;
+  }
+  if (!addDevice()) {
+    end();
+    return false;
+  }
+  return writeCommands(kInitSequence, sizeof(kInitSequence)) && drain(100) && !takeError();
+}
+
+void I2cOledTransport::end() {
+  if (_bus) i2c_master_bus_wait_all_done(_bus, 100);
+  if (_dev) i2c_master_bus_rm_device(_dev);
+  if (_bus) i2c_del_master_bus(_bus);
+  _dev = nullptr;
+  _bus = nullptr;
+  if (_free) {
+    while (uxSemaphoreGetCount(_free) < kSlots) xSemaphoreGive(_free);
+  }
+  _inFlight = 0;
+}
+
+bool I2cOledTransport::addDevice() {
+  i2c_device_config_t dev = {};
+  dev.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+  dev.device_address = _cfg.address;
+  dev.scl_speed_hz = _cfg.clockHz;
+  if (i2c_master_bus_add_device(_bus, &dev, &_dev) != ESP_OK) {
+    _dev = nullptr;
+    return false;
+  }
+  i2c_master_event_callbacks_t cbs = {};
+  cbs.on_trans_done = onDone;
+  return i2c_master_register_event_callbacks(_dev, &cbs, this) == ESP_OK;
+}
+
+bool I2cOledTransport::setClock(uint32_t hz) {
+  if (!_bus || !drain(100)) return false;
+  if (_dev) i2c_master_bus_rm_device(_dev);
+  _dev = nullptr;
+  _cfg.clockHz = hz;
+  return addDevice();
+}
+
+bool IRAM_ATTR I2cOledTransport::onDone(i2c_master_dev_handle_t, const i2c_master_event_data_t* evt,
+                                        void* arg) {
+  I2cOledTransport* self = static_cast<I2cOledTransport*>(arg);
+  if (evt->event == I2C_EVENT_ALIVE) return false;   // still running
+
+  self->_stats.transactions++;
+  if (evt->event != I2C_EVENT_DONE) {
+    self->_stats.errors++;
+    self->_failed = true;
+  }
+
+  portENTER_CRITICAL_ISR(&self->_lock);
+  uint8_t left = --self->_inFlight;
+  portEXIT_CRITICAL_ISR(&self->_lock);
+
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(self->_free, &woken);
+  IdleHandler idle = self->_idle;
+  if (!left && idle) idle(self->_idleArg);
+  return woken == pdTRUE;
+}
+
+uint8_t* I2cOledTransport::acquireSlot() {
+  if (!_dev) return nullptr;
+  if (xSemaphoreTake(_free, 0) != pdTRUE) {
+    _stats.slotWaits++;
+    if (xSemaphoreTake(_free, pdMS_TO_TICKS(_cfg.slotWaitMs)) != pdTRUE) return nullptr;
+  }
+  uint8_t* slot = _slots[_next];
+  _next = (uint8_t)((_next + 1) % kSlots);
+  return slot;
+}
+
+bool I2cOledTransport::submit(uint8_t* slot, size_t len) {
+  portENTER_CRITICAL(&_lock);
+  _inFlight++;
+  portEXIT_CRITICAL(&_lock);
+
+  if (i2c_master_transmit(_dev, slot, len, 50) != ESP_OK) {
+    // never queued: no callback will release the slot
+    portENTER_CRITICAL(&_lock);
+    _inFlight--;
+    portEXIT_CRITICAL(&_lock);
+    xSemaphoreGive(_free);
+    _stats.errors++;
+    return false;
+  }
+  _bytesSent += len + 1;   // + address byte
+  return true;
+}
+
+bool I2cOledTransport::writeWindow(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t* data) {
+  uint8_t* slot = acquireSlot();
+  if (!slot) return false;
+
+  // Co = 1: one command byte follows each control byte
+  const uint8_t header[kHeader] = {
+    0x80, 0x21, 0x80, x0, 0x80, x1,
+    0x80, 0x22, 0x80, page, 0x80, page,
+    0x40                                 // Co = 0, D/C = 1: data to the end
+  };
+  size_t len = (size_t)(x1 - x0) + 1;
+  memcpy(slot, header, kHeader);
+  memcpy(slot + kHeader, data, len);
+  return submit(slot, kHeader + len);
+}
+
+bool I2cOledTransport::writeCommands(const uint8_t* cmds, size_t len) {
+  if (len > kSlotSize - 1) return false;
+  uint8_t* slot = acquireSlot();
+  if (!slot) return false;
+  slot[0] = 0x00;                        // command stream
+  memcpy(slot + 1, cmds, len);
+  return submit(slot, len + 1);
+}
+
+bool I2cOledTransport::drain(uint32_t timeoutMs) {
+  if (!_bus) return false;
+  return i2c_master_bus_wait_all_done(_bus, (int)timeoutMs) == ESP_OK;
+}
+
+bool I2cOledTransport::takeError() {
+  if (!_failed) return false;
+  _failed = false;
+  return true;
+}
@@ -0,0 +1,122 @@
+/**
+ * Asynchronous SSD1306 transport on the ESP-IDF i2c_master driver
+ *
+ * An OledTransport that queues each page slice as one I2C transaction and
+ * returns as soon as it is queued. The driver clocks the bytes out from its
+ * interrupt handler while the caller formats the next frame; every finished
+ * transaction releases its slot from the completion callback, and an
+ * optional idle handler fires when the queue runs empty.
+ *
+ * Each slice goes out in a single transaction: the six addressing commands
+ * are sent with Co=1 control bytes, then one 0x40 switches to data. That is
+ * 13 bytes of overhead per page instead of 8 + 2 per 127-byte chunk with
+ * Wire, and one START/address per page. A full frame is 8 x 141 bytes.
+ *
+ * writeWindow() copies the data into one of kSlots slot buffers, so the
+ * framebuffer can be redrawn right away; it only blocks when all slots are
+ * still in flight (a second full frame before the first one drained).
+ * Failures surface later: takeError() reports a NACK or timeout of a
+ * queued write and StatusScreen then resends the whole frame.
+ *
+ * Clock: the SSD1306 datasheet specifies 400 kHz, most panels run at 1 MHz
+ * (Fast-mode Plus) with the board pull-ups. Bus time of a full frame
+ * (1136 bytes x 9 bits) bounds the frame rate at ~10 fps @ 100 kHz,
+ * ~39 fps @ 400 kHz, ~78 fps @ 800 kHz and ~98 fps @ 1 MHz; OledBenchmark
+ * measures what a given panel really does.
+ *
+ * The transport owns the bus and sends the SSD1306 init sequence itself:
+ * use SSD1306Wire only for drawing (display.allocateBuffer() instead of
+ * display.init()) and do not start Wire on the same pins. Requires ESP-IDF
+ * 5.2 or newer (Arduino-ESP32 3.1+).
+ *
+ * Usage:
+ *   static I2cOledTransport oledLink;
+ *   display.allocateBuffer();
+ *   oledLink.begin(I2cOledTransport::Config());
+ *   StatusScreen screen(display, oledLink);
+ *   ...
+ *   screen.flush();          // queues the dirty slices and returns
+ */
+
+#ifndef I2C_OLED_TRANSPORT_H
+#define I2C_OLED_TRANSPORT_H
+
+#include <Arduino.h>
+#include <driver/i2c_master.h>
+#include <freertos/semphr.h>
+#include "OledTransport.h"
+#include "HeltecV4Board.h"
+
+class I2cOledTransport : public OledTransport {
+public:
+  static const uint8_t kSlots = 8;              // one full frame in flight
+  static const size_t kHeader = 13;             // 6 x (0x80, cmd) + 0x40
+  static const size_t kSlotSize = kHeader + 128;
+
+  struct Config {
+    i2c_port_num_t port = I2C_NUM_0;
+    int sda = HeltecV4::Oled::sda;
+    int scl = HeltecV4::Oled::scl;
+    int rst = HeltecV4::Oled::rst;           // -1 = no reset line
+    uint8_t address = HeltecV4::Oled::address;
+    uint32_t clockHz = 1000000;
+    bool internalPullups = true;             // on top of the board resistors
+    uint32_t slotWaitMs = 100;               // writeWindow() with every slot in flight
+  };
+
+  struct Stats {
+    uint32_t transactions;   // completed, including failed ones
+    uint32_t errors;         // NACK / timeout
+    uint32_t slotWaits;      // writeWindow() calls that had to wait for a slot
+  };
+
+  // runs in interrupt context when the last queued transaction completed
+  typedef void (*IdleHandler)(void* arg);
+
+  ~I2cOledTransport() { end(); }
+
+  // installs the bus, pulses RST and sends the SSD1306 init sequence
+  bool begin(const Config& cfg);
+  void end();
+
+  // waits for the queue to drain and re-adds the panel at the new SCL rate
+  bool setClock(uint32_t hz);
+  uint32_t clockHz() const { return _cfg.clockHz; }
+
+  // copies the slice into a free slot and queues it; see above for blocking
+  bool writeWindow(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t* data) override;
+  // command stream (Co = 0), up to kSlotSize - 1 bytes; queued like a slice
+  bool writeCommands(const uint8_t* cmds, size_t len) override;
+
+  bool drain(uint32_t timeoutMs) override;
+  bool takeError() override;
+
+  void setIdleHandler(IdleHandler fn, void* arg) {
+    _idleArg = arg;
+    _idle = fn;
+  }
+
+  uint8_t inFlight() const { return _inFlight; }
+  const Stats& stats() const { return _stats; }
+
+private:
+  static bool onDone(i2c_master_dev_handle_t dev, const i2c_master_event_data_t* evt, void* arg);
+  bool addDevice();
+  uint8_t* acquireSlot();
+  bool submit(uint8_t* slot, size_t len);
+
+  Config _cfg;
+  i2c_master_bus_handle_t _bus = nullptr;
+  i2c_master_dev_handle_t _dev = nullptr;
+  SemaphoreHandle_t _free = nullptr;     // counts idle slots
+  uint8_t _slots[kSlots][kSlotSize];
+  uint8_t _next = 0;                     // slot filled next; completions are FIFO
+  portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+  volatile uint8_t _inFlight = 0;
+  volatile bool _failed = false;
+  volatile IdleHandler _idle = nullptr;
+  void* _idleArg = nullptr;
+  Stats _stats = {};
+};
+
+#endif // I2C_OLED_TRANSPORT_H
@@ -0,0 +1,92 @@
+/**
+ * SSD1306 page/column window transport
+ *
+ * The SSD1306 (in horizontal addressing mode, as set by display.init())
+ * accepts a column range (0x21) and a page range (0x22) and then fills that
+ * window with the data bytes that follow. Writing one dirty page slice this
+ * way costs 7 command bytes plus the changed columns, instead of the full
+ * 1 KB frame that display.display() sends.
+ *
+ * OledTransport is the interface used by StatusScreen; WireOledTransport
+ * implements it with blocking Arduino Wire transactions, I2cOledTransport
+ * (I2cOledTransport.h) with queued ESP-IDF i2c_master transactions.
+ */
+
+#ifndef OLED_TRANSPORT_H
+#define OLED_TRANSPORT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class OledTransport {
+public:
+  virtual ~OledTransport() {}
+
+  // writes columns x0..x1 (inclusive) of one page; data holds x1 - x0 + 1 bytes
+  virtual bool writeWindow(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t* data) = 0;
+  // raw SSD1306 command bytes (contrast, display on / off)
+  virtual bool writeCommands(const uint8_t* cmds, size_t len) = 0;
+
+  // asynchronous transports: blocks until every queued write is on the panel
+  virtual bool drain(uint32_t /* timeoutMs */) { return true; }
+  // true once after a queued write failed after writeWindow() had returned
+  virtual bool takeError() { return false; }
+
+  // all 8 pages of a 128x64 horizontal-mode framebuffer
+  bool writeFrame(const uint8_t* fb) {
+    bool ok = true;
+    for (uint8_t p = 0; p < 8; p++) ok &= writeWindow(p, 0, 127, fb + p * 128);
+    return ok;
+  }
+
+  // bytes put on the bus so far, including addressing overhead
+  uint32_t bytesSent() const { return _bytesSent; }
+
+protected:
+  uint32_t _bytesSent = 0;
+};
+
+class WireOledTransport : public OledTransport {
+public:
+  explicit WireOledTransport(uint8_t address = 0x3c, TwoWire& wire = Wire)
+    : _address(address), _wire(wire) {}
+
+  bool writeWindow(uint8_t page, uint8_t x0, uint8_t x1, const uint8_t* data) override {
+    _wire.beginTransmission(_address);
+    _wire.write(0x00);                 // command stream
+    _wire.write(0x21); _wire.write(x0); _wire.write(x1);
+    _wire.write(0x22); _wire.write(page); _wire.write(page);
+    if (_wire.endTransmission() != 0) return false;
+    _bytesSent += 8;
+
+    // Wire buffers 128 bytes per transaction, one goes to the control byte
+    size_t len = (size_t)(x1 - x0) + 1;
+    while (len) {
+      size_t n = len > 127 ? 127 : len;
+      _wire.beginTransmission(_address);
+      _wire.write(0x40);               // data stream
+      _wire.write(data, n);
+      if (_wire.endTransmission() != 0) return false;
+      _bytesSent += n + 2;
+      data += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  bool writeCommands(const uint8_t* cmds, size_t len) override {
+    if (len > 127) return false;
+    _wire.beginTransmission(_address);
+    _wire.write(0x00);                 // command stream
+    _wire.write(cmds, len);
+    if (_wire.endTransmission() != 0) return false;
+    _bytesSent += len + 2;
+    return true;
+  }
+
+private:
+  uint8_t _address;
+  TwoWire& _wire;
+};
+
+#endif // OLED_TRANSPORT_H
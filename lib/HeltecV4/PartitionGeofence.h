@@ -0,0 +1,62 @@
+/**
+ * Geofence zones from a memory-mapped flash data partition
+ *
+ * Maps the zone blob written by a host tool (GeofenceWriter) into the data
+ * address space and hands it to Geofence::load(), so zone records and
+ * vertices are read straight from flash through the cache and only the
+ * grid index takes RAM. The partition is looked up by label and the custom
+ * data subtype from partitions_tracklog_16MB.csv:
+ *
+ *   geofence, data, 0x41, 0xFE0000, 0x10000
+ *
+ * Flash it with: esptool.py write_flash 0xFE0000 zones.bin
+ *
+ * The mapping stays valid until end(); keep this object alive as long as
+ * the Geofence is used. Erasing or writing the partition while mapped
+ * leaves stale cache lines: end(), write, begin() again.
+ */
+
+#ifndef PARTITION_GEOFENCE_H
+#define PARTITION_GEOFENCE_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "Geofence.h"
+
+#define GEOFENCE_PARTITION_SUBTYPE ((esp_partition_subtype_t)0x41)
+
+class PartitionGeofence {
+public:
+  // false if the partition is missing or holds no valid blob
+  bool begin(Geofence& fence, const char* label = "geofence") {
+    return begin(fence, Geofence::Config(), label);
+  }
+
+  bool begin(Geofence& fence, const Geofence::Config& config, const char* label = "geofence") {
+    end(fence);
+    const esp_partition_t* part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, GEOFENCE_PARTITION_SUBTYPE, label);
+    if (!part) return false;
+    const void* blob = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &blob, &_handle) != ESP_OK) {
+      return false;
+    }
+    _mapped = true;
+    if (fence.load(blob, part->size, config)) return true;
+    end(fence);
+    return false;
+  }
+
+  void end(Geofence& fence) {
+    if (!_mapped) return;
+    fence.unload();
+    esp_partition_munmap(_handle);
+    _mapped = false;
+  }
+
+private:
+  esp_partition_mmap_handle_t _handle = 0;
+  bool _mapped = false;
+};
+
+#endif // PARTITION_GEOFENCE_H
@@ -0,0 +1,53 @@
+/**
+ * TrackLogStorage on a raw ESP32 flash data partition
+ *
+ * Goes straight through esp_partition_read/write/erase_range: no
+ * filesystem, no wear-levelling layer (TrackLog recycles its sectors
+ * round-robin itself), no encryption. The partition is looked up by label
+ * and the custom data subtype from partitions_tracklog_16MB.csv:
+ *
+ *   tracklog, data, 0x40, 0x810000, 0x7D0000
+ *
+ * Flash writes and erases stall both cores while the cache is off (erase
+ * ~45 ms per 4 KB sector); code that must run through them belongs in IRAM.
+ */
+
+#ifndef PARTITION_TRACK_STORAGE_H
+#define PARTITION_TRACK_STORAGE_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "TrackLog.h"
+
+#define TRACK_LOG_PARTITION_SUBTYPE ((esp_partition_subtype_t)0x40)
+
+class PartitionTrackStorage : public TrackLogStorage {
+public:
+  bool begin(const char* label = "tracklog") {
+    _part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, TRACK_LOG_PARTITION_SUBTYPE, label);
+    return _part != nullptr;
+  }
+
+  const esp_partition_t* partition() const { return _part; }
+
+  uint32_t size() const override {
+    return _part ? _part->size / TrackLog::kSectorSize * TrackLog::kSectorSize : 0;
+  }
+
+  bool read(uint32_t offset, void* out, size_t len) override {
+    return _part && esp_partition_read(_part, offset, out, len) == ESP_OK;
+  }
+
+  bool write(uint32_t offset, const void* data, size_t len) override {
+    return _part && esp_partition_write(_part, offset, data, len) == ESP_OK;
+  }
+
+  bool erase(uint32_t offset, size_t len) override {
+    return _part && esp_partition_erase_range(_part, offset, len) == ESP_OK;
+  }
+
+private:
+  const esp_partition_t* _part = nullptr;
+};
+
+#endif // PARTITION_TRACK_STORAGE_H
@@ -0,0 +1,170 @@
+#include "PpsTimebase.h"
+
+bool PpsTimebase::begin(int ppsPin) {
+  if (ppsPin < 0) return false;
+  _pin = ppsPin;
+
+  portENTER_CRITICAL(&_lock);
+  _edge[0] = _edge[1] = 0;
+  _anchor = {};
+  _locked = false;
+  _driftValid = false;
+  _stats = {};
+  portEXIT_CRITICAL(&_lock);
+
+  pinMode(_pin, INPUT);
+  attachInterruptArg(_pin, onPps, this, RISING);
+  return true;
+}
+
+void PpsTimebase::end() {
+  if (_pin < 0) return;
+  detachInterrupt(_pin);
+  _pin = -1;
+}
+
+int64_t IRAM_ATTR PpsTimebase::extrapolate(const Anchor& a, int64_t localUs) {
+  int64_t dt = localUs - a.edgeUs;
+  int64_t utc = a.utcUs + dt - dt * a.ppb / 1000000000LL;
+
+  // the residual of the last edge fades out linearly over one second
+  if (dt < 0) utc += a.slewUs;
+  else if (dt < 1000000) utc += (int64_t)a.slewUs * (1000000 - dt) / 1000000;
+  return utc;
+}
+
+void IRAM_ATTR PpsTimebase::onPps(void* arg) {
+  static_cast<PpsTimebase*>(arg)->record(esp_timer_get_time(), true);
+}
+
+void PpsTimebase::edgeAt(int64_t localUs) {
+  record(localUs, false);
+}
+
+void IRAM_ATTR PpsTimebase::record(int64_t now, bool fromIsr) {
+  portENTER_CRITICAL_SAFE(&_lock);
+  Stats& st = _stats;
+
+  if (_edge[0] && now - _edge[0] < 500000) {
+    // contact bounce or a stray pulse; a late injected edge the ISR already saw is no glitch
+    if (fromIsr) {
+      st.edges++;
+      st.glitches++;
+    }
+    portEXIT_CRITICAL_SAFE(&_lock);
+    return;
+  }
+  st.edges++;
+  _edge[1] = _edge[0];
+  _edge[0] = now;
+
+  if (_locked) {
+    Anchor& a = _anchor;
+    int64_t interval = now - a.edgeUs;
+    int64_t secs = (interval + 500000) / 1000000;
+
+    int64_t predicted = extrapolate(a, now);
+    int64_t actual = a.utcUs + secs * 1000000;
+
+    // one-second intervals measure the local clock error
+    if (secs == 1) {
+      int32_t sample = (int32_t)((interval - 1000000) * 1000);
+      if (sample > kMaxDriftPpb || sample < -kMaxDriftPpb) {
+        st.glitches++;
+      } else if (!_driftValid) {
+        a.ppb = sample;
+        _driftValid = true;
+      } else {
+        a.ppb += (sample - a.ppb) / 8;
+      }
+    }
+
+    int64_t err = predicted - actual;
+    st.lastErrorUs = (int32_t)(err > INT32_MAX ? INT32_MAX : err < INT32_MIN ? INT32_MIN : err);
+    if (err > kStepUs || err < -kStepUs) {
+      a.slewUs = 0;
+      st.steps++;
+    } else {
+      a.slewUs = (int32_t)err;
+    }
+    a.edgeUs = now;
+    a.utcUs = actual;
+  }
+  portEXIT_CRITICAL_SAFE(&_lock);
+}
+
+bool PpsTimebase::tie(const GnssFix& fix) {
+  if (!fix.timeValid || !fix.dateValid) return false;
+
+  int64_t now = esp_timer_get_time();
+  int64_t sub = (int64_t)fix.centisecond * 10000;
+
+  int64_t e0, e1;
+  edges(e0, e1);
+
+  // the edge of the fix's second is the latest one unless the next second
+  // already started (fix late by more than the rest of its second)
+  int64_t edge = e0 + sub <= now ? e0 : e1;
+  if (edge == 0 || now - (edge + sub) >= 1000000) return false;   // no PPS or stale
+
+  int64_t utc0 = gnssUnixSeconds(fix) * 1000000;
+  if (edge != e0) utc0 += (e0 - e1 + 500000) / 1000000 * 1000000;
+
+  bool ok = true;
+  portENTER_CRITICAL(&_lock);
+  if (_edge[0] != e0) {
+    ok = false;                // an edge arrived meanwhile; the next epoch retries
+  } else if (!_locked) {
+    _anchor.edgeUs = e0;
+    _anchor.utcUs = utc0;
+    _anchor.slewUs = 0;
+    _locked = true;
+    _stats.steps++;
+  } else if (_anchor.edgeUs == e0 && _anchor.utcUs != utc0) {
+    _anchor.utcUs = utc0;
+    _anchor.slewUs = 0;
+    _stats.resyncs++;
+    _stats.steps++;
+  }
+  portEXIT_CRITICAL(&_lock);
+  return ok;
+}
+
+PpsTimebase::State PpsTimebase::state() const {
+  portENTER_CRITICAL(&_lock);
+  bool locked = _locked;
+  int64_t edge = _anchor.edgeUs;
+  portEXIT_CRITICAL(&_lock);
+
+  if (!locked) return UNLOCKED;
+  return esp_timer_get_time() - edge > 1500000 ? HOLDOVER : LOCKED;
+}
+
+int64_t PpsTimebase::utcMicrosAt(int64_t localUs) const {
+  portENTER_CRITICAL(&_lock);
+  bool locked = _locked;
+  Anchor a = _anchor;
+  portEXIT_CRITICAL(&_lock);
+
+  return locked ? extrapolate(a, localUs) : 0;
+}
+
+int64_t PpsTimebase::localForUtc(int64_t utcUs) const {
+  portENTER_CRITICAL(&_lock);
+  bool locked = _locked;
+  Anchor a = _anchor;
+  portEXIT_CRITICAL(&_lock);
+  if (!locked) return 0;
+
+  // invert the drift term, then one correction step for the slew
+  int64_t d = utcUs - a.utcUs;
+  int64_t local = a.edgeUs + d + d * a.ppb / 1000000000LL;
+  return local - (extrapolate(a, local) - utcUs);
+}
+
+void PpsTimebase::edges(int64_t& latest, int64_t& previous) const {
+  portENTER_CRITICAL(&_lock);
+  latest = _edge[0];
+  previous = _edge[1];
+  portEXIT_CRITICAL(&_lock);
+}
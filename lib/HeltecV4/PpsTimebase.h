@@ -0,0 +1,100 @@
+/**
+ * PPS-disciplined microsecond UTC timebase
+ *
+ * The receiver's PPS output rises at the top of every UTC second. A GPIO
+ * interrupt timestamps each edge with esp_timer_get_time(); the UTC second
+ * of an edge is learned once from a decoded fix (tie()), after which every
+ * further edge is simply "previous second + n", so the timebase keeps
+ * running without the parser.
+ *
+ *   utcMicros()          now, microseconds since 1970-01-01 UTC
+ *   utcMicrosAt(local)   an esp_timer timestamp taken earlier (e.g. in an ISR)
+ *   localForUtc(utc)     esp_timer time of a future UTC instant (TX slots)
+ *
+ * Drift: the esp_timer crystal runs some ppm off. The length of every
+ * one-second PPS interval feeds a low-pass estimate of that error (ppb),
+ * which scales the extrapolation between edges and during holdover.
+ *
+ * Monotonic: the residual error found at a new edge is not stepped but
+ * slewed out linearly over the following second. Only errors above
+ * kStepUs (wrong tie, very long holdover) cause a step.
+ *
+ * tie() expects the PPS edge to precede the fix of the same second by less
+ * than one second, which holds for NMEA and UBX output at any rate.
+ */
+
+#ifndef PPS_TIMEBASE_H
+#define PPS_TIMEBASE_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "GnssFix.h"
+
+class PpsTimebase {
+public:
+  enum State : uint8_t {
+    UNLOCKED,    // no edge tied to a UTC second yet
+    LOCKED,      // edges arriving
+    HOLDOVER     // locked before, no edge for more than 1.5 s
+  };
+
+  static const int32_t kStepUs = 100000;       // larger errors are stepped, not slewed
+  static const int32_t kMaxDriftPpb = 200000;  // intervals further off are glitches
+
+  struct Stats {
+    uint32_t edges;
+    uint32_t glitches;     // edges rejected as too close / too far off
+    uint32_t steps;        // discontinuities (first lock included)
+    uint32_t resyncs;      // tie() disagreed with the running second count
+    int32_t lastErrorUs;   // prediction error at the latest edge
+  };
+
+  bool begin(int ppsPin);
+  void end();
+
+  // ties the latest PPS edge to the UTC second of a fix that has just been
+  // decoded; call for every new epoch, it only changes state when needed
+  bool tie(const GnssFix& fix);
+
+  State state() const;
+  bool locked() const { return state() != UNLOCKED; }
+
+  // 0 while UNLOCKED
+  int64_t utcMicros() const { return utcMicrosAt(esp_timer_get_time()); }
+  int64_t utcMicrosAt(int64_t localUs) const;
+  int64_t localForUtc(int64_t utcUs) const;
+
+  // feeds an edge timestamped elsewhere, e.g. the wake-up time when the PPS
+  // level ended a light sleep (edge interrupts are not seen while asleep);
+  // ignored if the interrupt already recorded that edge
+  void edgeAt(int64_t localUs);
+
+  // latest and previous raw edge (esp_timer us, 0 = none yet)
+  void edges(int64_t& latest, int64_t& previous) const;
+
+  int32_t driftPpb() const { return _anchor.ppb; }
+  const Stats& stats() const { return _stats; }
+
+private:
+  struct Anchor {
+    int64_t edgeUs;     // esp_timer time of the anchoring edge
+    int64_t utcUs;      // UTC of that edge (whole second)
+    int32_t slewUs;     // residual, fades to 0 over the next second
+    int32_t ppb;        // local clock fast by this much
+  };
+
+  static void IRAM_ATTR onPps(void* arg);
+  void IRAM_ATTR record(int64_t localUs, bool fromIsr);
+  static int64_t extrapolate(const Anchor& a, int64_t localUs);
+
+  int _pin = -1;
+  mutable portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+  int64_t _edge[2] = { 0, 0 };   // [0] latest, [1] previous
+  Anchor _anchor = {};
+  bool _locked = false;
+  bool _driftValid = false;
+  Stats _stats = {};
+};
+
+#endif // PPS_TIMEBASE_H
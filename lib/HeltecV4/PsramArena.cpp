@@ -0,0 +1,72 @@
+#include "PsramArena.h"
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+
+bool PsramArena::begin(size_t bytes) {
+  end();
+  bytes = (bytes + kAlign - 1) / kAlign * kAlign;
+  if (!bytes) return false;
+  _data = (uint8_t*)heap_caps_aligned_alloc(kAlign, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!_data) return false;
+  _size = bytes;
+  _stats = {};
+  return true;
+}
+
+void PsramArena::end() {
+  if (_dma) esp_async_memcpy_uninstall(_dma);
+  _dma = nullptr;
+  if (_done) vSemaphoreDelete(_done);
+  _done = nullptr;
+  if (_data) heap_caps_free(_data);
+  _data = nullptr;
+  _size = 0;
+}
+
+bool PsramArena::enableDma() {
+  if (_dma) return true;
+  if (!_done) _done = xSemaphoreCreateBinary();
+  if (!_done) return false;
+  xSemaphoreTake(_done, 0);
+
+  async_memcpy_config_t cfg = ASYNC_MEMCPY_DEFAULT_CONFIG();
+  cfg.backlog = 4;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+  cfg.dma_burst_size = kAlign;
+#else
+  cfg.sram_trans_align = 4;
+  cfg.psram_trans_align = kAlign;
+#endif
+  if (esp_async_memcpy_install(&cfg, &_dma) != ESP_OK) {
+    _dma = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool IRAM_ATTR PsramArena::onCopyDone(async_memcpy_handle_t, async_memcpy_event_t*, void* arg) {
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(((PsramArena*)arg)->_done, &woken);
+  return woken == pdTRUE;
+}
+
+void PsramArena::copy(void* dst, const void* src, size_t bytes) {
+  bool aligned = (((uintptr_t)dst | (uintptr_t)src | bytes) & (kAlign - 1)) == 0;
+  if (_dma && aligned && bytes >= kDmaMinBytes) {
+    if (esp_async_memcpy(_dma, dst, (void*)src, bytes, onCopyDone, this) != ESP_OK) {
+      _stats.dmaErrors++;
+    } else if (xSemaphoreTake(_done, pdMS_TO_TICKS(100)) == pdTRUE) {
+      _stats.dmaCopies++;
+      return;
+    } else {
+      // still in flight: stop the channel before the CPU touches dst, and
+      // drop a completion that came in meanwhile so no later copy takes it
+      _stats.dmaErrors++;
+      esp_async_memcpy_uninstall(_dma);
+      _dma = nullptr;
+      xSemaphoreTake(_done, 0);
+    }
+  }
+  memcpy(dst, src, bytes);
+  _stats.cpuCopies++;
+}
@@ -0,0 +1,91 @@
+/**
+ * PSRAM block for bulk track storage, with an optional GDMA copy engine
+ *
+ * The V4's ESP32-S3R2 has 2 MB of quad-SPI PSRAM beside the 320 KB of
+ * internal SRAM (BOARD_HAS_PSRAM and memory_type qio_qspi in the board
+ * JSON). PsramArena takes one block out of it with heap_caps and hands it
+ * to a TrackBuffer as the arena behind the SRAM hot window.
+ *
+ * PSRAM is mapped through the data cache: the CPU reads and writes it like
+ * SRAM, at a lower bandwidth once the cache misses (32-byte lines over a
+ * 4-bit bus at 80 MHz). A batch spill of N records costs one memcpy of
+ * N * 16 bytes; PsramBenchmark measures that for every direction and size.
+ *
+ * enableDma() installs an esp_async_memcpy (AHB GDMA) channel, and move()
+ * can then serve as TrackBuffer::Mover: copies of at least kDmaMinBytes
+ * with 32-byte aligned addresses and length run on the DMA while the
+ * calling task blocks on a semaphore, so the other core's tasks (and the
+ * same core's lower-priority ones) get the time; anything else is a
+ * memcpy. The driver writes back and invalidates the cache lines itself
+ * (ESP-IDF 5.2+, Arduino-ESP32 3.1+). A copy that does not complete within
+ * 100 ms uninstalls the channel before falling back to memcpy, so nothing
+ * is still writing dst; later copies are memcpy until enableDma() again.
+ *
+ * PSRAM loses its content in deep sleep; state that must survive a sleep
+ * belongs in RTC memory (see LoRaTracker).
+ *
+ * Usage:
+ *   static PsramArena arena;
+ *   static TrackBuffer<256, 64> track;
+ *   if (arena.begin(1 << 20)) {
+ *     track.attachArena(arena.as<FixRecord>(), arena.size() / sizeof(FixRecord));
+ *     if (arena.enableDma()) track.setMover(PsramArena::move, &arena);
+ *   }
+ */
+
+#ifndef PSRAM_ARENA_H
+#define PSRAM_ARENA_H
+
+#include <Arduino.h>
+#include <esp_async_memcpy.h>
+#include <freertos/semphr.h>
+
+class PsramArena {
+public:
+  static const size_t kAlign = 32;          // cache line, GDMA burst
+  static const size_t kDmaMinBytes = 512;   // below that, setup costs more than the copy
+
+  struct Stats {
+    uint32_t dmaCopies;
+    uint32_t cpuCopies;
+    uint32_t dmaErrors;   // submit failed or timed out (channel removed), fell back to memcpy
+  };
+
+  ~PsramArena() { end(); }
+
+  // allocates `bytes` (rounded up to kAlign) of PSRAM; false if there is
+  // no PSRAM or not that much free
+  bool begin(size_t bytes);
+  void end();
+
+  uint8_t* data() const { return _data; }
+  size_t size() const { return _size; }
+  template <typename T>
+  T* as() const { return (T*)_data; }
+
+  // installs the async memcpy channel; false if the driver is unavailable
+  bool enableDma();
+  bool dmaEnabled() const { return _dma != nullptr; }
+
+  // blocking copy, DMA when eligible (see above); dst and src may be in
+  // either memory
+  void copy(void* dst, const void* src, size_t bytes);
+
+  // TrackBuffer::Mover adapter, arg = the PsramArena
+  static void move(void* dst, const void* src, size_t bytes, void* arg) {
+    ((PsramArena*)arg)->copy(dst, src, bytes);
+  }
+
+  const Stats& stats() const { return _stats; }
+
+private:
+  static bool IRAM_ATTR onCopyDone(async_memcpy_handle_t h, async_memcpy_event_t* e, void* arg);
+
+  uint8_t* _data = nullptr;
+  size_t _size = 0;
+  async_memcpy_handle_t _dma = nullptr;
+  SemaphoreHandle_t _done = nullptr;
+  Stats _stats = {};
+};
+
+#endif // PSRAM_ARENA_H
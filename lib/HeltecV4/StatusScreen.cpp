@@ -0,0 +1,162 @@
+#include "StatusScreen.h"
+
+int8_t StatusScreen::add(const Field& f) {
+  if (_count >= kMaxFields) return -1;
+  _fields[_count] = f;
+  return (int8_t)_count++;
+}
+
+int8_t StatusScreen::addText(int16_t x, int16_t y, uint8_t width, Align align, uint8_t height) {
+  Field f = {};
+  f.kind = Text;
+  f.align = align;
+  f.x0 = align == AlignRight ? (int16_t)(x - width + 1) : x;
+  f.y0 = y;
+  f.w = width;
+  f.h = height;
+  f.anchorX = x;
+  return add(f);
+}
+
+int8_t StatusScreen::addBar(int16_t x, int16_t y, uint8_t width, uint8_t height) {
+  Field f = {};
+  f.kind = Bar;
+  f.x0 = x;
+  f.y0 = y;
+  f.w = width + 1;     // drawProgressBar() paints width + 1 columns
+  f.h = height + 1;
+  f.anchorX = x;
+  f.value = 0xFF;
+  return add(f);
+}
+
+void StatusScreen::setText(int8_t field, const char* text) {
+  if (field < 0 || field >= _count) return;
+  Field& f = _fields[field];
+  if (strncmp(f.text, text, kTextMax - 1) == 0) return;
+  strncpy(f.text, text, kTextMax - 1);
+  f.text[kTextMax - 1] = 0;
+  f.changed = true;
+}
+
+void StatusScreen::setBar(int8_t field, uint8_t progress) {
+  if (field < 0 || field >= _count) return;
+  Field& f = _fields[field];
+  if (progress > 100) progress = 0xFF;
+  if (f.value == progress) return;
+  f.value = progress;
+  f.changed = true;
+}
+
+void StatusScreen::hide(int8_t field) {
+  if (field < 0 || field >= _count) return;
+  if (_fields[field].kind == Bar) setBar(field, 0xFF);
+  else setText(field, "");
+}
+
+bool StatusScreen::visible(const Field& f) const {
+  return f.kind == Bar ? f.value <= 100 : f.text[0] != 0;
+}
+
+bool StatusScreen::overlaps(const Field& a, const Field& b) const {
+  return a.x0 < b.x0 + b.w && b.x0 < a.x0 + a.w &&
+         a.y0 < b.y0 + b.h && b.y0 < a.y0 + a.h;
+}
+
+void StatusScreen::markDirty(const Field& f) {
+  int16_t x0 = f.x0 < 0 ? 0 : f.x0;
+  int16_t x1 = f.x0 + f.w - 1;
+  if (x1 >= kWidth) x1 = kWidth - 1;
+  int16_t p0 = f.y0 < 0 ? 0 : f.y0 >> 3;
+  int16_t p1 = (f.y0 + f.h - 1) >> 3;
+  if (p1 >= kPages) p1 = kPages - 1;
+  if (x0 > x1) return;
+
+  for (int16_t p = p0; p <= p1; p++) {
+    if (x0 < _dirtyLo[p]) _dirtyLo[p] = (uint8_t)x0;
+    if (x1 > _dirtyHi[p] || _dirtyHi[p] == 0xFF) _dirtyHi[p] = (uint8_t)x1;
+  }
+}
+
+void StatusScreen::draw(const Field& f) {
+  if (!visible(f)) return;
+  _display.setColor(WHITE);
+  if (f.kind == Bar) {
+    _display.drawProgressBar(f.x0, f.y0, f.w - 1, f.h - 1, f.value);
+    return;
+  }
+  if (_cache && _cache->draw(_display.buffer, f.anchorX, f.y0, f.text, f.align == AlignRight)) return;
+  _display.setTextAlignment(f.align == AlignRight ? TEXT_ALIGN_RIGHT : TEXT_ALIGN_LEFT);
+  _display.drawString(f.anchorX, f.y0, f.text);
+}
+
+uint8_t StatusScreen::flush() {
+  // an asynchronous write failed: the panel no longer matches the shadow
+  if (_transport.takeError()) _full = true;
+
+  for (uint8_t p = 0; p < kPages; p++) {
+    _dirtyLo[p] = 0xFF;
+    _dirtyHi[p] = 0xFF;
+  }
+
+  if (_full) {
+    _display.clear();
+    for (uint8_t i = 0; i < _count; i++) {
+      draw(_fields[i]);
+      _fields[i].changed = false;
+    }
+    for (uint8_t p = 0; p < kPages; p++) {
+      _dirtyLo[p] = 0;
+      _dirtyHi[p] = kWidth - 1;
+    }
+    // make every byte differ so nothing gets trimmed
+    for (size_t i = 0; i < sizeof(_shadow); i++) _shadow[i] = ~_display.buffer[i];
+    _full = false;
+  } else {
+    bool any = false;
+    for (uint8_t i = 0; i < _count; i++) any |= _fields[i].changed;
+    if (!any) return 0;
+
+    // 1) clear the boxes of everything that changed
+    _display.setColor(BLACK);
+    for (uint8_t i = 0; i < _count; i++) {
+      const Field& f = _fields[i];
+      if (!f.changed) continue;
+      _display.fillRect(f.x0, f.y0, f.w, f.h);
+      markDirty(f);
+    }
+    // 2) redraw changed fields and visible neighbours whose box was touched
+    for (uint8_t i = 0; i < _count; i++) {
+      const Field& f = _fields[i];
+      bool touched = f.changed;
+      for (uint8_t j = 0; j < _count && !touched; j++) {
+        touched = _fields[j].changed && overlaps(f, _fields[j]);
+      }
+      if (touched) draw(f);
+    }
+    for (uint8_t i = 0; i < _count; i++) _fields[i].changed = false;
+  }
+
+  // 3) send the dirty slices, trimmed to the bytes that differ from the panel
+  const uint8_t* fb = _display.buffer;
+  uint8_t sent = 0;
+  for (uint8_t p = 0; p < kPages; p++) {
+    if (_dirtyHi[p] == 0xFF) continue;
+    const uint8_t* row = fb + p * kWidth;
+    uint8_t* shadow = _shadow + p * kWidth;
+    int16_t lo = _dirtyLo[p];
+    int16_t hi = _dirtyHi[p];
+    while (lo <= hi && row[lo] == shadow[lo]) lo++;
+    while (hi >= lo && row[hi] == shadow[hi]) hi--;
+    if (lo > hi) continue;
+
+    if (_transport.writeWindow(p, (uint8_t)lo, (uint8_t)hi, row + lo)) {
+      memcpy(shadow + lo, row + lo, (size_t)(hi - lo + 1));
+    } else {
+      _full = true;   // panel state unknown, resend everything next time
+    }
+    sent++;
+  }
+  _slices += sent;
+  return sent;
+}
@@ -0,0 +1,105 @@
+/**
+ * Retained-mode status screen with dirty-page refresh
+ *
+ * Holds the current content of every text field (and progress bar) on the
+ * 128x64 SSD1306. setText() is a no-op when the text did not change, so a
+ * refresh only clears and redraws the fields that actually changed and then
+ * pushes just the affected page/column slices through an OledTransport.
+ *
+ * A shadow copy of what is on the panel trims each slice to the columns
+ * whose bytes really differ: when only the centiseconds tick, a refresh sends
+ * a few dozen bytes instead of the full 1 KB frame.
+ *
+ * Fields have a fixed bounding box that is cleared before the field is
+ * redrawn. Boxes may overlap (e.g. two layouts sharing a region): hiding a
+ * field clears its box and any visible field touching it is redrawn.
+ *
+ * With a TextCache attached, fields whose text is made of cached labels and
+ * glyphs are composed from pre-rasterised column bytes instead of
+ * drawString().
+ *
+ *   StatusScreen screen(display, transport);
+ *   int8_t timeField = screen.addText(0, 0, 76);
+ *   ...
+ *   screen.setText(timeField, "12:34:56.78");
+ *   screen.flush();
+ */
+
+#ifndef STATUS_SCREEN_H
+#define STATUS_SCREEN_H
+
+#include <Arduino.h>
+#include "HT_SSD1306Wire.h"
+#include "OledTransport.h"
+#include "TextCache.h"
+
+class StatusScreen {
+public:
+  static const uint8_t kMaxFields = 12;
+  static const uint8_t kTextMax = 24;
+  static const uint8_t kWidth = 128;
+  static const uint8_t kPages = 8;
+
+  enum Align : uint8_t { AlignLeft, AlignRight };
+
+  StatusScreen(SSD1306Wire& display, OledTransport& transport)
+    : _display(display), _transport(transport) {}
+
+  // x is the left edge (AlignLeft) or the right edge (AlignRight) of the box;
+  // returns the field id or -1 when the table is full
+  int8_t addText(int16_t x, int16_t y, uint8_t width, Align align = AlignLeft, uint8_t height = 13);
+  int8_t addBar(int16_t x, int16_t y, uint8_t width, uint8_t height);
+
+  // empty text hides the field
+  void setText(int8_t field, const char* text);
+  // progress 0..100, anything above hides the bar
+  void setBar(int8_t field, uint8_t progress);
+  void hide(int8_t field);
+
+  // draws texts the cache covers from pre-rasterised bitmaps (nullptr = off);
+  // build the cache with the font the screen uses
+  void setTextCache(TextCache* cache) { _cache = cache; }
+
+  // forget the panel state; the next flush redraws and sends the whole frame
+  void invalidate() { _full = true; }
+
+  // renders changed fields and sends the dirty slices; returns the number of slices sent
+  uint8_t flush();
+
+  uint32_t slicesSent() const { return _slices; }
+
+private:
+  enum Kind : uint8_t { Text, Bar };
+
+  struct Field {
+    int16_t x0, y0;      // bounding box, top left
+    uint8_t w, h;
+    int16_t anchorX;     // drawString() x for the alignment
+    Kind kind;
+    Align align;
+    bool changed;
+    uint8_t value;       // bar progress, > 100 = hidden
+    char text[kTextMax];
+  };
+
+  bool visible(const Field& f) const;
+  bool overlaps(const Field& a, const Field& b) const;
+  void markDirty(const Field& f);
+  void draw(const Field& f);
+  int8_t add(const Field& f);
+
+  SSD1306Wire& _display;
+  OledTransport& _transport;
+  TextCache* _cache = nullptr;
+
+  Field _fields[kMaxFields];
+  uint8_t _count = 0;
+  bool _full = true;
+
+  uint8_t _dirtyLo[kPages];
+  uint8_t _dirtyHi[kPages];
+  uint8_t _shadow[kWidth * kPages];   // what the panel currently shows
+  uint32_t _slices = 0;
+};
+
+#endif // STATUS_SCREEN_H
@@ -0,0 +1,480 @@
+#include "Sx1262.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+// opcodes (SX1261/2 datasheet, chapter 13)
+#define SX_SET_SLEEP          0x84
+#define SX_SET_STANDBY        0x80
+#define SX_SET_TX             0x83
+#define SX_SET_RX             0x82
+#define SX_SET_REGULATOR      0x96
+#define SX_CALIBRATE          0x89
+#define SX_CALIBRATE_IMAGE    0x98
+#define SX_SET_PA_CONFIG      0x95
+#define SX_SET_DIO_IRQ        0x08
+#define SX_GET_IRQ_STATUS     0x12
+#define SX_CLEAR_IRQ_STATUS   0x02
+#define SX_SET_DIO2_RF_SWITCH 0x9D
+#define SX_SET_DIO3_TCXO      0x97
+#define SX_SET_RF_FREQUENCY   0x86
+#define SX_SET_PACKET_TYPE    0x8A
+#define SX_SET_TX_PARAMS      0x8E
+#define SX_SET_MODULATION     0x8B
+#define SX_SET_PACKET_PARAMS  0x8C
+#define SX_SET_BUFFER_BASE    0x8F
+#define SX_GET_STATUS         0xC0
+#define SX_GET_RX_BUFFER      0x13
+#define SX_GET_PACKET_STATUS  0x14
+#define SX_WRITE_REGISTER     0x0D
+#define SX_WRITE_BUFFER       0x0E
+#define SX_READ_BUFFER        0x1E
+
+#define SX_REG_SYNC_WORD      0x0740
+
+// IRQ bits
+#define SX_IRQ_TX_DONE        0x0001
+#define SX_IRQ_RX_DONE        0x0002
+#define SX_IRQ_HEADER_ERR     0x0020
+#define SX_IRQ_CRC_ERR        0x0040
+#define SX_IRQ_TIMEOUT        0x0200
+#define SX_IRQ_USED (SX_IRQ_TX_DONE | SX_IRQ_RX_DONE | SX_IRQ_HEADER_ERR | SX_IRQ_CRC_ERR | SX_IRQ_TIMEOUT)
+
+static const size_t kBufSize = Sx1262::kMaxPayload + 4;
+
+// timeouts are counted in 15.625 us steps, 64 per ms
+static void putTimeout(uint8_t* p, uint32_t ms) {
+  uint32_t t = ms ? ms * 64 : 0;
+  if (t > 0xFFFFFF) t = 0xFFFFFF;
+  p[0] = (uint8_t)(t >> 16);
+  p[1] = (uint8_t)(t >> 8);
+  p[2] = (uint8_t)t;
+}
+
+bool Sx1262::begin(const Pins& pins, const Config& cfg, spi_host_device_t host) {
+  if (_spi) end();
+  _pins = pins;
+  _cfg = cfg;
+  _host = host;
+  _counters = {};
+
+  _tx = (uint8_t*)heap_caps_malloc(kBufSize, MALLOC_CAP_DMA);
+  _rx = (uint8_t*)heap_caps_malloc(kBufSize, MALLOC_CAP_DMA);
+  _lock = xSemaphoreCreateMutex();
+  _busyFree = xSemaphoreCreateBinary();
+  _events = xQueueCreate(8, sizeof(Event));
+  if (!_tx || !_rx || !_lock || !_busyFree || !_events) {
+    end();
+    return false;
+  }
+
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = _pins.mosi;
+  bus.miso_io_num = _pins.miso;
+  bus.sclk_io_num = _pins.sck;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = kBufSize;
+  if (spi_bus_initialize(_host, &bus, SPI_DMA_CH_AUTO) != ESP_OK) {
+    end();
+    return false;
+  }
+
+  spi_device_interface_config_t dev = {};
+  dev.mode = 0;
+  dev.clock_speed_hz = (int)_cfg.spiHz;
+  dev.spics_io_num = _pins.nss;
+  dev.queue_size = 1;
+  if (spi_bus_add_device(_host, &dev, &_spi) != ESP_OK) {
+    spi_bus_free(_host);
+    end();
+    return false;
+  }
+
+  // BUSY: falling edge, only enabled while a command waits for it
+  gpio_config_t io = {};
+  io.pin_bit_mask = 1ULL << _pins.busy;
+  io.mode = GPIO_MODE_INPUT;
+  io.intr_type = GPIO_INTR_NEGEDGE;
+  gpio_config(&io);
+  gpio_intr_disable((gpio_num_t)_pins.busy);
+
+  io.pin_bit_mask = 1ULL << _pins.dio1;
+  io.pull_down_en = GPIO_PULLDOWN_ENABLE;
+  io.intr_type = GPIO_INTR_POSEDGE;
+  gpio_config(&io);
+
+  // Arduino's attachInterrupt() may have installed the service already
+  esp_err_t err = gpio_install_isr_service(0);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+    end();
+    return false;
+  }
+  gpio_isr_handler_add((gpio_num_t)_pins.busy, onBusy, this);
+  gpio_isr_handler_add((gpio_num_t)_pins.dio1, onDio1, this);
+
+  if (xTaskCreatePinnedToCore(taskEntry, "sx1262", _cfg.taskStack, this,
+                              _cfg.taskPriority, &_task, _cfg.taskCore) != pdPASS) {
+    end();
+    return false;
+  }
+
+  // hardware reset, then BUSY drops once the chip is ready
+  pinMode(_pins.reset, OUTPUT);
+  digitalWrite(_pins.reset, LOW);
+  vTaskDelay(pdMS_TO_TICKS(2));
+  digitalWrite(_pins.reset, HIGH);
+  _mode = MODE_STANDBY;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  bool ok = configure();
+  xSemaphoreGive(_lock);
+  if (!ok) end();
+  return ok;
+}
+
+void Sx1262::end() {
+  // interrupts first, the DIO1 handler notifies the task
+  gpio_isr_handler_remove((gpio_num_t)_pins.busy);
+  gpio_isr_handler_remove((gpio_num_t)_pins.dio1);
+  if (_task) {
+    vTaskDelete(_task);
+    _task = nullptr;
+  }
+  if (_spi) {
+    spi_bus_remove_device(_spi);
+    spi_bus_free(_host);
+    _spi = nullptr;
+  }
+  if (_events) { vQueueDelete(_events); _events = nullptr; }
+  if (_busyFree) { vSemaphoreDelete(_busyFree); _busyFree = nullptr; }
+  if (_lock) { vSemaphoreDelete(_lock); _lock = nullptr; }
+  heap_caps_free(_tx);
+  heap_caps_free(_rx);
+  _tx = _rx = nullptr;
+  _mode = MODE_SLEEP;
+}
+
+void IRAM_ATTR Sx1262::onBusy(void* arg) {
+  Sx1262* self = static_cast<Sx1262*>(arg);
+  BaseType_t woken = pdFALSE;
+  gpio_intr_disable((gpio_num_t)self->_pins.busy);
+  xSemaphoreGiveFromISR(self->_busyFree, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void IRAM_ATTR Sx1262::onDio1(void* arg) {
+  Sx1262* self = static_cast<Sx1262*>(arg);
+  BaseType_t woken = pdFALSE;
+  self->_irqAtUs = esp_timer_get_time();
+  vTaskNotifyGiveFromISR(self->_task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void Sx1262::taskEntry(void* arg) {
+  static_cast<Sx1262*>(arg)->run();
+}
+
+void Sx1262::run() {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    handleIrq();
+    xSemaphoreGive(_lock);
+  }
+}
+
+bool Sx1262::waitReady(uint32_t timeoutMs) {
+  gpio_num_t busy = (gpio_num_t)_pins.busy;
+  if (!gpio_get_level(busy)) return true;
+
+  // arm the edge, then re-check: BUSY may have dropped in between
+  _counters.busyWaits++;
+  xSemaphoreTake(_busyFree, 0);
+  gpio_intr_enable(busy);
+  bool ready = !gpio_get_level(busy) ||
+               xSemaphoreTake(_busyFree, pdMS_TO_TICKS(timeoutMs)) == pdTRUE ||
+               !gpio_get_level(busy);
+  gpio_intr_disable(busy);
+  if (!ready) _counters.busyTimeouts++;
+  return ready;
+}
+
+bool Sx1262::transfer(size_t len) {
+  if (_mode == MODE_SLEEP) {
+    // any NSS falling edge wakes the chip; the wake-up frame itself is ignored
+    spi_transaction_t wake = {};
+    wake.length = 8;
+    wake.flags = SPI_TRANS_USE_TXDATA;
+    wake.tx_data[0] = SX_GET_STATUS;
+    spi_device_transmit(_spi, &wake);
+    _mode = MODE_STANDBY;
+  }
+  if (!waitReady()) return false;
+
+  spi_transaction_t t = {};
+  t.length = len * 8;
+  t.tx_buffer = _tx;
+  t.rx_buffer = _rx;
+  return spi_device_transmit(_spi, &t) == ESP_OK;
+}
+
+bool Sx1262::command(uint8_t op, const uint8_t* args, size_t n) {
+  _tx[0] = op;
+  if (n) memcpy(_tx + 1, args, n);
+  return transfer(n + 1);
+}
+
+// op, args, status byte, then outLen response bytes
+bool Sx1262::query(uint8_t op, const uint8_t* args, size_t n, uint8_t* out, size_t outLen) {
+  _tx[0] = op;
+  if (n) memcpy(_tx + 1, args, n);
+  memset(_tx + 1 + n, 0, 1 + outLen);
+  if (!transfer(n + 2 + outLen)) return false;
+  memcpy(out, _rx + n + 2, outLen);
+  return true;
+}
+
+bool Sx1262::writeRegister(uint16_t addr, const uint8_t* data, size_t n) {
+  _tx[0] = SX_WRITE_REGISTER;
+  _tx[1] = (uint8_t)(addr >> 8);
+  _tx[2] = (uint8_t)addr;
+  memcpy(_tx + 3, data, n);
+  return transfer(n + 3);
+}
+
+bool Sx1262::writeBuffer(const uint8_t* data, size_t n) {
+  _tx[0] = SX_WRITE_BUFFER;
+  _tx[1] = 0;   // offset
+  memcpy(_tx + 2, data, n);
+  return transfer(n + 2);
+}
+
+bool Sx1262::setPacketLength(uint8_t len) {
+  uint8_t p[6] = { (uint8_t)(_cfg.preamble >> 8), (uint8_t)_cfg.preamble,
+                   0x00,                // explicit header
+                   len,
+                   0x01,                // CRC on
+                   0x00 };              // standard IQ
+  return command(SX_SET_PACKET_PARAMS, p, sizeof(p));
+}
+
+bool Sx1262::setFrequency(uint32_t hz) {
+  uint32_t frf = (uint32_t)(((uint64_t)hz << 25) / 32000000ULL);
+  uint8_t a[4] = { (uint8_t)(frf >> 24), (uint8_t)(frf >> 16), (uint8_t)(frf >> 8), (uint8_t)frf };
+  return command(SX_SET_RF_FREQUENCY, a, 4);
+}
+
+bool Sx1262::setModulation() {
+  uint8_t bw = _cfg.bandwidthHz >= 500000 ? 0x06 : _cfg.bandwidthHz >= 250000 ? 0x05 : 0x04;
+  uint8_t a[4];
+  a[0] = _cfg.sf;
+  a[1] = bw;
+  a[2] = _cfg.codingRate;
+  a[3] = _cfg.sf >= 11 && bw == 0x04 ? 0x01 : 0x00;   // low data rate optimisation
+  return command(SX_SET_MODULATION, a, 4);
+}
+
+bool Sx1262::configure() {
+  uint8_t a[8];
+  bool ok = true;
+
+  a[0] = 0x00;   // STDBY_RC
+  ok = ok && command(SX_SET_STANDBY, a, 1);
+
+  if (_cfg.tcxoMillivolts) {
+    static const uint16_t kMv[] = { 1600, 1700, 1800, 2200, 2400, 2700, 3000, 3300 };
+    uint8_t code = 7;
+    for (uint8_t i = 0; i < 8; i++) {
+      if (kMv[i] >= _cfg.tcxoMillivolts) { code = i; break; }
+    }
+    a[0] = code;
+    a[1] = 0x00; a[2] = 0x01; a[3] = 0x40;   // 5 ms start-up (320 * 15.625 us)
+    ok = ok && command(SX_SET_DIO3_TCXO, a, 4);
+    a[0] = 0x7F;                             // recalibrate everything on the TCXO
+    ok = ok && command(SX_CALIBRATE, a, 1);
+  }
+
+  a[0] = 0x01;   // DC-DC
+  ok = ok && command(SX_SET_REGULATOR, a, 1);
+  if (_cfg.dio2RfSwitch) {
+    a[0] = 0x01;
+    ok = ok && command(SX_SET_DIO2_RF_SWITCH, a, 1);
+  }
+
+  a[0] = 0x01;   // LoRa
+  ok = ok && command(SX_SET_PACKET_TYPE, a, 1);
+
+  uint32_t f = _cfg.frequencyHz;
+  if (f >= 902000000) { a[0] = 0xE1; a[1] = 0xE9; }
+  else if (f >= 863000000) { a[0] = 0xD7; a[1] = 0xDB; }
+  else if (f >= 779000000) { a[0] = 0xC1; a[1] = 0xC5; }
+  else if (f >= 470000000) { a[0] = 0x75; a[1] = 0x81; }
+  else { a[0] = 0x6B; a[1] = 0x6F; }
+  ok = ok && command(SX_CALIBRATE_IMAGE, a, 2);
+
+  ok = ok && setFrequency(f);
+
+  // datasheet PA tables: +14 dBm optimum, else the +22 dBm setting
+  int8_t power = _cfg.powerDbm;
+  if (power <= 14) {
+    a[0] = 0x02; a[1] = 0x02;
+    power = (int8_t)(power + 8);   // 0x16 (22) gives +14 dBm with this table
+  } else {
+    a[0] = 0x04; a[1] = 0x07;
+    if (power > 22) power = 22;
+  }
+  a[2] = 0x00; a[3] = 0x01;        // SX1262, paLut
+  ok = ok && command(SX_SET_PA_CONFIG, a, 4);
+  a[0] = (uint8_t)power;
+  a[1] = 0x04;                     // 200 us ramp
+  ok = ok && command(SX_SET_TX_PARAMS, a, 2);
+
+  a[0] = 0; a[1] = 0;
+  ok = ok && command(SX_SET_BUFFER_BASE, a, 2);
+
+  ok = ok && setModulation();
+  ok = ok && setPacketLength(0xFF);
+
+  a[0] = (uint8_t)(_cfg.syncWord >> 8);
+  a[1] = (uint8_t)_cfg.syncWord;
+  ok = ok && writeRegister(SX_REG_SYNC_WORD, a, 2);
+
+  a[0] = SX_IRQ_USED >> 8; a[1] = SX_IRQ_USED & 0xFF;   // IRQ mask
+  a[2] = SX_IRQ_USED >> 8; a[3] = SX_IRQ_USED & 0xFF;   // routed to DIO1
+  a[4] = a[5] = a[6] = a[7] = 0;                         // DIO2 / DIO3 unused
+  ok = ok && command(SX_SET_DIO_IRQ, a, 8);
+
+  a[0] = 0xFF; a[1] = 0xFF;
+  ok = ok && command(SX_CLEAR_IRQ_STATUS, a, 2);
+  return ok;
+}
+
+bool Sx1262::send(const uint8_t* data, size_t len, uint32_t timeoutMs) {
+  if (!_spi || len == 0 || len > kMaxPayload) return false;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  bool ok = _mode != MODE_TX &&
+            setPacketLength((uint8_t)len) &&
+            writeBuffer(data, len);
+  if (ok) {
+    uint8_t t[3];
+    putTimeout(t, timeoutMs);
+    ok = command(SX_SET_TX, t, 3);
+    if (ok) _mode = MODE_TX;
+  }
+  xSemaphoreGive(_lock);
+  return ok;
+}
+
+bool Sx1262::receive(uint32_t timeoutMs) {
+  if (!_spi) return false;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  bool ok = _mode != MODE_TX && setPacketLength(0xFF);
+  if (ok) {
+    uint8_t t[3];
+    if (timeoutMs) putTimeout(t, timeoutMs);
+    else t[0] = t[1] = t[2] = 0xFF;   // continuous
+    ok = command(SX_SET_RX, t, 3);
+    if (ok) {
+      _mode = MODE_RX;
+      _rxContinuous = timeoutMs == 0;
+    }
+  }
+  xSemaphoreGive(_lock);
+  return ok;
+}
+
+size_t Sx1262::readPacket(uint8_t* out, size_t cap) {
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  size_t n = _rxLength < cap ? _rxLength : cap;
+  memcpy(out, _rxPacket, n);
+  xSemaphoreGive(_lock);
+  return n;
+}
+
+bool Sx1262::setChannel(uint32_t frequencyHz, uint8_t sf) {
+  if (!_spi || sf < 5 || sf > 12) return false;
+  if (frequencyHz == _cfg.frequencyHz && sf == _cfg.sf) return true;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  uint8_t a = 0x00;   // STDBY_RC, also wakes a sleeping radio
+  bool ok = _mode != MODE_TX && command(SX_SET_STANDBY, &a, 1);
+  if (ok) {
+    _mode = MODE_STANDBY;
+    _cfg.frequencyHz = frequencyHz;
+    _cfg.sf = sf;
+    ok = setFrequency(frequencyHz) && setModulation();
+  }
+  xSemaphoreGive(_lock);
+  return ok;
+}
+
+bool Sx1262::standby() {
+  if (!_spi) return false;
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  uint8_t a = 0x00;
+  bool ok = command(SX_SET_STANDBY, &a, 1);
+  if (ok) _mode = MODE_STANDBY;
+  xSemaphoreGive(_lock);
+  return ok;
+}
+
+bool Sx1262::sleep() {
+  if (!_spi) return false;
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  uint8_t a = 0x04;   // warm start
+  bool ok = command(SX_SET_SLEEP, &a, 1);
+  if (ok) _mode = MODE_SLEEP;   // BUSY stays high until the next NSS edge
+  xSemaphoreGive(_lock);
+  return ok;
+}
+
+// driver task, _lock held
+void Sx1262::handleIrq() {
+  uint8_t st[3];
+  if (!query(SX_GET_IRQ_STATUS, nullptr, 0, st, 2)) return;
+  uint16_t irq = (uint16_t)(st[0] << 8 | st[1]);
+  if (!irq) return;
+
+  uint8_t clr[2] = { st[0], st[1] };
+  command(SX_CLEAR_IRQ_STATUS, clr, 2);
+
+  Event ev = {};
+  ev.timestampUs = _irqAtUs;
+
+  if (irq & SX_IRQ_TX_DONE) {
+    ev.type = TX_DONE;
+    _mode = MODE_STANDBY;   // the chip falls back to STDBY_RC by itself
+    _counters.txDone++;
+  } else if (irq & SX_IRQ_RX_DONE) {
+    if (irq & (SX_IRQ_CRC_ERR | SX_IRQ_HEADER_ERR)) {
+      ev.type = RX_CRC_ERROR;
+      _counters.crcErrors++;
+    } else {
+      ev.type = RX_DONE;
+      _counters.rxDone++;
+      _rxLength = 0;
+      uint8_t buf[2];   // payload length, start offset
+      if (query(SX_GET_RX_BUFFER, nullptr, 0, buf, 2) &&
+          query(SX_READ_BUFFER, &buf[1], 1, _rxPacket, buf[0])) {
+        _rxLength = buf[0];
+      }
+      ev.length = _rxLength;
+      if (query(SX_GET_PACKET_STATUS, nullptr, 0, st, 3)) {
+        ev.rssi = (int16_t)(-(int16_t)st[0] / 2);
+        ev.snr = (int8_t)((int8_t)st[1] / 4);
+      }
+    }
+    if (!_rxContinuous) _mode = MODE_STANDBY;
+  } else if (irq & SX_IRQ_TIMEOUT) {
+    ev.type = TIMEOUT;
+    _mode = MODE_STANDBY;
+    _counters.timeouts++;
+  } else {
+    return;   // header error without RX done: the packet is still being received
+  }
+
+  xQueueSend(_events, &ev, 0);
+  if (_notify) xTaskNotifyGive(_notify);
+}
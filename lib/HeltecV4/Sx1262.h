@@ -0,0 +1,177 @@
+/**
+ * Interrupt-driven SX1262 LoRa driver for the ESP32-S3
+ *
+ * Nothing in this driver polls:
+ *
+ * - SPI runs through the ESP-IDF spi_master driver with DMA; transfers
+ *   block the calling task on a semaphore, not on a busy loop.
+ * - BUSY (GPIO 13) is an interrupt line. Before a command the driver checks
+ *   the level; if the radio is still busy it arms a falling-edge interrupt
+ *   and sleeps until BUSY drops (usually it already has).
+ * - DIO1 (GPIO 14, DIO0 in pins_arduino.h) carries TxDone / RxDone /
+ *   Timeout / CrcErr. Its ISR timestamps the edge and wakes a small driver
+ *   task, which reads and clears the IRQ status and posts an Event to a
+ *   FreeRTOS queue (and optionally notifies a consumer task).
+ *
+ * send() and receive() only write the buffer and start the radio, then
+ * return. A SF10/SF12 frame spends hundreds of ms to seconds on air while
+ * the caller keeps parsing GNSS and drawing the display; the TX_DONE event
+ * arrives on the queue afterwards.
+ *
+ * Defaults match the V4: pins from HeltecV4::Lora (HeltecV4Board.h),
+ * SX1262 with a 1.8 V TCXO on DIO3, RF switch on DIO2, DC-DC regulator,
+ * EU868 image calibration.
+ *
+ * Usage:
+ *   static Sx1262 radio;
+ *   radio.begin(Sx1262::Pins(), Sx1262::Config());
+ *   radio.send(frame, len);
+ *   Sx1262::Event ev;
+ *   if (xQueueReceive(radio.events(), &ev, 0) == pdTRUE) { ... }
+ */
+
+#ifndef SX1262_H
+#define SX1262_H
+
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <driver/spi_master.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "HeltecV4Board.h"
+
+class Sx1262 {
+public:
+  static const size_t kMaxPayload = 255;
+
+  struct Pins {
+    int sck = HeltecV4::Lora::sck;
+    int mosi = HeltecV4::Lora::mosi;
+    int miso = HeltecV4::Lora::miso;
+    int nss = HeltecV4::Lora::nss;
+    int reset = HeltecV4::Lora::rst;
+    int busy = HeltecV4::Lora::busy;
+    int dio1 = HeltecV4::Lora::dio1;
+
+    // another board's trait: radio.begin(Sx1262::Pins::of<MyBoard::Lora>(), cfg)
+    template <class L>
+    static Pins of() {
+      static_assert(boardPinsValid(L::sck, L::mosi, L::miso, L::nss, L::rst, L::busy, L::dio1),
+                    "LoRa pin set");
+      Pins p;
+      p.sck = L::sck;
+      p.mosi = L::mosi;
+      p.miso = L::miso;
+      p.nss = L::nss;
+      p.reset = L::rst;
+      p.busy = L::busy;
+      p.dio1 = L::dio1;
+      return p;
+    }
+  };
+
+  struct Config {
+    uint32_t frequencyHz = 868100000;
+    int8_t powerDbm = 14;           // -9 .. 22
+    uint8_t sf = 10;                // 5 .. 12
+    uint32_t bandwidthHz = 125000;  // 125000, 250000, 500000
+    uint8_t codingRate = 1;         // 1..4 = 4/5..4/8
+    uint16_t preamble = 8;
+    uint16_t syncWord = 0x1424;     // private network (0x3444 = LoRaWAN public)
+    uint16_t tcxoMillivolts = 1800; // 0 = crystal
+    bool dio2RfSwitch = true;
+    uint32_t spiHz = 8000000;
+    uint32_t taskStack = 3072;
+    UBaseType_t taskPriority = 6;   // above the GNSS ingest task
+    BaseType_t taskCore = 0;
+  };
+
+  enum EventType : uint8_t { TX_DONE, RX_DONE, RX_CRC_ERROR, TIMEOUT };
+
+  struct Event {
+    EventType type;
+    uint8_t length;       // RX_DONE: payload bytes, read with readPacket()
+    int16_t rssi;         // dBm
+    int8_t snr;           // dB
+    int64_t timestampUs;  // esp_timer time of the DIO1 edge
+  };
+
+  struct Counters {
+    uint32_t txDone;
+    uint32_t rxDone;
+    uint32_t crcErrors;
+    uint32_t timeouts;
+    uint32_t busyWaits;     // commands that found BUSY high and slept
+    uint32_t busyTimeouts;  // BUSY stuck high (radio not responding)
+  };
+
+  bool begin(const Pins& pins, const Config& cfg, spi_host_device_t host = SPI2_HOST);
+  void end();
+
+  // starts a transmission and returns; TX_DONE or TIMEOUT follows on events()
+  bool send(const uint8_t* data, size_t len, uint32_t timeoutMs = 0);
+  // single receive window (0 = continuous); RX_DONE / TIMEOUT follows
+  bool receive(uint32_t timeoutMs = 0);
+
+  // payload of the last RX_DONE event
+  size_t readPacket(uint8_t* out, size_t cap);
+
+  // retunes between frames (not while transmitting); the EU868 sub-bands
+  // share one image calibration, so this is two short commands
+  bool setChannel(uint32_t frequencyHz, uint8_t sf);
+
+  bool standby();
+  bool sleep();   // warm start, configuration retained
+
+  bool transmitting() const { return _mode == MODE_TX; }
+
+  QueueHandle_t events() const { return _events; }
+  // additionally xTaskNotifyGive()s this task for every event
+  void setNotify(TaskHandle_t task) { _notify = task; }
+
+  const Counters& counters() const { return _counters; }
+
+private:
+  enum Mode : uint8_t { MODE_SLEEP, MODE_STANDBY, MODE_TX, MODE_RX };
+
+  static void IRAM_ATTR onBusy(void* arg);
+  static void IRAM_ATTR onDio1(void* arg);
+  static void taskEntry(void* arg);
+  void run();
+
+  bool waitReady(uint32_t timeoutMs = 100);
+  bool transfer(size_t len);
+  bool command(uint8_t op, const uint8_t* args, size_t n);
+  bool query(uint8_t op, const uint8_t* args, size_t n, uint8_t* out, size_t outLen);
+  bool writeRegister(uint16_t addr, const uint8_t* data, size_t n);
+  bool writeBuffer(const uint8_t* data, size_t n);
+  bool setPacketLength(uint8_t len);
+  bool setFrequency(uint32_t hz);
+  bool setModulation();
+  bool configure();
+  void handleIrq();
+
+  Pins _pins;
+  Config _cfg;
+  spi_host_device_t _host = SPI2_HOST;
+  spi_device_handle_t _spi = nullptr;
+
+  SemaphoreHandle_t _lock = nullptr;      // one SPI transaction sequence at a time
+  SemaphoreHandle_t _busyFree = nullptr;  // given by the BUSY falling edge
+  QueueHandle_t _events = nullptr;
+  TaskHandle_t _task = nullptr;
+  TaskHandle_t _notify = nullptr;
+
+  volatile int64_t _irqAtUs = 0;
+  volatile Mode _mode = MODE_SLEEP;
+  bool _rxContinuous = false;
+
+  uint8_t* _tx = nullptr;   // DMA-capable transfer buffers
+  uint8_t* _rx = nullptr;
+  uint8_t _rxPacket[kMaxPayload];
+  uint8_t _rxLength = 0;
+
+  Counters _counters = {};
+};
+
+#endif // SX1262_H
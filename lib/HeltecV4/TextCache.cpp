@@ -0,0 +1,151 @@
+#include "TextCache.h"
+
+void TextCache::clear() {
+  _used = 0;
+  _labelCount = 0;
+  for (uint8_t i = 0; i < 96; i++) _hasGlyph[i] = false;
+  _stats = {};
+}
+
+bool TextCache::capture(SSD1306Wire& display, const char* text, Bitmap& out) {
+  const uint8_t* fb = display.buffer;
+  const int16_t width = 128;
+  display.clear();
+  display.setColor(WHITE);
+  display.setTextAlignment(TEXT_ALIGN_LEFT);
+  display.drawString(0, 0, text);
+
+  int16_t lo = width, hi = -1;
+  uint8_t pages = 0;
+  for (uint8_t p = 0; p < 8; p++) {
+    for (int16_t x = 0; x < width; x++) {
+      if (!fb[p * width + x]) continue;
+      if (p >= kMaxPages) return false;   // font too tall
+      if (x < lo) lo = x;
+      if (x > hi) hi = x;
+      pages = p + 1;
+    }
+  }
+
+  out.advance = (uint8_t)display.getStringWidth(text, strlen(text));
+  out.offset = (uint16_t)_used;
+  if (hi < 0) {                          // blank, e.g. ' '
+    out.width = out.pages = out.xOffset = 0;
+    return true;
+  }
+
+  out.width = (uint8_t)(hi - lo + 1);
+  out.pages = pages;
+  out.xOffset = (uint8_t)lo;
+  size_t bytes = (size_t)out.width * out.pages;
+  if (_used + bytes > kPoolBytes) return false;
+  for (uint8_t p = 0; p < pages; p++) memcpy(_pool + _used + p * out.width, fb + p * width + lo, out.width);
+  _used += bytes;
+  return true;
+}
+
+bool TextCache::build(SSD1306Wire& display, const char* glyphs, const char* const* labels,
+                      uint8_t labelCount) {
+  clear();
+  bool ok = true;
+  for (const char* g = glyphs; *g; g++) {
+    uint8_t c = (uint8_t)*g;
+    if (c < 32 || c >= 128) {
+      ok = false;
+      continue;
+    }
+    char s[2] = { (char)c, 0 };
+    if (capture(display, s, _glyphs[c - 32])) _hasGlyph[c - 32] = true;
+    else ok = false;
+  }
+  for (uint8_t i = 0; i < labelCount; i++) {
+    size_t len = strlen(labels[i]);
+    if (_labelCount >= kMaxLabels || !len || len > 255) {
+      ok = false;
+      continue;
+    }
+    Label& l = _labels[_labelCount];
+    l.text = labels[i];
+    l.length = (uint8_t)len;
+    if (capture(display, labels[i], l.bitmap)) _labelCount++;
+    else ok = false;
+  }
+  display.clear();
+  return ok;
+}
+
+const TextCache::Label* TextCache::matchLabel(const char* text) const {
+  const Label* best = nullptr;
+  for (uint8_t i = 0; i < _labelCount; i++) {
+    const Label& l = _labels[i];
+    if (l.text[0] != text[0] || (best && l.length <= best->length)) continue;
+    if (strncmp(l.text, text, l.length) == 0) best = &l;
+  }
+  return best;
+}
+
+bool TextCache::measure(const char* text, uint16_t& width) const {
+  uint16_t w = 0;
+  while (*text) {
+    const Label* l = matchLabel(text);
+    if (l) {
+      w += l->bitmap.advance;
+      text += l->length;
+      continue;
+    }
+    uint8_t c = (uint8_t)*text;
+    if (c < 32 || c >= 128 || !_hasGlyph[c - 32]) return false;
+    w += _glyphs[c - 32].advance;
+    text++;
+  }
+  width = w;
+  return true;
+}
+
+void TextCache::blit(uint8_t* fb, int16_t x, int16_t y, const Bitmap& b) const {
+  const int16_t width = 128;
+  int16_t x0 = x + b.xOffset;
+  int16_t c0 = x0 < 0 ? -x0 : 0;
+  int16_t c1 = x0 + b.width > width ? width - x0 : b.width;
+  if (c0 >= c1) return;
+
+  const uint8_t* src = _pool + b.offset;
+  int16_t page0 = y >> 3;
+  uint8_t shift = y & 7;
+  for (uint8_t p = 0; p < b.pages; p++) {
+    const uint8_t* row = src + p * b.width;
+    int16_t dst = page0 + p;
+    if (!shift) {
+      if (dst >= 8) break;
+      uint8_t* out = fb + dst * width + x0;
+      for (int16_t c = c0; c < c1; c++) out[c] |= row[c];
+      continue;
+    }
+    // the page straddles two framebuffer pages
+    uint8_t* lower = dst < 8 ? fb + dst * width + x0 : nullptr;
+    uint8_t* upper = dst + 1 < 8 ? fb + (dst + 1) * width + x0 : nullptr;
+    if (!lower) break;
+    for (int16_t c = c0; c < c1; c++) {
+      lower[c] |= (uint8_t)(row[c] << shift);
+      if (upper) upper[c] |= (uint8_t)(row[c] >> (8 - shift));
+    }
+  }
+}
+
+bool TextCache::draw(uint8_t* fb, int16_t x, int16_t y, const char* text, bool alignRight) {
+  uint16_t w;
+  if (y < 0 || !measure(text, w)) {
+    _stats.misses++;
+    return false;
+  }
+  int16_t pen = alignRight ? (int16_t)(x - w) : x;
+  while (*text) {
+    const Label* l = matchLabel(text);
+    const Bitmap& b = l ? l->bitmap : _glyphs[(uint8_t)*text - 32];
+    if (b.width) blit(fb, pen, y, b);
+    pen += b.advance;
+    text += l ? l->length : 1;
+  }
+  _stats.hits++;
+  return true;
+}
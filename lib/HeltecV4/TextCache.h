@@ -0,0 +1,93 @@
+/**
+ * Pre-rasterised text for the SSD1306 framebuffer
+ *
+ * drawString() decodes the font bitmap of every character and sets the
+ * pixels one by one. TextCache renders the static labels ("LAT: ",
+ * "Searching GPS ...", "ANT OK", ...) and a small glyph set (digits and
+ * the punctuation of the formatters) once at startup, through the same
+ * SSD1306Wire font code, and keeps the results as column bytes in SSD1306
+ * page layout: bit n of a byte is pixel row n of that page, one byte per
+ * column, one row of bytes per page.
+ *
+ * draw() then composes a string from its longest matching label prefix and
+ * atlas glyphs, OR-ing whole column bytes into the framebuffer: one byte
+ * per column and page when y is page aligned, two (shifted) otherwise. On
+ * a cleared field box that is exactly what drawString() paints, and it is
+ * what a changed coordinate costs instead of per-pixel font decoding.
+ * Text with a character outside the cache is left to drawString().
+ *
+ * build() uses the display's current font and draws into its framebuffer
+ * while it runs (the buffer is cleared afterwards). Fonts up to 24 px.
+ *
+ * Usage:
+ *   static const char* const kLabels[] = { "LAT: ", "LON: ", "ANT OK" };
+ *   static TextCache textCache;
+ *   display.setFont(ArialMT_Plain_10);
+ *   textCache.build(display, "0123456789:.-", kLabels, 3);
+ *   screen.setTextCache(&textCache);
+ */
+
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <Arduino.h>
+#include "HT_SSD1306Wire.h"
+
+class TextCache {
+public:
+  static const uint8_t kMaxLabels = 8;
+  static const uint8_t kMaxPages = 3;      // 24 px fonts
+  static const size_t kPoolBytes = 2048;   // all bitmaps, page-major
+
+  struct Stats {
+    uint32_t hits;     // strings drawn from the cache
+    uint32_t misses;   // strings left to drawString()
+  };
+
+  // rasterises each character of `glyphs` (printable ASCII) and every label
+  // (kept by pointer, use literals); false if the pool or the label table ran
+  // out, what fit is still used
+  bool build(SSD1306Wire& display, const char* glyphs, const char* const* labels, uint8_t labelCount);
+  void clear();
+
+  // draws text with its left edge (or right edge) at x and its top at y;
+  // false, with nothing drawn, if the text is not fully cached
+  bool draw(uint8_t* fb, int16_t x, int16_t y, const char* text, bool alignRight = false);
+
+  // width drawString() would use; false if the text is not fully cached
+  bool measure(const char* text, uint16_t& width) const;
+
+  size_t poolUsed() const { return _used; }
+  const Stats& stats() const { return _stats; }
+
+private:
+  struct Bitmap {
+    uint16_t offset;   // into _pool
+    uint8_t width;     // columns with pixels
+    uint8_t pages;
+    uint8_t xOffset;   // first lit column relative to the pen position
+    uint8_t advance;   // pen movement, as getStringWidth()
+  };
+
+  struct Label {
+    const char* text;
+    uint8_t length;
+    Bitmap bitmap;
+  };
+
+  bool capture(SSD1306Wire& display, const char* text, Bitmap& out);
+  const Label* matchLabel(const char* text) const;
+  void blit(uint8_t* fb, int16_t x, int16_t y, const Bitmap& b) const;
+
+  uint8_t _pool[kPoolBytes];
+  size_t _used = 0;
+
+  Bitmap _glyphs[96];               // printable ASCII 32..127
+  bool _hasGlyph[96] = {};
+  Label _labels[kMaxLabels];
+  uint8_t _labelCount = 0;
+
+  Stats _stats = {};
+};
+
+#endif // TEXT_CACHE_H
@@ -0,0 +1,135 @@
+#include "UbxConfig.h"
+#include "Ubx.h"
+#include "NmeaFramer.h"
+
+static const uint32_t kAckTimeoutMs = 1500;       // queued behind a 9600-baud NMEA burst
+static const uint32_t kTrafficTimeoutMs = 2500;   // a 1 Hz epoch at the new baud, with margin
+static const uint32_t kBaudSettleMs = 50;         // old-rate bytes still in the driver
+
+// what the receiver sends while a configuration step waits
+struct UbxReply {
+  uint8_t cls, id;   // ACK wanted for this message; cls 0 = any valid traffic
+  int8_t ack;        // 1 ACK-ACK, 0 ACK-NAK, -1 nothing yet
+  bool traffic;      // a checksum-valid sentence or frame
+  UbxParser parser;
+
+  UbxReply(uint8_t c, uint8_t i) : cls(c), id(i), ack(-1), traffic(false) {}
+};
+
+static void onReplyFrame(const UbxFrame& f, void* ctx) {
+  UbxReply& r = *static_cast<UbxReply*>(ctx);
+  r.traffic = true;
+  if (f.cls != UBX_ACK || f.length < 2 || f.payload[0] != r.cls || f.payload[1] != r.id) return;
+  r.ack = f.id == UBX_ACK_ACK ? 1 : 0;
+}
+
+static void onReplySentence(const NmeaSentence&, void* ctx) {
+  static_cast<UbxReply*>(ctx)->traffic = true;
+}
+
+static void onReplyBinary(const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, void* ctx) {
+  UbxReply& r = *static_cast<UbxReply*>(ctx);
+  r.parser.feed(p1, n1);
+  r.parser.feed(p2, n2);
+}
+
+// reads the ring until the reply is complete or timeoutMs passed; true for
+// an ACK-ACK (cls != 0) or any valid traffic (cls == 0)
+static bool ubxAwait(GnssUart& uart, UbxReply& r, uint32_t timeoutMs) {
+  ByteRing* ring = uart.ring();
+  if (!ring) return false;
+  NmeaFramer framer;
+  framer.setFrameSink(onReplySentence, &r);
+  framer.setBinarySink(onReplyBinary, &r);
+  r.parser.setHandler(onReplyFrame, &r);
+
+  uint32_t start = millis();
+  for (;;) {
+    framer.poll(*ring);
+    if (r.cls ? r.ack >= 0 : r.traffic) return r.cls ? r.ack == 1 : true;
+    uint32_t elapsed = millis() - start;
+    if (elapsed >= timeoutMs) return false;
+    uart.waitForData(timeoutMs - elapsed);
+  }
+}
+
+// one CFG frame, true once the receiver acknowledged it
+static bool ubxSendAcked(GnssUart& uart, const uint8_t* frame, size_t n) {
+  if (uart.write(frame, n) != n) return false;
+  UbxReply r(frame[2], frame[3]);
+  return ubxAwait(uart, r, kAckTimeoutMs);
+}
+
+bool ubxSwitchToNavPvt(GnssUart& uart, uint32_t baud) {
+  uint8_t buf[32];
+  size_t n;
+
+  // default NMEA set off: GGA, GLL, GSA, GSV, RMC, VTG
+  for (uint8_t id = 0x00; id <= 0x05; id++) {
+    n = ubxCfgMsg(buf, UBX_NMEA, id, 0);
+    if (!ubxSendAcked(uart, buf, n)) return false;
+  }
+
+  n = ubxCfgMsg(buf, UBX_NAV, UBX_NAV_PVT, 1);
+  if (!ubxSendAcked(uart, buf, n)) return false;
+  n = ubxCfgMsg(buf, UBX_MON, UBX_MON_HW, 5);
+  if (!ubxSendAcked(uart, buf, n)) return false;
+
+  return ubxSetPort(uart, baud, UBX_PROTO_UBX);
+}
+
+bool ubxSetPort(GnssUart& uart, uint32_t baud, uint16_t outProto) {
+  uint8_t buf[32];
+  uint32_t oldBaud = uart.baud();
+
+  // the receiver acknowledges at the old rate while switching, so the ACK
+  // is unreliable: valid traffic at the new rate is the proof
+  size_t n = ubxCfgPrt(buf, baud, UBX_PROTO_UBX | UBX_PROTO_NMEA, outProto);
+  if (uart.write(buf, n) != n) return false;
+  if (!uart.setBaud(baud)) return false;   // waits until the frame is on the wire
+
+  // whatever arrived before the switch must not count
+  delay(kBaudSettleMs);
+  ByteRing* ring = uart.ring();
+  if (ring) ring->consume(ring->available());
+
+  UbxReply r(0, 0);
+  if (ubxAwait(uart, r, kTrafficTimeoutMs)) return true;
+  uart.setBaud(oldBaud);   // not switched (or no such receiver): keep listening where it talks
+  return false;
+}
+
+bool ubxSetNavRate(GnssUart& uart, uint16_t measRateMs) {
+  uint8_t buf[16];
+  size_t n = ubxCfgRate(buf, measRateMs);
+  return ubxSendAcked(uart, buf, n);
+}
+
+bool ubxSaveToBbr(GnssUart& uart) {
+  uint8_t buf[32];
+  size_t n = ubxCfgSaveBbr(buf);
+  return ubxSendAcked(uart, buf, n);
+}
+
+bool ubxEnterBackup(GnssUart& uart) {
+  uint8_t buf[32];
+  size_t n = ubxRxmPmreqBackup(buf, 0);
+  if (uart.write(buf, n) != n) return false;
+  return uart.flush();   // the frame must be out before the ESP32 sleeps
+}
+
+bool ubxWake(GnssUart& uart) {
+  static const uint8_t kWake[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+  return uart.write(kWake, sizeof(kWake)) == sizeof(kWake);
+}
+
+uint32_t gnssBaudForRate(uint16_t hz, uint16_t bytesPerEpoch) {
+  static const uint32_t kBauds[] = { 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600 };
+
+  // 10 bits per byte on the wire (8N1), line at most 50 % busy
+  uint32_t needed = (uint32_t)hz * bytesPerEpoch * 10 * 2;
+  for (uint32_t b : kBauds) {
+    if (b >= needed) return b;
+  }
+  return kBauds[sizeof(kBauds) / sizeof(kBauds[0]) - 1];
+}
@@ -0,0 +1,64 @@
+/**
+ * u-blox receiver configuration over the GNSS UART
+ *
+ * ubxSwitchToNavPvt() turns a receiver that is streaming its default NMEA
+ * set at 9600 baud into a binary NAV-PVT-only source:
+ *
+ *   1. CFG-MSG: GGA, GLL, GSA, GSV, RMC and VTG off
+ *   2. CFG-MSG: NAV-PVT every epoch, MON-HW (antenna status) every 5th epoch
+ *   3. CFG-PRT: UART1 at `baud`, input UBX+NMEA, output UBX only
+ *   4. the local UART follows to the new baud rate
+ *
+ * Replies: every CFG-MSG, CFG-RATE and CFG-CFG waits up to 1.5 s for its
+ * UBX-ACK-ACK; a NAK or silence (not a u-blox receiver) fails the call.
+ * CFG-PRT is acknowledged at the old rate during the switch, so ubxSetPort()
+ * instead waits for a valid sentence or frame at the new rate and returns
+ * the local UART to the old one if none comes. While waiting the functions
+ * read the GnssUart ring themselves: call them from the ring's consumer
+ * task, and expect the bytes of those seconds not to reach its framer.
+ *
+ * A NAV-PVT frame is 100 bytes per epoch against roughly 500 bytes of
+ * default NMEA sentences. The settings are not saved to the receiver's
+ * flash (ubxSaveToBbr() only keeps them across backup mode), so a power
+ * cycle restores the defaults.
+ *
+ * Navigation rate: ubxSetNavRate() changes the measurement period
+ * (CFG-RATE). Raise the baud rate first; gnssBaudForRate() gives the lowest
+ * standard rate that keeps the line at most half busy, e.g. 10 Hz NMEA
+ * needs 115200, 10 Hz NAV-PVT 38400. M8 receivers reach 10 Hz with one or
+ * two constellations only, 18 Hz with GPS alone.
+ */
+
+#ifndef UBX_CONFIG_H
+#define UBX_CONFIG_H
+
+#include <Arduino.h>
+#include "GnssUart.h"
+
+// true only if every step was acknowledged and NAV-PVT arrives at `baud`
+bool ubxSwitchToNavPvt(GnssUart& uart, uint32_t baud);
+
+// CFG-PRT: UART1 at `baud` with the given output protocols, local UART
+// follows; back at the old baud (false) without traffic at the new one
+bool ubxSetPort(GnssUart& uart, uint32_t baud, uint16_t outProto);
+
+// CFG-RATE: one navigation solution every `measRateMs` (100 = 10 Hz)
+bool ubxSetNavRate(GnssUart& uart, uint16_t measRateMs);
+
+// CFG-CFG: the running configuration (port, messages, rate) into the
+// receiver's battery-backed RAM. A receiver woken from backup restarts with
+// what BBR or flash holds, so send this first if the defaults were changed;
+// like backup RAM it is lost when VGNSS_CTRL goes off
+bool ubxSaveToBbr(GnssUart& uart);
+
+// RXM-PMREQ backup mode: ~30 uA instead of ~25 mA, keeps ephemeris and RTC
+// as long as VGNSS_CTRL stays on; any byte on the receiver's RX wakes it.
+// There is no ACK: true only means the frame left the UART
+bool ubxEnterBackup(GnssUart& uart);
+// wakes a receiver in backup mode (a few 0xFF bytes on its RX line)
+bool ubxWake(GnssUart& uart);
+
+// lowest standard baud that carries `bytesPerEpoch` at `hz` with 50 % headroom
+uint32_t gnssBaudForRate(uint16_t hz, uint16_t bytesPerEpoch);
+
+#endif // UBX_CONFIG_H